@@ -0,0 +1,5 @@
+--
+DELETE FROM `command` WHERE `name` IN ('debug opcodetimes','debug opcodetimes reset');
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug opcodetimes','Syntax: .debug opcodetimes [#count]\r\n\r\nList the #count (default 10) client opcodes with the highest total processing time since startup or the last reset, with their packet count, average, median, 99th percentile and maximum processing time.'),
+('debug opcodetimes reset','Syntax: .debug opcodetimes reset\r\n\r\nReset the processing times collected for client opcodes.');
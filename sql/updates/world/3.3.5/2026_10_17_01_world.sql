@@ -0,0 +1,4 @@
+--
+DELETE FROM `command` WHERE `name`='debug objectpools';
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug objectpools','Syntax: .debug objectpools\r\n\r\nList the slab pools backing spells, spell events, auras and aura applications with their object size, live, allocated and freed object counts, oversized requests and reserved memory.');
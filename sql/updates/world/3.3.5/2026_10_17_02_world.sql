@@ -0,0 +1,5 @@
+--
+DELETE FROM `command` WHERE `name` IN ('debug smartevents','debug smartevents reset');
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug smartevents','Syntax: .debug smartevents [#count]\r\n\r\nList the #count (default 10) SmartAI event types with the highest total processing time since startup or the last reset, with the number of dispatches, handlers run, average and maximum processing time.'),
+('debug smartevents reset','Syntax: .debug smartevents reset\r\n\r\nReset the collected SmartAI event statistics.');
@@ -0,0 +1,5 @@
+--
+DELETE FROM `command` WHERE `name` IN ('debug smartevents','debug smartevents record');
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug smartevents','Syntax: .debug smartevents [#count]\r\n\r\nList the #count (default 10) SmartAI event types with the highest total processing time since recording was enabled or the last reset, with the number of dispatches, handlers run, average and maximum processing time.'),
+('debug smartevents record','Syntax: .debug smartevents record on/off\r\n\r\nStart or stop recording SmartAI event statistics. Recording is off at startup.');
@@ -113,6 +113,8 @@ class TC_COMMON_API BIH
             delete[] dat.indices;
         }
         uint32 primCount() const { return uint32(objects.size()); }
+        // primitive indices in leaf order, a leaf references a contiguous range of it
+        std::vector<uint32> const& primIndices() const { return objects; }
         G3D::AABox const& bound() const { return bounds; }
 
         template<typename RayCallback>
@@ -214,6 +216,16 @@ class TC_COMMON_API BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
+                            // callbacks that keep their primitives in leaf order test the whole leaf at once
+                            if constexpr (requires { intersectCallback.intersectLeaf(r, uint32(offset), uint32(n), maxDist, stopAtFirst); })
+                            {
+                                if (n > 0)
+                                {
+                                    bool hit = intersectCallback.intersectLeaf(r, uint32(offset), uint32(n), maxDist, stopAtFirst);
+                                    if (stopAtFirst && hit) return;
+                                }
+                                break;
+                            }
                             while (n > 0) {
                                 bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
                                 if (stopAtFirst && hit) return;
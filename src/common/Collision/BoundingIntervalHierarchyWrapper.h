@@ -19,21 +19,31 @@
 #define _BIH_WRAP
 
 #include "BoundingIntervalHierarchy.h"
-#include <G3D/Table.h>
-#include <G3D/Array.h>
-#include <G3D/Set.h>
-
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/// BIH over a changing set of objects.
+/// Objects inserted since the last build are kept in a short pending list that is tested linearly,
+/// removed ones only leave an empty slot behind, so the tree is rebuilt once enough changes piled up
+/// instead of after every single one. Queries never modify the wrapper.
 template<class T, class BoundsFunc = BoundsTrait<T> >
 class BIHWrap
 {
+    enum
+    {
+        MAX_PENDING_OBJECTS = 8     // above this many unbuilt objects a rebuild is cheaper than the linear tests
+    };
+
     template<class RayCallback>
     struct MDLCallback
     {
         const T* const* objects;
         RayCallback& _callback;
         uint32 objects_size;
+        bool hit;
 
-        MDLCallback(RayCallback& callback, const T* const* objects_array, uint32 objects_size ) : objects(objects_array), _callback(callback), objects_size(objects_size) { }
+        MDLCallback(RayCallback& callback, const T* const* objects_array, uint32 objects_size ) : objects(objects_array), _callback(callback), objects_size(objects_size), hit(false) { }
 
         /// Intersect ray
         bool operator() (const G3D::Ray& ray, uint32 idx, float& maxDist, bool /*stopAtFirst*/)
@@ -41,7 +51,8 @@ class BIHWrap
             if (idx >= objects_size)
                 return false;
             if (const T* obj = objects[idx])
-                return _callback(ray, *obj, maxDist/*, stopAtFirst*/);
+                if (_callback(ray, *obj, maxDist/*, stopAtFirst*/))
+                    return hit = true;
             return false;
         }
 
@@ -55,62 +66,90 @@ class BIHWrap
         }
     };
 
-    typedef G3D::Array<const T*> ObjArray;
+    typedef std::vector<const T*> ObjArray;
 
     BIH m_tree;
     ObjArray m_objects;
-    G3D::Table<const T*, uint32> m_obj2Idx;
-    G3D::Set<const T*> m_objects_to_push;
-    int unbalanced_times;
+    std::unordered_map<const T*, uint32> m_obj2Idx;
+    std::vector<const T*> m_pending;
+    uint32 m_freeSlots;
 
 public:
-    BIHWrap() : unbalanced_times(0) { }
+    BIHWrap() : m_freeSlots(0) { }
 
     void insert(const T& obj)
     {
-        ++unbalanced_times;
-        m_objects_to_push.insert(&obj);
+        m_pending.push_back(&obj);
     }
 
     void remove(const T& obj)
     {
-        ++unbalanced_times;
-        uint32 Idx = 0;
-        const T * temp;
-        if (m_obj2Idx.getRemove(&obj, temp, Idx))
-            m_objects[Idx] = nullptr;
+        auto itr = m_obj2Idx.find(&obj);
+        if (itr != m_obj2Idx.end())
+        {
+            m_objects[itr->second] = nullptr;
+            m_obj2Idx.erase(itr);
+            ++m_freeSlots;
+        }
         else
-            m_objects_to_push.remove(&obj);
+        {
+            auto pending = std::find(m_pending.begin(), m_pending.end(), &obj);
+            if (pending != m_pending.end())
+            {
+                *pending = m_pending.back();
+                m_pending.pop_back();
+            }
+        }
     }
 
-    void balance()
+    /// Rebuilds the tree, unless force is false and the pending and removed objects are still cheap to live with
+    void balance(bool force = false)
     {
-        if (unbalanced_times == 0)
+        if (m_pending.empty() && !m_freeSlots)
+            return;
+
+        if (!force && m_pending.size() <= MAX_PENDING_OBJECTS && m_freeSlots <= m_obj2Idx.size())
             return;
 
-        unbalanced_times = 0;
-        m_objects.fastClear();
-        m_obj2Idx.getKeys(m_objects);
-        m_objects_to_push.getMembers(m_objects);
-        //assert that m_obj2Idx has all the keys
+        ObjArray objects;
+        objects.reserve(m_obj2Idx.size() + m_pending.size());
+        for (const T* obj : m_objects)
+            if (obj)
+                objects.push_back(obj);
+        for (const T* obj : m_pending)
+            objects.push_back(obj);
+
+        m_objects.swap(objects);
+        m_pending.clear();
+        m_freeSlots = 0;
+        m_obj2Idx.clear();
+        for (uint32 i = 0; i < m_objects.size(); ++i)
+            m_obj2Idx[m_objects[i]] = i;
 
         m_tree.build(m_objects, BoundsFunc::getBounds2);
     }
 
     template<typename RayCallback>
-    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& maxDist)
+    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& maxDist) const
     {
-        balance();
-        MDLCallback<RayCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
+        MDLCallback<RayCallback> temp_cb(intersectCallback, m_objects.data(), uint32(m_objects.size()));
         m_tree.intersectRay(ray, temp_cb, maxDist, true);
+        if (temp_cb.hit)
+            return;
+
+        for (const T* obj : m_pending)
+            if (intersectCallback(ray, *obj, maxDist))
+                return;
     }
 
     template<typename IsectCallback>
-    void intersectPoint(const G3D::Vector3& point, IsectCallback& intersectCallback)
+    void intersectPoint(const G3D::Vector3& point, IsectCallback& intersectCallback) const
     {
-        balance();
-        MDLCallback<IsectCallback> callback(intersectCallback, m_objects.getCArray(), m_objects.size());
+        MDLCallback<IsectCallback> callback(intersectCallback, m_objects.data(), uint32(m_objects.size()));
         m_tree.intersectPoint(point, callback);
+
+        for (const T* obj : m_pending)
+            intersectCallback(point, *obj);
     }
 };
 
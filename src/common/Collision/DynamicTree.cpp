@@ -81,9 +81,9 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
         ++unbalanced_times;
     }
 
-    void balance()
+    void balance(bool force)
     {
-        base::balance();
+        base::balance(force);
         unbalanced_times = 0;
     }
 
@@ -97,7 +97,7 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
         {
             rebalance_timer.Reset(CHECK_TREE_PERIOD);
             if (unbalanced_times > 0)
-                balance();
+                balance(false);
         }
     }
 
@@ -114,26 +114,43 @@ DynamicMapTree::~DynamicMapTree()
 
 void DynamicMapTree::insert(GameObjectModel const& mdl)
 {
+    std::unique_lock<std::shared_mutex> lock(_lock);
     impl->insert(mdl);
 }
 
 void DynamicMapTree::remove(GameObjectModel const& mdl)
 {
+    std::unique_lock<std::shared_mutex> lock(_lock);
     impl->remove(mdl);
 }
 
+void DynamicMapTree::relocate(GameObjectModel& mdl)
+{
+    // the model must not move while a query may be testing it
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    if (!impl->contains(mdl))
+        return;
+
+    impl->remove(mdl);
+    mdl.UpdatePosition();
+    impl->insert(mdl);
+}
+
 bool DynamicMapTree::contains(GameObjectModel const& mdl) const
 {
+    std::shared_lock<std::shared_mutex> lock(_lock);
     return impl->contains(mdl);
 }
 
 void DynamicMapTree::balance()
 {
-    impl->balance();
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    impl->balance(true);
 }
 
 void DynamicMapTree::update(uint32 t_diff)
 {
+    std::unique_lock<std::shared_mutex> lock(_lock);
     impl->update(t_diff);
 }
 
@@ -174,6 +191,7 @@ bool DynamicMapTree::getIntersectionTime(const uint32 phasemask, const G3D::Ray&
 {
     float distance = maxDist;
     DynamicTreeIntersectionCallback callback(phasemask);
+    std::shared_lock<std::shared_mutex> lock(_lock);
     impl->intersectRay(ray, callback, distance, endPos);
     if (callback.didHit())
         maxDist = distance;
@@ -231,6 +249,7 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
 
     G3D::Ray r(v1, (v2-v1) / maxDist);
     DynamicTreeIntersectionCallback callback(phasemask);
+    std::shared_lock<std::shared_mutex> lock(_lock);
     impl->intersectRay(r, callback, maxDist, v2);
 
     return !callback.did_hit;
@@ -241,7 +260,10 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
     G3D::Vector3 v(x, y, z);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
     DynamicTreeIntersectionCallback callback(phasemask);
-    impl->intersectZAllignedRay(r, callback, maxSearchDist);
+    {
+        std::shared_lock<std::shared_mutex> lock(_lock);
+        impl->intersectZAllignedRay(r, callback, maxSearchDist);
+    }
 
     if (callback.didHit())
         return v.z - maxSearchDist;
@@ -253,6 +275,7 @@ bool DynamicMapTree::getAreaAndLiquidData(float x, float y, float z, uint32 phas
 {
     G3D::Vector3 v(x, y, z + 0.5f);
     DynamicTreeLocationInfoCallback intersectionCallBack(phasemask);
+    std::shared_lock<std::shared_mutex> lock(_lock);
     impl->intersectPoint(v, intersectionCallBack);
     if (intersectionCallBack.GetLocationInfo().hitModel)
     {
@@ -20,6 +20,7 @@
 
 #include "Define.h"
 #include "Optional.h"
+#include <shared_mutex>
 
 namespace G3D
 {
@@ -35,9 +36,11 @@ namespace VMAP
     struct AreaAndLiquidData;
 }
 
+/// Queries may run concurrently from several threads, modifications are serialized against them
 class TC_COMMON_API DynamicMapTree
 {
     DynTreeImpl *impl;
+    mutable std::shared_mutex _lock;
 
 public:
 
@@ -59,6 +62,7 @@ public:
 
     void insert(GameObjectModel const&);
     void remove(GameObjectModel const&);
+    void relocate(GameObjectModel&);
     bool contains(GameObjectModel const&) const;
 
     void balance();
@@ -74,6 +74,44 @@ namespace VMAP
         Optional<AreaInfo> areaInfo;
         Optional<LiquidInfo> liquidInfo;
     };
+
+    // one ray of a batched line of sight check, in world coordinates
+    struct LineOfSightQuery
+    {
+        float x1 = 0.0f;
+        float y1 = 0.0f;
+        float z1 = 0.0f;
+        float x2 = 0.0f;
+        float y2 = 0.0f;
+        float z2 = 0.0f;
+        bool inLineOfSight = true;
+    };
+
+    // one point of a batched height lookup, in world coordinates
+    struct HeightQuery
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float maxSearchDist = 0.0f;
+        float height = VMAP_INVALID_HEIGHT_VALUE;
+    };
+
+    // one ray of a batched hit position lookup, in world coordinates
+    struct ObjectHitPosQuery
+    {
+        float x1 = 0.0f;
+        float y1 = 0.0f;
+        float z1 = 0.0f;
+        float x2 = 0.0f;
+        float y2 = 0.0f;
+        float z2 = 0.0f;
+        float modifyDist = 0.0f;
+        float rx = 0.0f;
+        float ry = 0.0f;
+        float rz = 0.0f;
+        bool hit = false;
+    };
     //===========================================================
     class TC_COMMON_API IVMapManager
     {
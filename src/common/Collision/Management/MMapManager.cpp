@@ -19,12 +19,114 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <chrono>
+#include <utility>
 
 namespace MMAP
 {
     constexpr char MAP_FILE_NAME_FORMAT[] = "{}mmaps/{:03}.mmap";
     constexpr char TILE_FILE_NAME_FORMAT[] = "{}mmaps/{:03}{:02}{:02}.mmtile";
 
+    // tiles used by a path query within this time are never evicted
+    constexpr int64 TILE_MIN_IDLE_TIME = 60 * 1000;
+
+    static int64 GetTileClock()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // ######################## MMapTile ########################
+    MMapTile::MMapTile() : tileRef(0), gridRefCount(0), dataSize(0), lastUsed(0)
+    {
+    }
+
+    MMapTile::~MMapTile() = default;
+
+    // ######################## MMapData ########################
+    MMapData::~MMapData()
+    {
+        for (dtNavMeshQuery* query : queryPool)
+            dtFreeNavMeshQuery(query);
+
+        // tiles backed by a file mapping are not owned by detour, their regions are released with loadedTileRefs
+        if (navMesh)
+            dtFreeNavMesh(navMesh);
+    }
+
+    dtNavMeshQuery* MMapData::AcquireQuery()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queryPoolLock);
+            if (!queryPool.empty())
+            {
+                dtNavMeshQuery* query = queryPool.back();
+                queryPool.pop_back();
+                return query;
+            }
+        }
+
+        // pool grows up to the number of threads querying this nav mesh at the same time
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (dtStatusFailed(query->init(navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            TC_LOG_ERROR("maps", "MMAP:AcquireQuery: Failed to initialize dtNavMeshQuery");
+            return nullptr;
+        }
+
+        return query;
+    }
+
+    void MMapData::ReleaseQuery(dtNavMeshQuery* query)
+    {
+        std::lock_guard<std::mutex> lock(queryPoolLock);
+        queryPool.push_back(query);
+    }
+
+    // ######################## NavMeshQueryLease ########################
+    NavMeshQueryLease::NavMeshQueryLease(MMapData* data, std::shared_lock<std::shared_mutex>&& tileLock)
+        : _data(data), _query(data->AcquireQuery()), _tileLock(std::move(tileLock))
+    {
+        if (!_query)
+        {
+            _data = nullptr;
+            _tileLock.unlock();
+        }
+    }
+
+    NavMeshQueryLease::NavMeshQueryLease(NavMeshQueryLease&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _query(std::exchange(other._query, nullptr)), _tileLock(std::move(other._tileLock))
+    {
+    }
+
+    NavMeshQueryLease& NavMeshQueryLease::operator=(NavMeshQueryLease&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            _data = std::exchange(other._data, nullptr);
+            _query = std::exchange(other._query, nullptr);
+            _tileLock = std::move(other._tileLock);
+        }
+        return *this;
+    }
+
+    void NavMeshQueryLease::Release()
+    {
+        if (!_query)
+            return;
+
+        // query goes back first, the map data may be freed as soon as the tile lock is released
+        _data->ReleaseQuery(_query);
+        _query = nullptr;
+        _data = nullptr;
+        _tileLock.unlock();
+    }
+
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
     {
@@ -44,18 +146,28 @@ namespace MMAP
         thread_safe_environment = false;
     }
 
-    MMapDataSet::const_iterator MMapManager::GetMMapData(uint32 mapId) const
+    MMapData* MMapManager::GetMMapData(uint32 mapId) const
     {
-        // return the iterator if found or end() if not found/NULL
+        // return the data if found or nullptr if not found/NULL
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
         MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
-        if (itr != loadedMMaps.cend() && !itr->second)
-            itr = loadedMMaps.cend();
+        if (itr == loadedMMaps.cend())
+            return nullptr;
 
-        return itr;
+        return itr->second;
+    }
+
+    uint32 MMapManager::getLoadedMapsCount() const
+    {
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
+        return uint32(loadedMMaps.size());
     }
 
     bool MMapManager::loadMapData(std::string const& basePath, uint32 mapId)
     {
+        // maps of different threads may ask for the same nav mesh at once
+        std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
+
         // we already have this map loaded?
         MMapDataSet::iterator itr = loadedMMaps.find(mapId);
         if (itr != loadedMMaps.end())
@@ -101,7 +213,7 @@ namespace MMAP
         TC_LOG_DEBUG("maps", "MMAP:loadMapData: Loaded {:03}.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, basePath);
 
         itr->second = mmap_data;
         return true;
@@ -119,16 +231,34 @@ namespace MMAP
             return false;
 
         // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        ASSERT(mmap->navMesh);
+        MMapData* mmap = GetMMapData(mapId);
+        ASSERT(mmap && mmap->navMesh);
 
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
-            return false;
+        {
+            std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
+            MMapTile& tile = mmap->loadedTileRefs[packedGridPos];
+            if (tile.gridRefCount++ && tile.tileRef)
+                return false;
+        }
+
+        if (loadTile(mmap, mapId, x, y))
+            return true;
 
+        // forget tiles that could never be loaded, they would be retried by every path query otherwise
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
+        auto itr = mmap->loadedTileRefs.find(packedGridPos);
+        if (itr != mmap->loadedTileRefs.end() && !itr->second.tileRef && itr->second.gridRefCount == 1)
+            mmap->loadedTileRefs.erase(itr);
+
+        return false;
+    }
+
+    bool MMapManager::loadTile(MMapData* mmap, uint32 mapId, int32 x, int32 y)
+    {
         // load this tile :: mmaps/MMMXXYY.mmtile
-        std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, basePath, mapId, x, y);
+        std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, mmap->basePath, mapId, x, y);
         FILE* file = fopen(fileName.c_str(), "rb");
         if (!file)
         {
@@ -162,17 +292,38 @@ namespace MMAP
             return false;
         }
 
-        fseek(file, pos, SEEK_SET);
-
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        ASSERT(data);
+        // detour writes into the tile data when tiles are connected or disconnected, the links section and dtPoly::firstLink
+        // of every poly get private copies of their pages, vertices, detail meshes, the BV tree and off mesh connections stay
+        // shared with the page cache
+        std::unique_ptr<boost::interprocess::mapped_region> region;
+        unsigned char* data = nullptr;
+        try
+        {
+            boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+            region = std::make_unique<boost::interprocess::mapped_region>(mapping, boost::interprocess::copy_on_write, pos, fileHeader.size);
+            data = static_cast<unsigned char*>(region->get_address());
+        }
+        catch (boost::interprocess::interprocess_exception const& e)
+        {
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: could not map {} into memory ({}), reading it instead", fileName, e.what());
+            region.reset();
+        }
 
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        if (!region)
         {
-            TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap {:03}{:02}{:02}.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
+            fseek(file, pos, SEEK_SET);
+
+            data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+            ASSERT(data);
+
+            size_t result = fread(data, fileHeader.size, 1, file);
+            if (!result)
+            {
+                TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap {:03}{:02}{:02}.mmtile", mapId, x, y);
+                fclose(file);
+                dtFree(data);
+                return false;
+            }
         }
 
         fclose(file);
@@ -180,169 +331,252 @@ namespace MMAP
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
+        // wait for all leased queries of this nav mesh to finish
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
+
+        // another thread may have been faster while we were reading the file, or the grid got unloaded meanwhile
+        auto itr = mmap->loadedTileRefs.find(packTileID(x, y));
+        if (itr == mmap->loadedTileRefs.end() || itr->second.tileRef)
+        {
+            if (!region)
+                dtFree(data);
+            return itr != mmap->loadedTileRefs.end();
+        }
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
+        // mapped data stays owned by the tile and is unmapped with it
+        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, region ? 0 : DT_TILE_FREE_DATA, 0, &tileRef)))
         {
-            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            MMapTile& tile = itr->second;
+            tile.tileRef = tileRef;
+            tile.dataSize = fileHeader.size;
+            tile.lastUsed = GetTileClock();
+            tile.region = std::move(region);
             ++loadedTiles;
+            residentTileBytes += fileHeader.size;
             TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile {:03}[{:02}, {:02}] into {:03}[{:02}, {:02}]", mapId, x, y, mapId, header->x, header->y);
             return true;
         }
         else
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load {:03}{:02}{:02}.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (!region)
+                dtFree(data);
             return false;
         }
     }
 
-    bool MMapManager::loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId)
+    void MMapManager::removeTile(MMapData* mmap, uint32 mapId, uint32 packedGridPos, MMapTile& tile)
     {
-        if (!loadMapData(basePath, mapId))
-            return false;
-
-        MMapData* mmap = loadedMMaps[mapId];
-        auto [queryItr, inserted] = mmap->navMeshQueries.try_emplace(instanceId, nullptr);
-        if (!inserted)
-            return true;
+        int32 x = (packedGridPos >> 16);
+        int32 y = (packedGridPos & 0x0000FFFF);
 
-        // allocate mesh query
-        dtNavMeshQuery* query = dtAllocNavMeshQuery();
-        ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        // unload, and mark as non loaded
+        if (dtStatusFailed(mmap->navMesh->removeTile(tile.tileRef, nullptr, nullptr)))
         {
-            dtFreeNavMeshQuery(query);
-            mmap->navMeshQueries.erase(queryItr);
-            TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-            return false;
+            // this is technically a memory leak
+            // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
+            // we cannot recover from this error - assert out
+            TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload {:03}{:02}{:02}.mmtile from navmesh", mapId, x, y);
+            ABORT();
         }
 
-        TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-        queryItr->second = query;
-        return true;
+        tile.tileRef = 0;
+        tile.region.reset();
+        --loadedTiles;
+        residentTileBytes -= tile.dataSize;
+        TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile {:03}[{:02}, {:02}] from {:03}", mapId, x, y, mapId);
     }
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map. {:03}{:02}{:02}.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = itr->second;
+        // wait for all leased queries of this nav mesh to finish
+        std::unique_lock<std::shared_mutex> tileLock(mmap->tileLock);
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) == mmap->loadedTileRefs.end())
+        auto itr = mmap->loadedTileRefs.find(packedGridPos);
+        if (itr == mmap->loadedTileRefs.end())
         {
             // file may not exist, therefore not loaded
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh tile. {:03}{:02}{:02}.mmtile", mapId, x, y);
             return false;
         }
 
-        dtTileRef tileRef = mmap->loadedTileRefs[packedGridPos];
-
-        // unload, and mark as non loaded
-        if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
-        {
-            // this is technically a memory leak
-            // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
-            // we cannot recover from this error - assert out
-            TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload {:03}{:02}{:02}.mmtile from navmesh", mapId, x, y);
-            ABORT();
-        }
-        else
-        {
-            mmap->loadedTileRefs.erase(packedGridPos);
-            --loadedTiles;
-            TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile {:03}[{:02}, {:02}] from {:03}", mapId, x, y, mapId);
+        // still referenced by another grid load
+        if (--itr->second.gridRefCount)
             return true;
-        }
 
-        return false;
+        if (itr->second.tileRef)
+            removeTile(mmap, mapId, packedGridPos, itr->second);
+
+        mmap->loadedTileRefs.erase(itr);
+        return true;
     }
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
-        MMapDataSet::iterator itr = loadedMMaps.find(mapId);
-        if (itr == loadedMMaps.end() || !itr->second)
+        MMapData* mmap = nullptr;
         {
-            // file may not exist, therefore not loaded
-            TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map {:03}", mapId);
-            return false;
+            std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
+            MMapDataSet::iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end() || !itr->second)
+            {
+                // file may not exist, therefore not loaded
+                TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map {:03}", mapId);
+                return false;
+            }
+
+            // no new queries can be leased from here on
+            mmap = std::exchange(itr->second, nullptr);
         }
 
+        // wait for the queries still leased, the data can't be freed while its lock is held
+        mmap->tileLock.lock();
+        mmap->tileLock.unlock();
+
         // unload all tiles from given map
-        MMapData* mmap = itr->second;
         for (MMapTileSet::iterator i = mmap->loadedTileRefs.begin(); i != mmap->loadedTileRefs.end(); ++i)
         {
+            if (!i->second.tileRef)
+                continue;
+
             uint32 x = (i->first >> 16);
             uint32 y = (i->first & 0x0000FFFF);
-            if (dtStatusFailed(mmap->navMesh->removeTile(i->second, nullptr, nullptr)))
+            if (dtStatusFailed(mmap->navMesh->removeTile(i->second.tileRef, nullptr, nullptr)))
                 TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload {:03}{:02}{:02}.mmtile from navmesh", mapId, x, y);
             else
             {
                 --loadedTiles;
+                residentTileBytes -= i->second.dataSize;
                 TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile {:03}[{:02}, {:02}] from {:03}", mapId, x, y, mapId);
             }
         }
 
         delete mmap;
-        itr->second = nullptr;
         TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded {:03}.mmap", mapId);
 
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    uint32 MMapManager::EnsureTilesLoaded(uint32 mapId, std::vector<std::pair<int32, int32>> const& tiles, bool markUsed)
     {
-        // check if we have this map loaded
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
+            return 0;
+
+        int64 now = GetTileClock();
+        std::vector<uint32> evictedTiles;
         {
-            // file may not exist, therefore not loaded
-            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map {:03}", mapId);
-            return false;
+            std::shared_lock<std::shared_mutex> tileLock(mmap->tileLock);
+            for (auto const& [x, y] : tiles)
+            {
+                if (x < 0 || x > 63 || y < 0 || y > 63)
+                    continue;
+
+                auto itr = mmap->loadedTileRefs.find(packTileID(x, y));
+                if (itr == mmap->loadedTileRefs.end())
+                    continue;
+
+                if (!itr->second.tileRef)
+                    evictedTiles.push_back(itr->first);
+                else if (markUsed)
+                    itr->second.lastUsed.store(now, std::memory_order_relaxed);
+            }
         }
 
-        MMapData* mmap = itr->second;
-        auto queryItr = mmap->navMeshQueries.find(instanceId);
-        if (queryItr == mmap->navMeshQueries.end())
+        // reloaded tiles are marked used by loadTile
+        uint32 reloaded = 0;
+        for (uint32 packedGridPos : evictedTiles)
+            if (loadTile(mmap, mapId, packedGridPos >> 16, packedGridPos & 0x0000FFFF))
+                ++reloaded;
+
+        return reloaded;
+    }
+
+    void MMapManager::EvictColdTiles()
+    {
+        std::size_t budget = tileMemoryBudget;
+        if (!budget || residentTileBytes <= budget)
+            return;
+
+        struct EvictionCandidate
         {
-            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId {:03} instanceId {}", mapId, instanceId);
-            return false;
+            MMapData* Data;
+            uint32 MapId;
+            uint32 PackedGridPos;
+            int64 LastUsed;
+        };
+
+        // keeps every MMapData alive while we work on it
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
+
+        int64 now = GetTileClock();
+        std::vector<EvictionCandidate> candidates;
+        for (auto const& [mapId, mmap] : loadedMMaps)
+        {
+            if (!mmap)
+                continue;
+
+            std::shared_lock<std::shared_mutex> tileLock(mmap->tileLock);
+            for (auto const& [packedGridPos, tile] : mmap->loadedTileRefs)
+            {
+                int64 lastUsed = tile.lastUsed.load(std::memory_order_relaxed);
+                if (tile.tileRef && now - lastUsed >= TILE_MIN_IDLE_TIME)
+                    candidates.push_back({ mmap, mapId, packedGridPos, lastUsed });
+            }
         }
 
-        dtFreeNavMeshQuery(queryItr->second);
-        mmap->navMeshQueries.erase(queryItr);
-        TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId {:03} instanceId {}", mapId, instanceId);
+        std::sort(candidates.begin(), candidates.end(), [](EvictionCandidate const& left, EvictionCandidate const& right)
+        {
+            return left.LastUsed < right.LastUsed;
+        });
 
-        return true;
+        uint32 evicted = 0;
+        for (EvictionCandidate const& candidate : candidates)
+        {
+            if (residentTileBytes <= budget)
+                break;
+
+            std::unique_lock<std::shared_mutex> tileLock(candidate.Data->tileLock);
+            auto itr = candidate.Data->loadedTileRefs.find(candidate.PackedGridPos);
+            if (itr == candidate.Data->loadedTileRefs.end() || !itr->second.tileRef || itr->second.lastUsed.load(std::memory_order_relaxed) != candidate.LastUsed)
+                continue;
+
+            removeTile(candidate.Data, candidate.MapId, candidate.PackedGridPos, itr->second);
+            ++evicted;
+        }
+
+        if (evicted)
+            TC_LOG_DEBUG("maps", "MMAP:EvictColdTiles: Evicted {} tiles, {} bytes of tile data left loaded", evicted, residentTileBytes.load());
     }
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
             return nullptr;
 
-        return itr->second->navMesh;
+        return mmap->navMesh;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    NavMeshQueryLease MMapManager::LeaseNavMeshQuery(uint32 mapId)
     {
-        auto itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
-            return nullptr;
-
-        auto queryItr = itr->second->navMeshQueries.find(instanceId);
-        if (queryItr == itr->second->navMeshQueries.end())
-            return nullptr;
+        // keep the map list locked until the data is pinned by its tile lock, unloadMap(mapId) can't free it in between
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.cend() || !itr->second)
+            return NavMeshQueryLease();
 
-        return queryItr->second;
+        return NavMeshQueryLease(itr->second, std::shared_lock<std::shared_mutex>(itr->second->tileLock));
     }
 }
@@ -21,66 +21,130 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+namespace boost { namespace interprocess { class mapped_region; } }
+
 //  move map related classes
 namespace MMAP
 {
-    typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    // a .mmtile of a loaded grid, its data may be evicted from the nav mesh while the grid stays loaded
+    struct TC_COMMON_API MMapTile
+    {
+        MMapTile();
+        ~MMapTile();
+
+        dtTileRef tileRef;                  // 0 while the tile is not part of the nav mesh
+        uint32 gridRefCount;                // loadMap() calls not matched by unloadMap() yet
+        uint32 dataSize;
+        std::atomic<int64> lastUsed;        // steady clock milliseconds of the last path query through this tile
+        std::unique_ptr<boost::interprocess::mapped_region> region; // copy on write file mapping holding the tile data, if mapped
+    };
+
+    typedef std::unordered_map<uint32, MMapTile> MMapTileSet;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
-        ~MMapData()
-        {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
+        MMapData(dtNavMesh* mesh, std::string const& path) : navMesh(mesh), basePath(path) { }
+        ~MMapData();
 
-            if (navMesh)
-                dtFreeNavMesh(navMesh);
-        }
+        dtNavMeshQuery* AcquireQuery();
+        void ReleaseQuery(dtNavMeshQuery* query);
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every concurrent user leases its own one from this pool
+        std::vector<dtNavMeshQuery*> queryPool;
+        std::mutex queryPoolLock;
+
+        // held shared by every query lease and exclusively while tiles are added or removed
+        std::shared_mutex tileLock;
 
         dtNavMesh* navMesh;
-        MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+        std::string basePath;               // data directory, evicted tiles are reloaded from here
+        MMapTileSet loadedTileRefs;         // maps [map grid coords] to [dtTile]
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
 
+    // exclusive use of a pooled dtNavMeshQuery, returned to the pool on destruction
+    // tiles of the nav mesh are not added or removed while a lease is held, so keep it short
+    // and never lease a second query on the same thread
+    class TC_COMMON_API NavMeshQueryLease
+    {
+        public:
+            NavMeshQueryLease() : _data(nullptr), _query(nullptr) { }
+            NavMeshQueryLease(MMapData* data, std::shared_lock<std::shared_mutex>&& tileLock);
+            ~NavMeshQueryLease() { Release(); }
+
+            NavMeshQueryLease(NavMeshQueryLease const&) = delete;
+            NavMeshQueryLease& operator=(NavMeshQueryLease const&) = delete;
+            NavMeshQueryLease(NavMeshQueryLease&& other) noexcept;
+            NavMeshQueryLease& operator=(NavMeshQueryLease&& other) noexcept;
+
+            dtNavMeshQuery* get() const { return _query; }
+            // the nav mesh of the leased query, only valid as long as the lease is held
+            dtNavMesh const* GetNavMesh() const { return _query ? _query->getAttachedNavMesh() : nullptr; }
+            dtNavMeshQuery* operator->() const { return _query; }
+            explicit operator bool() const { return _query != nullptr; }
+
+            void Release();
+
+        private:
+            MMapData* _data;
+            dtNavMeshQuery* _query;
+            std::shared_lock<std::shared_mutex> _tileLock;
+    };
+
     // singleton class
     // holds all all access to mmap loading unloading and meshes
     class TC_COMMON_API MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0), thread_safe_environment(true) {}
+            MMapManager() : loadedTiles(0), residentTileBytes(0), tileMemoryBudget(0), thread_safe_environment(true) {}
             ~MMapManager();
 
             void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
+            bool loadMapData(std::string const& basePath, uint32 mapId);
             bool loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y);
-            bool loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // makes sure the tiles of the given loaded grids are part of the nav mesh, markUsed also keeps the
+            // already resident ones from being evicted for a while
+            // returns the number of evicted tiles that had to be reloaded
+            // must not be called while holding a NavMeshQueryLease
+            uint32 EnsureTilesLoaded(uint32 mapId, std::vector<std::pair<int32, int32>> const& tiles, bool markUsed);
+
+            // tiles not used by path queries for a while are removed from their nav mesh until the budget is met, 0 disables
+            void SetTileMemoryBudget(std::size_t bytes) { tileMemoryBudget = bytes; }
+            void EvictColdTiles();
+
+            // the leased query may be used from any thread, empty if the map has no nav mesh
+            NavMeshQueryLease LeaseNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
-            uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
+            uint32 getLoadedMapsCount() const;
+            std::size_t getLoadedTilesSize() const { return residentTileBytes; }
+            std::size_t getTileMemoryBudget() const { return tileMemoryBudget; }
         private:
-            bool loadMapData(std::string const& basePath, uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            bool loadTile(MMapData* mmap, uint32 mapId, int32 x, int32 y);
+            void removeTile(MMapData* mmap, uint32 mapId, uint32 packedGridPos, MMapTile& tile);
 
-            MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
+            MMapData* GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
-            uint32 loadedTiles;
+            mutable std::shared_mutex loadedMMapsLock;
+            std::atomic<uint32> loadedTiles;
+            std::atomic<std::size_t> residentTileBytes;
+            std::atomic<std::size_t> tileMemoryBudget;
             bool thread_safe_environment;
     };
 }
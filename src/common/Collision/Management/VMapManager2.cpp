@@ -17,6 +17,8 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <array>
 #include <string>
 #include <sstream>
 #include "VMapManager2.h"
@@ -37,6 +39,7 @@ namespace VMAP
         GetLiquidFlagsPtr = &GetLiquidFlagsDummy;
         IsVMAPDisabledForPtr = &IsVMAPDisabledForDummy;
         thread_safe_environment = true;
+        iLineOfSightCacheSize = 0;
     }
 
     VMapManager2::~VMapManager2(void)
@@ -127,6 +130,7 @@ namespace VMAP
                 delete newTree;
                 return false;
             }
+            newTree->setLineOfSightCacheSize(iLineOfSightCacheSize);
             instanceTree->second = newTree;
         }
 
@@ -180,6 +184,53 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, std::span<LineOfSightQuery> queries, ModelIgnoreFlags ignoreFlags)
+    {
+        for (LineOfSightQuery& query : queries)
+            query.inLineOfSight = true;
+
+        if (queries.empty() || !isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            return;
+
+        InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        for (uint32 index : getTileOrder(queries, [](LineOfSightQuery const& query) { return std::array<float, 3>{ query.x1, query.y1, query.z1 }; }))
+        {
+            LineOfSightQuery& query = queries[index];
+            Vector3 pos1 = convertPositionToInternalRep(query.x1, query.y1, query.z1);
+            Vector3 pos2 = convertPositionToInternalRep(query.x2, query.y2, query.z2);
+            if (pos1 != pos2)
+                query.inLineOfSight = instanceTree->second->isInLineOfSight(pos1, pos2, ignoreFlags);
+        }
+    }
+
+    template<typename Query, typename Projection>
+    std::vector<uint32> VMapManager2::getTileOrder(std::span<Query> queries, Projection projection) const
+    {
+        float const tileSize = 533.33333333f;
+        std::vector<std::pair<uint32, uint32>> order;
+        order.reserve(queries.size());
+        for (uint32 i = 0; i < queries.size(); ++i)
+        {
+            std::array<float, 3> point = projection(queries[i]);
+            Vector3 pos = convertPositionToInternalRep(point[0], point[1], point[2]);
+            uint32 tileX = uint32(std::max(pos.x, 0.0f) / tileSize);
+            uint32 tileY = uint32(std::max(pos.y, 0.0f) / tileSize);
+            order.emplace_back(StaticMapTree::packTileID(tileX, tileY), i);
+        }
+
+        std::sort(order.begin(), order.end());
+
+        std::vector<uint32> indices;
+        indices.reserve(order.size());
+        for (std::pair<uint32, uint32> const& entry : order)
+            indices.push_back(entry.second);
+
+        return indices;
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -210,6 +261,37 @@ namespace VMAP
         return false;
     }
 
+    void VMapManager2::getObjectHitPos(unsigned int mapId, std::span<ObjectHitPosQuery> queries)
+    {
+        for (ObjectHitPosQuery& query : queries)
+        {
+            query.rx = query.x2;
+            query.ry = query.y2;
+            query.rz = query.z2;
+            query.hit = false;
+        }
+
+        if (queries.empty() || !isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            return;
+
+        InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        for (uint32 index : getTileOrder(queries, [](ObjectHitPosQuery const& query) { return std::array<float, 3>{ query.x1, query.y1, query.z1 }; }))
+        {
+            ObjectHitPosQuery& query = queries[index];
+            Vector3 pos1 = convertPositionToInternalRep(query.x1, query.y1, query.z1);
+            Vector3 pos2 = convertPositionToInternalRep(query.x2, query.y2, query.z2);
+            Vector3 resultPos;
+            query.hit = instanceTree->second->getObjectHitPos(pos1, pos2, resultPos, query.modifyDist);
+            resultPos = convertPositionToInternalRep(resultPos.x, resultPos.y, resultPos.z);
+            query.rx = resultPos.x;
+            query.ry = resultPos.y;
+            query.rz = resultPos.z;
+        }
+    }
+
     /**
     get height or INVALID_HEIGHT if no height available
     */
@@ -233,6 +315,28 @@ namespace VMAP
         return VMAP_INVALID_HEIGHT_VALUE;
     }
 
+    void VMapManager2::getHeight(unsigned int mapId, std::span<HeightQuery> queries)
+    {
+        for (HeightQuery& query : queries)
+            query.height = VMAP_INVALID_HEIGHT_VALUE;
+
+        if (queries.empty() || !isHeightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_HEIGHT))
+            return;
+
+        InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        for (uint32 index : getTileOrder(queries, [](HeightQuery const& query) { return std::array<float, 3>{ query.x, query.y, query.z }; }))
+        {
+            HeightQuery& query = queries[index];
+            Vector3 pos = convertPositionToInternalRep(query.x, query.y, query.z);
+            float height = instanceTree->second->getHeight(pos, query.maxSearchDist);
+            if (height < G3D::finf())
+                query.height = height;
+        }
+    }
+
     bool VMapManager2::getAreaAndLiquidData(unsigned int mapId, float x, float y, float z, Optional<uint8> reqLiquidType, AreaAndLiquidData& data) const
     {
         InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
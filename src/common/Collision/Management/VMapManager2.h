@@ -19,6 +19,7 @@
 #define _VMAPMANAGER2_H
 
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include "Define.h"
@@ -81,6 +82,7 @@ namespace VMAP
             ModelFileMap iLoadedModelFiles;
             InstanceTreeMap iInstanceMapTrees;
             bool thread_safe_environment;
+            uint32 iLineOfSightCacheSize;
             // Mutex for iLoadedModelFiles
             std::mutex LoadedModelFilesLock;
 
@@ -95,6 +97,9 @@ namespace VMAP
         public:
             // public for debug
             G3D::Vector3 convertPositionToInternalRep(float x, float y, float z) const;
+            // query indices ordered by the tile of their first point, consecutive traversals then walk the same tree nodes and models
+            template<typename Query, typename Projection>
+            std::vector<uint32> getTileOrder(std::span<Query> queries, Projection projection) const;
             static std::string getMapFileName(unsigned int mapId);
 
             VMapManager2();
@@ -108,10 +113,24 @@ namespace VMAP
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) override ;
             /**
+            answer several line of sight checks at once, fills inLineOfSight of every query
+            */
+            void isInLineOfSight(unsigned int mapId, std::span<LineOfSightQuery> queries, ModelIgnoreFlags ignoreFlags);
+            /**
+            number of line of sight results remembered per map, 0 disables the cache
+            only affects maps loaded afterwards
+            */
+            void setLineOfSightCacheSize(uint32 size) { iLineOfSightCacheSize = size; }
+            /**
             fill the hit pos and return true, if an object was hit
             */
             bool getObjectHitPos(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist) override;
             float getHeight(unsigned int mapId, float x, float y, float z, float maxSearchDist) override;
+            /**
+            batched variants of getObjectHitPos and getHeight, fill the result fields of every query
+            */
+            void getObjectHitPos(unsigned int mapId, std::span<ObjectHitPosQuery> queries);
+            void getHeight(unsigned int mapId, std::span<HeightQuery> queries);
 
             bool processCommand(char* /*command*/) override { return false; } // for debug and extensions
 
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "LineOfSightCache.h"
+#include "Hash.h"
+#include "ModelIgnoreFlags.h"
+#include <G3D/AABox.h>
+#include <G3D/Vector3.h>
+#include <algorithm>
+#include <cmath>
+
+namespace VMAP
+{
+    LineOfSightCache::LineOfSightCache(uint32 capacity) : _shards(std::make_unique<Shard[]>(SHARD_COUNT)),
+        _shardCapacity(std::max<std::size_t>((capacity + SHARD_COUNT - 1) / SHARD_COUNT, 1)), _generation(0)
+    {
+    }
+
+    LineOfSightCache::~LineOfSightCache() = default;
+
+    std::size_t LineOfSightCache::KeyHash::operator()(Key const& key) const
+    {
+        std::size_t hashVal = 0;
+        for (int32 coord : key.Coords)
+            Trinity::hash_combine(hashVal, coord);
+        Trinity::hash_combine(hashVal, key.IgnoreFlags);
+        return hashVal;
+    }
+
+    LineOfSightCache::Key LineOfSightCache::MakeKey(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags)
+    {
+        auto quantize = [](float coord) { return int32(std::floor(coord * (1.0f / QUANTIZATION_STEP))); };
+
+        Key key;
+        key.Coords = { quantize(pos1.x), quantize(pos1.y), quantize(pos1.z), quantize(pos2.x), quantize(pos2.y), quantize(pos2.z) };
+        key.IgnoreFlags = uint32(ignoreFlags);
+        return key;
+    }
+
+    LineOfSightCache::Shard& LineOfSightCache::GetShard(Key const& key)
+    {
+        // the low bits of the hash pick the bucket inside the shard, use the high ones here
+        std::size_t hashVal = KeyHash()(key);
+        return _shards[(hashVal >> 16) % SHARD_COUNT];
+    }
+
+    Optional<bool> LineOfSightCache::Find(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags)
+    {
+        Key key = MakeKey(pos1, pos2, ignoreFlags);
+        Shard& shard = GetShard(key);
+
+        std::lock_guard<std::mutex> lock(shard.Lock);
+        auto itr = shard.Lookup.find(key);
+        if (itr == shard.Lookup.end())
+            return {};
+
+        shard.Entries.splice(shard.Entries.begin(), shard.Entries, itr->second);
+        return itr->second->second;
+    }
+
+    void LineOfSightCache::Store(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags, bool inLineOfSight, uint32 generation)
+    {
+        Key key = MakeKey(pos1, pos2, ignoreFlags);
+        Shard& shard = GetShard(key);
+
+        std::lock_guard<std::mutex> lock(shard.Lock);
+        // Invalidate() bumps the generation before clearing the shards, checking it under the shard lock
+        // guarantees that a result computed against old geometry never outlives the clear
+        if (generation != GetGeneration())
+            return;
+
+        auto itr = shard.Lookup.find(key);
+        if (itr != shard.Lookup.end())
+        {
+            itr->second->second = inLineOfSight;
+            shard.Entries.splice(shard.Entries.begin(), shard.Entries, itr->second);
+            return;
+        }
+
+        if (shard.Entries.size() >= _shardCapacity)
+        {
+            shard.Lookup.erase(shard.Entries.back().first);
+            shard.Entries.pop_back();
+        }
+
+        shard.Entries.emplace_front(key, inLineOfSight);
+        shard.Lookup.emplace(key, shard.Entries.begin());
+    }
+
+    template<typename Predicate>
+    void LineOfSightCache::EraseIf(Predicate&& predicate)
+    {
+        // Store() checks the generation under the shard lock, bumping it first means a result computed
+        // against the old geometry is either erased below or rejected there
+        _generation.fetch_add(1, std::memory_order_acq_rel);
+
+        for (uint32 i = 0; i < SHARD_COUNT; ++i)
+        {
+            Shard& shard = _shards[i];
+            std::lock_guard<std::mutex> lock(shard.Lock);
+            for (auto itr = shard.Entries.begin(); itr != shard.Entries.end();)
+            {
+                if (predicate(itr->first))
+                {
+                    shard.Lookup.erase(itr->first);
+                    itr = shard.Entries.erase(itr);
+                }
+                else
+                    ++itr;
+            }
+        }
+    }
+
+    void LineOfSightCache::Invalidate(G3D::AABox const& bounds)
+    {
+        EraseIf([&bounds](Key const& key)
+        {
+            // the entry answers for every ray between the two cells, test the box spanning both of them
+            G3D::Vector3 cell1(float(key.Coords[0]), float(key.Coords[1]), float(key.Coords[2]));
+            G3D::Vector3 cell2(float(key.Coords[3]), float(key.Coords[4]), float(key.Coords[5]));
+            G3D::Vector3 low = cell1.min(cell2) * QUANTIZATION_STEP;
+            G3D::Vector3 high = (cell1.max(cell2) + G3D::Vector3(1.0f, 1.0f, 1.0f)) * QUANTIZATION_STEP;
+            return G3D::AABox(low, high).intersects(bounds);
+        });
+    }
+
+    void LineOfSightCache::Invalidate()
+    {
+        EraseIf([](Key const&) { return true; });
+    }
+}
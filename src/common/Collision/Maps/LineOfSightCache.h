@@ -0,0 +1,102 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _LINEOFSIGHTCACHE_H
+#define _LINEOFSIGHTCACHE_H
+
+#include "Define.h"
+#include "Optional.h"
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace G3D
+{
+    class AABox;
+    class Vector3;
+}
+
+namespace VMAP
+{
+    enum class ModelIgnoreFlags : uint32;
+
+    /**
+    Remembers the most recent static line of sight results of one map.
+    Endpoints are snapped to a QUANTIZATION_STEP grid so that repeated checks between units that
+    barely moved are answered without traversing the tree again.
+    Entries are spread over several independently locked shards, every instance of a map shares one cache.
+    */
+    class TC_COMMON_API LineOfSightCache
+    {
+        public:
+            static constexpr float QUANTIZATION_STEP = 0.25f;
+            static constexpr uint32 SHARD_COUNT = 8;
+
+            explicit LineOfSightCache(uint32 capacity);
+            ~LineOfSightCache();
+
+            LineOfSightCache(LineOfSightCache const&) = delete;
+            LineOfSightCache& operator=(LineOfSightCache const&) = delete;
+
+            // must be read before computing a result that is going to be stored
+            uint32 GetGeneration() const { return _generation.load(std::memory_order_acquire); }
+
+            Optional<bool> Find(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags);
+            // results computed before the last Invalidate() are dropped
+            void Store(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags, bool inLineOfSight, uint32 generation);
+            // drops every result whose ray may pass through bounds, called whenever models are loaded or unloaded there
+            void Invalidate(G3D::AABox const& bounds);
+            // drops every result
+            void Invalidate();
+
+        private:
+            struct Key
+            {
+                std::array<int32, 6> Coords;            // grid cells of both endpoints
+                uint32 IgnoreFlags;
+
+                bool operator==(Key const& right) const = default;
+            };
+
+            struct KeyHash
+            {
+                std::size_t operator()(Key const& key) const;
+            };
+
+            struct Shard
+            {
+                std::mutex Lock;
+                std::list<std::pair<Key, bool>> Entries;    // most recently used first
+                std::unordered_map<Key, std::list<std::pair<Key, bool>>::iterator, KeyHash> Lookup;
+            };
+
+            static Key MakeKey(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, ModelIgnoreFlags ignoreFlags);
+            Shard& GetShard(Key const& key);
+            template<typename Predicate>
+            void EraseIf(Predicate&& predicate);
+
+            std::unique_ptr<Shard[]> _shards;
+            std::size_t _shardCapacity;
+            std::atomic<uint32> _generation;
+    };
+}
+
+#endif // _LINEOFSIGHTCACHE_H
@@ -132,12 +132,51 @@ namespace VMAP
         // prevent NaN values which can cause BIH intersection to enter infinite loop
         if (maxDist < 1e-10f)
             return true;
+
+        uint32 cacheGeneration = 0;
+        if (iLineOfSightCache)
+        {
+            if (Optional<bool> cached = iLineOfSightCache->Find(pos1, pos2, ignoreFlag))
+                return *cached;
+
+            cacheGeneration = iLineOfSightCache->GetGeneration();
+        }
+
         // direction with length of 1
         G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1, (pos2 - pos1)/maxDist);
-        if (getIntersectionTime(ray, maxDist, true, ignoreFlag))
-            return false;
+        bool result = !getIntersectionTime(ray, maxDist, true, ignoreFlag);
+
+        if (iLineOfSightCache)
+            iLineOfSightCache->Store(pos1, pos2, ignoreFlag, result, cacheGeneration);
 
-        return true;
+        return result;
+    }
+
+    void StaticMapTree::trackChangedBounds(ModelSpawn const& spawn, G3D::AABox& bounds, bool& unbounded)
+    {
+        if (spawn.flags & MOD_HAS_BOUND)
+            bounds.merge(spawn.iBound);
+        else
+            unbounded = true;
+    }
+
+    void StaticMapTree::invalidateLineOfSight(G3D::AABox const& bounds, bool unbounded)
+    {
+        if (!iLineOfSightCache)
+            return;
+
+        if (unbounded)
+            iLineOfSightCache->Invalidate();
+        else if (!bounds.isEmpty())
+            iLineOfSightCache->Invalidate(bounds);
+    }
+
+    void StaticMapTree::setLineOfSightCacheSize(uint32 size)
+    {
+        if (size)
+            iLineOfSightCache = std::make_unique<LineOfSightCache>(size);
+        else
+            iLineOfSightCache.reset();
     }
     //=========================================================
     /**
@@ -323,6 +362,9 @@ namespace VMAP
             return false;
         }
         bool result = true;
+        // union of the models that appeared in the tree, only rays through them need to be forgotten
+        G3D::AABox changedBounds;
+        bool changedUnbounded = false;
 
         std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
         FILE* tf = fopen(tilefile.c_str(), "rb");
@@ -362,6 +404,7 @@ namespace VMAP
 
                             iTreeValues[referencedVal] = ModelInstance(spawn, model);
                             iLoadedSpawns[referencedVal] = 1;
+                            trackChangedBounds(spawn, changedBounds, changedUnbounded);
                         }
                         else
                         {
@@ -383,6 +426,9 @@ namespace VMAP
         }
         else
             iLoadedTiles[packTileID(tileX, tileY)] = false;
+
+        invalidateLineOfSight(changedBounds, changedUnbounded);
+
         TC_METRIC_EVENT("map_events", "LoadMapTile",
             "Map: " + std::to_string(iMapID) + " TileX: " + std::to_string(tileX) + " TileY: " + std::to_string(tileY));
         return result;
@@ -399,6 +445,8 @@ namespace VMAP
             TC_LOG_ERROR("misc", "StaticMapTree::UnloadMapTile() : trying to unload non-loaded tile - Map:{} X:{} Y:{}", iMapID, tileX, tileY);
             return;
         }
+        G3D::AABox changedBounds;
+        bool changedUnbounded = false;
         if (tile->second) // file associated with tile
         {
             std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
@@ -433,6 +481,7 @@ namespace VMAP
                             TC_LOG_ERROR("misc", "StaticMapTree::UnloadMapTile() : trying to unload non-referenced model '{}' (ID:{})", spawn.name, spawn.ID);
                             else if (--iLoadedSpawns[referencedNode] == 0)
                             {
+                                trackChangedBounds(spawn, changedBounds, changedUnbounded);
                                 iTreeValues[referencedNode].setUnloaded();
                                 iLoadedSpawns.erase(referencedNode);
                             }
@@ -443,6 +492,9 @@ namespace VMAP
             }
         }
         iLoadedTiles.erase(tile);
+
+        invalidateLineOfSight(changedBounds, changedUnbounded);
+
         TC_METRIC_EVENT("map_events", "UnloadMapTile",
             "Map: " + std::to_string(iMapID) + " TileX: " + std::to_string(tileX) + " TileY: " + std::to_string(tileY));
     }
@@ -20,11 +20,14 @@
 
 #include "Define.h"
 #include "BoundingIntervalHierarchy.h"
+#include "LineOfSightCache.h"
+#include <memory>
 #include <unordered_map>
 
 namespace VMAP
 {
     class ModelInstance;
+    class ModelSpawn;
     class GroupModel;
     class VMapManager2;
     enum class LoadResult : uint8;
@@ -63,9 +66,12 @@ namespace VMAP
             // stores <tree_index, reference_count> to invalidate tree values, unload map, and to be able to report errors
             loadedSpawnMap iLoadedSpawns;
             std::string iBasePath;
+            std::unique_ptr<LineOfSightCache> iLineOfSightCache;
 
         private:
             bool getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            static void trackChangedBounds(ModelSpawn const& spawn, G3D::AABox& bounds, bool& unbounded);
+            void invalidateLineOfSight(G3D::AABox const& bounds, bool unbounded);
             //bool containsLoadedMapTile(unsigned int pTileIdent) const { return(iLoadedMapTiles.containsKey(pTileIdent)); }
         public:
             static std::string getTileFileName(uint32 mapID, uint32 tileX, uint32 tileY);
@@ -77,6 +83,8 @@ namespace VMAP
             ~StaticMapTree();
 
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2, ModelIgnoreFlags ignoreFlags) const;
+            // 0 disables the cache
+            void setLineOfSightCacheSize(uint32 size);
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
             bool GetLocationInfo(const G3D::Vector3 &pos, LocationInfo &info) const;
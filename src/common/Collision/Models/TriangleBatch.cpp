@@ -0,0 +1,194 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TriangleBatch.h"
+#include "WorldModel.h"
+#include <G3D/Ray.h>
+#include <G3D/Vector3.h>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VMAP_TRIANGLE_BATCH_SSE2
+#endif
+
+namespace VMAP
+{
+    static constexpr float TRIANGLE_EPS = 1e-5f;
+
+    std::atomic<bool> TriangleBatch::_simdEnabled(true);
+
+    bool TriangleBatch::IsSimdAvailable()
+    {
+#ifdef VMAP_TRIANGLE_BATCH_SSE2
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void TriangleBatch::SetSimdEnabled(bool enabled)
+    {
+        _simdEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool TriangleBatch::IsSimdEnabled()
+    {
+        return IsSimdAvailable() && _simdEnabled.load(std::memory_order_relaxed);
+    }
+
+    void TriangleBatch::Build(std::vector<G3D::Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, std::vector<uint32> const& order)
+    {
+        Clear();
+
+        // pad so the last leaf can always be loaded as full lanes, the padding is masked out
+        std::size_t size = order.size() + LANES - 1;
+        for (std::vector<float>* component : { &_v0x, &_v0y, &_v0z, &_e1x, &_e1y, &_e1z, &_e2x, &_e2y, &_e2z })
+            component->resize(size, 0.0f);
+
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            MeshTriangle const& tri = triangles[order[i]];
+            G3D::Vector3 const& v0 = vertices[tri.idx0];
+            G3D::Vector3 const e1 = vertices[tri.idx1] - v0;
+            G3D::Vector3 const e2 = vertices[tri.idx2] - v0;
+
+            _v0x[i] = v0.x; _v0y[i] = v0.y; _v0z[i] = v0.z;
+            _e1x[i] = e1.x; _e1y[i] = e1.y; _e1z[i] = e1.z;
+            _e2x[i] = e2.x; _e2y[i] = e2.y; _e2z[i] = e2.z;
+        }
+    }
+
+    void TriangleBatch::Clear()
+    {
+        for (std::vector<float>* component : { &_v0x, &_v0y, &_v0z, &_e1x, &_e1y, &_e1z, &_e2x, &_e2y, &_e2z })
+        {
+            component->clear();
+            component->shrink_to_fit();
+        }
+    }
+
+    bool TriangleBatch::IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+#ifdef VMAP_TRIANGLE_BATCH_SSE2
+        if (!_simdEnabled.load(std::memory_order_relaxed))
+            return IntersectRayScalar(ray, first, count, distance);
+
+        // same operations in the same order as IntersectRayScalar (RTR2 ch. 13.7), four triangles per step
+        G3D::Vector3 const& dir = ray.direction();
+        G3D::Vector3 const& org = ray.origin();
+        __m128 const dx = _mm_set1_ps(dir.x), dy = _mm_set1_ps(dir.y), dz = _mm_set1_ps(dir.z);
+        __m128 const ox = _mm_set1_ps(org.x), oy = _mm_set1_ps(org.y), oz = _mm_set1_ps(org.z);
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const eps = _mm_set1_ps(TRIANGLE_EPS);
+        __m128 const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 const laneIndex = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        __m128 const infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+        bool hit = false;
+        for (uint32 i = first; i < first + count; i += LANES)
+        {
+            __m128 const e1x = _mm_loadu_ps(&_e1x[i]), e1y = _mm_loadu_ps(&_e1y[i]), e1z = _mm_loadu_ps(&_e1z[i]);
+            __m128 const e2x = _mm_loadu_ps(&_e2x[i]), e2y = _mm_loadu_ps(&_e2y[i]), e2z = _mm_loadu_ps(&_e2z[i]);
+
+            // p = dir x e2
+            __m128 const px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 const py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 const pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 const a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+            // lanes past the end of the leaf and ill-conditioned determinants are rejected
+            __m128 valid = _mm_cmplt_ps(laneIndex, _mm_set1_ps(float(first + count - i)));
+            valid = _mm_and_ps(valid, _mm_cmpge_ps(_mm_and_ps(a, absMask), eps));
+            if (!_mm_movemask_ps(valid))
+                continue;
+
+            __m128 const f = _mm_div_ps(one, a);
+            __m128 const sx = _mm_sub_ps(ox, _mm_loadu_ps(&_v0x[i]));
+            __m128 const sy = _mm_sub_ps(oy, _mm_loadu_ps(&_v0y[i]));
+            __m128 const sz = _mm_sub_ps(oz, _mm_loadu_ps(&_v0z[i]));
+            __m128 const u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+            // q = s x e1
+            __m128 const qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 const qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 const qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 const v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+            __m128 const t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+            if (!_mm_movemask_ps(valid))
+                continue;
+
+            // closest valid lane
+            __m128 closest = _mm_or_ps(_mm_and_ps(valid, t), _mm_andnot_ps(valid, infinity));
+            closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(2, 3, 0, 1)));
+            closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(1, 0, 3, 2)));
+            distance = _mm_cvtss_f32(closest);
+            hit = true;
+        }
+
+        return hit;
+#else
+        return IntersectRayScalar(ray, first, count, distance);
+#endif
+    }
+
+    bool TriangleBatch::IntersectRayScalar(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        G3D::Vector3 const& dir = ray.direction();
+        G3D::Vector3 const& org = ray.origin();
+
+        bool hit = false;
+        for (uint32 i = first; i < first + count; ++i)
+        {
+            G3D::Vector3 const e1(_e1x[i], _e1y[i], _e1z[i]);
+            G3D::Vector3 const e2(_e2x[i], _e2y[i], _e2z[i]);
+            G3D::Vector3 const p(dir.cross(e2));
+            float const a = e1.dot(p);
+
+            // Determinant is ill-conditioned
+            if (std::fabs(a) < TRIANGLE_EPS)
+                continue;
+
+            float const f = 1.0f / a;
+            G3D::Vector3 const s(org - G3D::Vector3(_v0x[i], _v0y[i], _v0z[i]));
+            float const u = f * s.dot(p);
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            G3D::Vector3 const q(s.cross(e1));
+            float const v = f * dir.dot(q);
+            if (v < 0.0f || (u + v) > 1.0f)
+                continue;
+
+            float const t = f * e2.dot(q);
+            if (t > 0.0f && t < distance)
+            {
+                distance = t;
+                hit = true;
+            }
+        }
+
+        return hit;
+    }
+}
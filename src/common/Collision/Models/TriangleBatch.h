@@ -0,0 +1,70 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _TRIANGLEBATCH_H
+#define _TRIANGLEBATCH_H
+
+#include "Define.h"
+#include <atomic>
+#include <vector>
+
+namespace G3D
+{
+    class Ray;
+    class Vector3;
+}
+
+namespace VMAP
+{
+    class MeshTriangle;
+
+    /**
+    Triangles of one mesh prepared for ray tests.
+    The first vertex and both edges of every triangle are stored as separate coordinate arrays in the
+    order of the mesh BIH object list, so the triangles of a BIH leaf are contiguous and can be tested
+    LANES at a time.
+    */
+    class TC_COMMON_API TriangleBatch
+    {
+        public:
+            static constexpr uint32 LANES = 4;
+
+            void Build(std::vector<G3D::Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, std::vector<uint32> const& order);
+            void Clear();
+
+            // tests the triangles [first, first + count) and shortens distance to the closest hit in front of the ray origin
+            bool IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const;
+
+            // whether the build has a SIMD kernel, IntersectRay uses it unless disabled below
+            static bool IsSimdAvailable();
+            // lets benchmarks compare against the scalar kernel, affects every batch
+            static void SetSimdEnabled(bool enabled);
+            static bool IsSimdEnabled();
+
+        private:
+            bool IntersectRayScalar(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const;
+
+            static std::atomic<bool> _simdEnabled;
+
+            std::vector<float> _v0x, _v0y, _v0z;
+            std::vector<float> _e1x, _e1y, _e1z;
+            std::vector<float> _e2x, _e2y, _e2z;
+    };
+}
+
+#endif // _TRIANGLEBATCH_H
@@ -289,7 +289,7 @@ namespace VMAP
 
     GroupModel::GroupModel(GroupModel const& other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), meshTriangles(other.meshTriangles), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -301,6 +301,7 @@ namespace VMAP
         triangles.swap(tri);
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
+        meshTriangles.Build(vertices, triangles, meshTree.primIndices());
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -357,6 +358,7 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        meshTriangles.Clear();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -383,6 +385,7 @@ namespace VMAP
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
         if (result) result = meshTree.readFromFile(rf);
+        if (result) meshTriangles.Build(vertices, triangles, meshTree.primIndices());
 
         // write liquid data
         if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
@@ -394,15 +397,21 @@ namespace VMAP
 
     struct GModelRayCallback
     {
-        GModelRayCallback(std::vector<MeshTriangle> const& tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) { }
+        GModelRayCallback(std::vector<MeshTriangle> const& tris, const std::vector<Vector3> &vert, TriangleBatch const& batch):
+            vertices(vert.begin()), triangles(tris.begin()), leafTriangles(batch), hit(false) { }
         bool operator()(G3D::Ray const& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/)
         {
             hit = IntersectTriangle(triangles[entry], vertices, ray, distance) || hit;
             return hit;
         }
+        bool intersectLeaf(G3D::Ray const& ray, uint32 first, uint32 count, float& distance, bool /*pStopAtFirstHit*/)
+        {
+            hit = leafTriangles.IntersectRay(ray, first, count, distance) || hit;
+            return hit;
+        }
         std::vector<Vector3>::const_iterator vertices;
         std::vector<MeshTriangle>::const_iterator triangles;
+        TriangleBatch const& leafTriangles;
         bool hit;
     };
 
@@ -411,7 +420,7 @@ namespace VMAP
         if (triangles.empty())
             return false;
 
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(triangles, vertices, meshTriangles);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
@@ -23,6 +23,7 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include "BoundingIntervalHierarchy.h"
+#include "TriangleBatch.h"
 
 #include "Define.h"
 
@@ -102,6 +103,7 @@ namespace VMAP
             std::vector<G3D::Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            TriangleBatch meshTriangles;    //!< triangles in meshTree leaf order for ray tests
             WmoLiquid* iLiquid;
     };
 
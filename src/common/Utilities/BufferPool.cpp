@@ -0,0 +1,199 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BufferPool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+
+namespace
+{
+    struct SizeClass
+    {
+        std::size_t Capacity;
+        std::size_t ThreadCacheSize;
+        std::size_t DepotSize;
+    };
+
+    // matches the growth steps of ByteBuffer::append
+    constexpr std::array<SizeClass, 5> SizeClasses =
+    { {
+        { 0x200,    128, 1024 },
+        { 0x1000,    64,  256 },
+        { 0x4000,    32,  128 },
+        { 0x10000,    8,   32 },
+        { 0x80000,    2,    8 }
+    } };
+
+    constexpr std::size_t MAX_POOLED_CAPACITY = SizeClasses.back().Capacity * 2;
+
+    typedef std::vector<std::vector<uint8>> BufferList;
+
+    // smallest class that can hold the requested capacity
+    std::size_t GetAcquireClass(std::size_t capacity)
+    {
+        for (std::size_t i = 0; i < SizeClasses.size(); ++i)
+            if (capacity <= SizeClasses[i].Capacity)
+                return i;
+
+        return SizeClasses.size();
+    }
+
+    // largest class whose requests the buffer can serve
+    std::size_t GetReleaseClass(std::size_t capacity)
+    {
+        if (capacity > MAX_POOLED_CAPACITY)
+            return SizeClasses.size();
+
+        for (std::size_t i = SizeClasses.size(); i > 0; --i)
+            if (capacity >= SizeClasses[i - 1].Capacity)
+                return i - 1;
+
+        return SizeClasses.size();
+    }
+
+    struct Depot
+    {
+        std::mutex Lock;
+        std::array<BufferList, SizeClasses.size()> Buffers;
+    };
+
+    Depot& GetDepot()
+    {
+        static Depot depot;
+        return depot;
+    }
+
+    std::atomic<uint64> Hits(0);
+    std::atomic<uint64> Misses(0);
+    std::atomic<uint64> Recycled(0);
+    std::atomic<uint64> Discarded(0);
+
+    // buffers can still be released by objects destroyed after the thread cache, those are simply freed
+    thread_local bool ThreadCacheDestroyed = false;
+
+    struct ThreadCache
+    {
+        ThreadCache()
+        {
+            for (std::size_t i = 0; i < SizeClasses.size(); ++i)
+                Buffers[i].reserve(SizeClasses[i].ThreadCacheSize);
+        }
+
+        ~ThreadCache() { ThreadCacheDestroyed = true; }
+
+        std::array<BufferList, SizeClasses.size()> Buffers;
+
+        bool Refill(std::size_t sizeClass)
+        {
+            Depot& depot = GetDepot();
+            BufferList& local = Buffers[sizeClass];
+
+            std::lock_guard<std::mutex> lock(depot.Lock);
+            BufferList& shared = depot.Buffers[sizeClass];
+            std::size_t count = std::min(shared.size(), std::max<std::size_t>(SizeClasses[sizeClass].ThreadCacheSize / 2, 1));
+            std::move(shared.end() - count, shared.end(), std::back_inserter(local));
+            shared.erase(shared.end() - count, shared.end());
+            return count != 0;
+        }
+
+        void Flush(std::size_t sizeClass)
+        {
+            Depot& depot = GetDepot();
+            BufferList& local = Buffers[sizeClass];
+            std::size_t count = std::max<std::size_t>(local.size() / 2, 1);
+            std::size_t discarded = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(depot.Lock);
+                BufferList& shared = depot.Buffers[sizeClass];
+                std::size_t accepted = std::min(count, SizeClasses[sizeClass].DepotSize - std::min(shared.size(), SizeClasses[sizeClass].DepotSize));
+                std::move(local.end() - accepted, local.end(), std::back_inserter(shared));
+                local.erase(local.end() - accepted, local.end());
+                discarded = count - accepted;
+            }
+
+            if (discarded)
+            {
+                local.erase(local.end() - discarded, local.end());
+                Discarded.fetch_add(discarded, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    thread_local ThreadCache Cache;
+}
+
+std::vector<uint8> Trinity::BufferPool::Acquire(std::size_t capacity)
+{
+    std::vector<uint8> storage;
+    if (!capacity)
+        return storage;
+
+    std::size_t sizeClass = GetAcquireClass(capacity);
+    if (sizeClass < SizeClasses.size() && !ThreadCacheDestroyed)
+    {
+        BufferList& local = Cache.Buffers[sizeClass];
+        if (!local.empty() || Cache.Refill(sizeClass))
+        {
+            storage = std::move(local.back());
+            local.pop_back();
+            Hits.fetch_add(1, std::memory_order_relaxed);
+            return storage;
+        }
+    }
+
+    Misses.fetch_add(1, std::memory_order_relaxed);
+    storage.reserve(sizeClass < SizeClasses.size() ? SizeClasses[sizeClass].Capacity : capacity);
+    return storage;
+}
+
+void Trinity::BufferPool::Release(std::vector<uint8>& storage)
+{
+    if (!storage.capacity())
+        return;
+
+    std::size_t sizeClass = GetReleaseClass(storage.capacity());
+    if (sizeClass >= SizeClasses.size() || ThreadCacheDestroyed)
+    {
+        std::vector<uint8>().swap(storage);
+        Discarded.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    BufferList& local = Cache.Buffers[sizeClass];
+    if (local.size() >= SizeClasses[sizeClass].ThreadCacheSize)
+        Cache.Flush(sizeClass);
+
+    storage.clear();
+    local.push_back(std::move(storage));
+    storage = std::vector<uint8>();
+    Recycled.fetch_add(1, std::memory_order_relaxed);
+}
+
+Trinity::BufferPoolStats Trinity::BufferPool::GetStats()
+{
+    BufferPoolStats stats;
+    stats.Hits = Hits.load(std::memory_order_relaxed);
+    stats.Misses = Misses.load(std::memory_order_relaxed);
+    stats.Recycled = Recycled.load(std::memory_order_relaxed);
+    stats.Discarded = Discarded.load(std::memory_order_relaxed);
+    return stats;
+}
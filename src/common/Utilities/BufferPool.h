@@ -0,0 +1,55 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITYCORE_BUFFER_POOL_H
+#define TRINITYCORE_BUFFER_POOL_H
+
+#include "Define.h"
+#include <vector>
+
+namespace Trinity
+{
+    struct BufferPoolStats
+    {
+        uint64 Hits = 0;        // requests served with a recycled buffer
+        uint64 Misses = 0;      // requests that had to allocate
+        uint64 Recycled = 0;    // buffers returned to the pool
+        uint64 Discarded = 0;   // buffers freed because the pool was full or they did not fit any size class
+    };
+
+    /**
+     * Size classed pool of byte vectors backing packet and socket buffers.
+     *
+     * Every thread keeps a small cache per size class and exchanges buffers in batches
+     * with a shared depot, so packets built on map threads and released by network threads
+     * keep circulating without going through the global allocator.
+     */
+    class TC_COMMON_API BufferPool
+    {
+    public:
+        /// Returns an empty vector with at least the requested capacity, the capacity is rounded up to the size class
+        static std::vector<uint8> Acquire(std::size_t capacity);
+
+        /// Takes the storage of given vector back into the pool, leaving it empty
+        static void Release(std::vector<uint8>& storage);
+
+        static BufferPoolStats GetStats();
+    };
+}
+
+#endif // TRINITYCORE_BUFFER_POOL_H
@@ -19,6 +19,7 @@
 #define __MESSAGEBUFFER_H_
 
 #include "Define.h"
+#include "BufferPool.h"
 #include <vector>
 #include <cstring>
 
@@ -27,22 +28,31 @@ class MessageBuffer
     typedef std::vector<uint8>::size_type size_type;
 
 public:
-    MessageBuffer() : _wpos(0), _rpos(0), _storage()
+    MessageBuffer() : _wpos(0), _rpos(0), _storage(Trinity::BufferPool::Acquire(4096))
     {
         _storage.resize(4096);
     }
 
-    explicit MessageBuffer(std::size_t initialSize) : _wpos(0), _rpos(0), _storage()
+    explicit MessageBuffer(std::size_t initialSize) : _wpos(0), _rpos(0), _storage(Trinity::BufferPool::Acquire(initialSize))
     {
         _storage.resize(initialSize);
     }
 
-    MessageBuffer(MessageBuffer const& right) : _wpos(right._wpos), _rpos(right._rpos), _storage(right._storage)
+    MessageBuffer(MessageBuffer const& right) : _wpos(right._wpos), _rpos(right._rpos), _storage(Trinity::BufferPool::Acquire(right._storage.size()))
     {
+        _storage.assign(right._storage.begin(), right._storage.end());
     }
 
     MessageBuffer(MessageBuffer&& right) : _wpos(right._wpos), _rpos(right._rpos), _storage(right.Move()) { }
 
+    // takes over already written data
+    explicit MessageBuffer(std::vector<uint8>&& storage) : _wpos(storage.size()), _rpos(0), _storage(std::move(storage)) { }
+
+    ~MessageBuffer()
+    {
+        Trinity::BufferPool::Release(_storage);
+    }
+
     void Reset()
     {
         _wpos = 0;
@@ -51,6 +61,10 @@ public:
 
     void Resize(size_type bytes)
     {
+        // storage was moved out, take a recycled one instead of growing from nothing
+        if (!_storage.capacity())
+            _storage = Trinity::BufferPool::Acquire(bytes);
+
         _storage.resize(bytes);
     }
 
@@ -124,6 +138,7 @@ public:
         {
             _wpos = right._wpos;
             _rpos = right._rpos;
+            Trinity::BufferPool::Release(_storage);
             _storage = right.Move();
         }
 
@@ -0,0 +1,217 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ObjectPool.h"
+#include "Errors.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+namespace
+{
+    constexpr std::size_t SLAB_OBJECTS = 64;        // blocks carved from the global allocator at once
+    constexpr std::size_t THREAD_CACHE_SIZE = 128;  // free blocks a thread keeps per pool before handing half of them to the depot
+    constexpr std::size_t REFILL_BATCH = 32;        // free blocks a thread takes from the depot at once
+
+    struct Registry
+    {
+        std::mutex Lock;
+        std::array<Trinity::ObjectPool*, Trinity::ObjectPool::MAX_POOLS> Pools = { };
+        std::size_t Count = 0;
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    // objects can still be freed after the thread cache is gone, those go straight to the depot
+    thread_local bool ThreadCacheDestroyed = false;
+}
+
+namespace Trinity
+{
+    struct ObjectPoolThreadCache
+    {
+        ~ObjectPoolThreadCache()
+        {
+            ThreadCacheDestroyed = true;
+            Registry& registry = GetRegistry();
+            for (std::size_t i = 0; i < ObjectPool::MAX_POOLS; ++i)
+                if (!FreeLists[i].empty() && registry.Pools[i])
+                    registry.Pools[i]->Flush(FreeLists[i], FreeLists[i].size());
+        }
+
+        std::array<std::vector<void*>, ObjectPool::MAX_POOLS> FreeLists;
+    };
+}
+
+namespace
+{
+    thread_local Trinity::ObjectPoolThreadCache Cache;
+}
+
+std::size_t Trinity::ObjectPoolStats::GetReservedBytes() const
+{
+    return Slabs * SLAB_OBJECTS * ObjectSize;
+}
+
+Trinity::ObjectPool::ObjectPool(char const* name, std::size_t objectSize) : _name(name),
+    _objectSize((objectSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+    _allocated(0), _freed(0), _oversized(0)
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Lock);
+    ASSERT(registry.Count < MAX_POOLS, "Too many object pools, raise ObjectPool::MAX_POOLS");
+    _index = registry.Count++;
+    registry.Pools[_index] = this;
+}
+
+Trinity::ObjectPool::~ObjectPool()
+{
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Lock);
+        registry.Pools[_index] = nullptr;
+    }
+
+    for (void* slab : _slabs)
+        ::operator delete(slab);
+}
+
+void* Trinity::ObjectPool::Allocate(std::size_t size)
+{
+    _allocated.fetch_add(1, std::memory_order_relaxed);
+    if (size > _objectSize)
+    {
+        _oversized.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    if (ThreadCacheDestroyed)
+        return AllocateShared();
+
+    std::vector<void*>& local = Cache.FreeLists[_index];
+    if (local.empty())
+        Refill(local);
+
+    void* ptr = local.back();
+    local.pop_back();
+    return ptr;
+}
+
+void Trinity::ObjectPool::Deallocate(void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    _freed.fetch_add(1, std::memory_order_relaxed);
+    if (size > _objectSize)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    if (ThreadCacheDestroyed)
+    {
+        DeallocateShared(ptr);
+        return;
+    }
+
+    std::vector<void*>& local = Cache.FreeLists[_index];
+    if (local.size() >= THREAD_CACHE_SIZE)
+        Flush(local, local.size() / 2);
+
+    local.push_back(ptr);
+}
+
+void* Trinity::ObjectPool::AllocateShared()
+{
+    std::lock_guard<std::mutex> lock(_depotLock);
+    if (_depot.empty())
+        CarveSlab(_depot);
+
+    void* ptr = _depot.back();
+    _depot.pop_back();
+    return ptr;
+}
+
+void Trinity::ObjectPool::DeallocateShared(void* ptr)
+{
+    std::lock_guard<std::mutex> lock(_depotLock);
+    _depot.push_back(ptr);
+}
+
+void Trinity::ObjectPool::Refill(std::vector<void*>& local)
+{
+    std::lock_guard<std::mutex> lock(_depotLock);
+    std::size_t count = std::min(_depot.size(), REFILL_BATCH);
+    if (!count)
+    {
+        CarveSlab(local);
+        return;
+    }
+
+    std::move(_depot.end() - count, _depot.end(), std::back_inserter(local));
+    _depot.erase(_depot.end() - count, _depot.end());
+}
+
+void Trinity::ObjectPool::CarveSlab(std::vector<void*>& freeList)
+{
+    char* slab = static_cast<char*>(::operator new(_objectSize * SLAB_OBJECTS));
+    _slabs.push_back(slab);
+    freeList.reserve(freeList.size() + SLAB_OBJECTS);
+    // handed out from the back, start with the lowest address
+    for (std::size_t i = SLAB_OBJECTS; i > 0; --i)
+        freeList.push_back(slab + (i - 1) * _objectSize);
+}
+
+void Trinity::ObjectPool::Flush(std::vector<void*>& local, std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(_depotLock);
+    std::move(local.end() - count, local.end(), std::back_inserter(_depot));
+    local.erase(local.end() - count, local.end());
+}
+
+Trinity::ObjectPoolStats Trinity::ObjectPool::GetStats() const
+{
+    ObjectPoolStats stats;
+    stats.Name = _name;
+    stats.ObjectSize = _objectSize;
+    stats.Allocated = _allocated.load(std::memory_order_relaxed);
+    stats.Freed = _freed.load(std::memory_order_relaxed);
+    stats.Oversized = _oversized.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(_depotLock);
+        stats.Slabs = _slabs.size();
+    }
+    return stats;
+}
+
+std::vector<Trinity::ObjectPoolStats> Trinity::ObjectPool::GetAllStats()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Lock);
+    std::vector<ObjectPoolStats> stats;
+    stats.reserve(registry.Count);
+    for (std::size_t i = 0; i < registry.Count; ++i)
+        if (ObjectPool const* pool = registry.Pools[i])
+            stats.push_back(pool->GetStats());
+    return stats;
+}
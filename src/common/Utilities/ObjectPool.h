@@ -0,0 +1,91 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_OBJECT_POOL_H
+#define TRINITYCORE_OBJECT_POOL_H
+
+#include "Define.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Trinity
+{
+    struct ObjectPoolStats
+    {
+        char const* Name = nullptr;
+        std::size_t ObjectSize = 0;
+        uint64 Allocated = 0;   // objects handed out since startup
+        uint64 Freed = 0;       // objects given back since startup
+        uint64 Slabs = 0;       // slabs carved from the global allocator
+        uint64 Oversized = 0;   // requests larger than ObjectSize, served by the global allocator
+
+        uint64 GetLive() const { return Allocated - Freed; }
+        std::size_t GetReservedBytes() const;
+    };
+
+    /**
+     * Slab allocator for the objects of one class hierarchy, meant to back class specific operator new/delete.
+     *
+     * Storage is carved from slabs of fixed size blocks that are never returned to the system.
+     * Every thread keeps a free list per pool and exchanges blocks in batches with a shared depot,
+     * so objects may be freed by a different thread than the one that created them.
+     */
+    class TC_COMMON_API ObjectPool
+    {
+    public:
+        static constexpr std::size_t MAX_POOLS = 16;
+
+        ObjectPool(char const* name, std::size_t objectSize);
+        ~ObjectPool();
+
+        ObjectPool(ObjectPool const&) = delete;
+        ObjectPool& operator=(ObjectPool const&) = delete;
+
+        void* Allocate(std::size_t size);
+        void Deallocate(void* ptr, std::size_t size);
+
+        ObjectPoolStats GetStats() const;
+
+        /// Statistics of every pool created so far
+        static std::vector<ObjectPoolStats> GetAllStats();
+
+    private:
+        friend struct ObjectPoolThreadCache;
+
+        void* AllocateShared();
+        void DeallocateShared(void* ptr);
+        void Refill(std::vector<void*>& local);
+        // caller must hold _depotLock
+        void CarveSlab(std::vector<void*>& freeList);
+        void Flush(std::vector<void*>& local, std::size_t count);
+
+        char const* _name;
+        std::size_t _objectSize;
+        std::size_t _index;
+
+        mutable std::mutex _depotLock;
+        std::vector<void*> _depot;
+        std::vector<void*> _slabs;
+
+        std::atomic<uint64> _allocated;
+        std::atomic<uint64> _freed;
+        std::atomic<uint64> _oversized;
+    };
+}
+
+#endif // TRINITYCORE_OBJECT_POOL_H
@@ -20,12 +20,15 @@
 
 #include "Define.h"
 #include "Duration.h"
+#include "Types.h"
 #include <array>
 #include <string>
 #include <string_view>
 #include <vector>
 
 class BaseDatabaseResultValueConverter;
+template<typename... Columns>
+class QueryResultRowDecoder;
 
 enum class DatabaseFieldTypes : uint8
 {
@@ -92,6 +95,8 @@ class TC_DATABASE_API Field
 {
     friend class ResultSet;
     friend class PreparedResultSet;
+    template<typename... Columns>
+    friend class QueryResultRowDecoder;
 
     public:
         Field();
@@ -125,6 +130,46 @@ class TC_DATABASE_API Field
             return buf;
         }
 
+        /// Same as the matching Get* function, selected at compile time
+        template<typename T>
+        T Get() const
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return GetBool();
+            else if constexpr (std::is_same_v<T, uint8>)
+                return GetUInt8();
+            else if constexpr (std::is_same_v<T, int8>)
+                return GetInt8();
+            else if constexpr (std::is_same_v<T, uint16>)
+                return GetUInt16();
+            else if constexpr (std::is_same_v<T, int16>)
+                return GetInt16();
+            else if constexpr (std::is_same_v<T, uint32>)
+                return GetUInt32();
+            else if constexpr (std::is_same_v<T, int32>)
+                return GetInt32();
+            else if constexpr (std::is_same_v<T, uint64>)
+                return GetUInt64();
+            else if constexpr (std::is_same_v<T, int64>)
+                return GetInt64();
+            else if constexpr (std::is_same_v<T, float>)
+                return GetFloat();
+            else if constexpr (std::is_same_v<T, double>)
+                return GetDouble();
+            else if constexpr (std::is_same_v<T, SystemTimePoint>)
+                return GetDate();
+            else if constexpr (std::is_same_v<T, char const*>)
+                return GetCString();
+            else if constexpr (std::is_same_v<T, std::string>)
+                return GetString();
+            else if constexpr (std::is_same_v<T, std::string_view>)
+                return GetStringView();
+            else if constexpr (std::is_same_v<T, std::vector<uint8>>)
+                return GetBinary();
+            else
+                static_assert(Trinity::dependant_false_v<T>, "Unsupported type used for Field::Get");
+        }
+
         bool IsNull() const
         {
             return _value == nullptr;
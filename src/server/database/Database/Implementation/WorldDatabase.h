@@ -32,7 +32,6 @@ enum WorldDatabaseStatements : uint32
     WORLD_DEL_LINKED_RESPAWN_MASTER,
     WORLD_REP_LINKED_RESPAWN,
     WORLD_SEL_CREATURE_TEXT,
-    WORLD_SEL_SMART_SCRIPTS,
     WORLD_SEL_SMARTAI_WP,
     WORLD_DEL_GAMEOBJECT,
     WORLD_DEL_EVENT_GAMEOBJECT,
@@ -20,8 +20,145 @@
 
 #include "Define.h"
 #include "DatabaseEnvFwd.h"
+#include "Errors.h"
+#include "Field.h"
+#include "StringConvert.h"
+#include <array>
+#include <cstring>
+#include <tuple>
 #include <vector>
 
+namespace Trinity::Impl
+{
+    // column type whose buffered value has exactly the layout of T, Null if T always needs a conversion
+    template<typename T>
+    constexpr DatabaseFieldTypes QueryResultColumnType()
+    {
+        if constexpr (std::is_same_v<T, uint8>)
+            return DatabaseFieldTypes::UInt8;
+        else if constexpr (std::is_same_v<T, int8>)
+            return DatabaseFieldTypes::Int8;
+        else if constexpr (std::is_same_v<T, uint16>)
+            return DatabaseFieldTypes::UInt16;
+        else if constexpr (std::is_same_v<T, int16>)
+            return DatabaseFieldTypes::Int16;
+        else if constexpr (std::is_same_v<T, uint32>)
+            return DatabaseFieldTypes::UInt32;
+        else if constexpr (std::is_same_v<T, int32>)
+            return DatabaseFieldTypes::Int32;
+        else if constexpr (std::is_same_v<T, uint64>)
+            return DatabaseFieldTypes::UInt64;
+        else if constexpr (std::is_same_v<T, int64>)
+            return DatabaseFieldTypes::Int64;
+        else if constexpr (std::is_same_v<T, float>)
+            return DatabaseFieldTypes::Float;
+        else if constexpr (std::is_same_v<T, double>)
+            return DatabaseFieldTypes::Double;
+        else if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+            return DatabaseFieldTypes::Binary;
+        else
+            return DatabaseFieldTypes::Null;
+    }
+}
+
+/**
+    @class QueryResultRowDecoder
+
+    @brief Decodes rows of a query result into std::tuple<Columns...>
+
+    Column types are matched against the result metadata once, columns whose MySQL type is exactly the requested one
+    are read straight from the buffered row without going through the virtual value converters.
+    Every other column is decoded by Field::Get<T>, with the same conversions and truncation checks as before.
+*/
+template<typename... Columns>
+class QueryResultRowDecoder
+{
+    public:
+        using Row = std::tuple<Columns...>;
+
+        template<typename Result>
+        QueryResultRowDecoder(Result const& result, bool binaryProtocol) : _binaryProtocol(binaryProtocol)
+        {
+            ASSERT(result.GetFieldCount() == sizeof...(Columns), "Query returned %u columns, %zu were expected", result.GetFieldCount(), sizeof...(Columns));
+
+            constexpr DatabaseFieldTypes columnTypes[] = { Trinity::Impl::QueryResultColumnType<Columns>()... };
+            for (std::size_t i = 0; i < sizeof...(Columns); ++i)
+                _direct[i] = columnTypes[i] != DatabaseFieldTypes::Null && result.GetFieldMetadata(i).Type == columnTypes[i];
+        }
+
+        Row Decode(Field const* fields) const
+        {
+            return Decode(fields, std::index_sequence_for<Columns...>());
+        }
+
+    private:
+        template<std::size_t... Indexes>
+        Row Decode(Field const* fields, std::index_sequence<Indexes...>) const
+        {
+            return Row(DecodeField<Columns>(fields[Indexes], _direct[Indexes])...);
+        }
+
+        template<typename T>
+        T DecodeField(Field const& field, bool direct) const
+        {
+            if constexpr (Trinity::Impl::QueryResultColumnType<T>() == DatabaseFieldTypes::Null)
+                return field.Get<T>();
+            else if (!direct)
+                return field.Get<T>();
+            else if (!field._value)
+                return T();
+            else if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+                return T(field._value, field._length);
+            else if (_binaryProtocol)
+            {
+                T value;
+                std::memcpy(&value, field._value, sizeof(T));
+                return value;
+            }
+            else
+                return Trinity::StringTo<T>({ field._value, field._length }).value_or(T());
+        }
+
+        std::array<bool, sizeof...(Columns)> _direct;
+        bool _binaryProtocol;
+};
+
+/// Single pass range over the rows of a result starting at the current one, advancing it with NextRow
+template<typename Result, typename... Columns>
+class QueryResultRows
+{
+    public:
+        class iterator
+        {
+            public:
+                iterator(Result* result, QueryResultRowDecoder<Columns...> const* decoder) : _result(result), _decoder(decoder) { }
+
+                std::tuple<Columns...> operator*() const { return _decoder->Decode(_result->Fetch()); }
+
+                iterator& operator++()
+                {
+                    if (!_result->NextRow())
+                        _result = nullptr;
+                    return *this;
+                }
+
+                bool operator==(iterator const& right) const { return _result == right._result; }
+
+            private:
+                Result* _result;
+                QueryResultRowDecoder<Columns...> const* _decoder;
+        };
+
+        QueryResultRows(Result& result, bool binaryProtocol) : _result(&result), _decoder(result, binaryProtocol) { }
+
+        iterator begin() const { return iterator(_result->GetRowCount() ? _result : nullptr, &_decoder); }
+        iterator end() const { return iterator(nullptr, &_decoder); }
+
+    private:
+        Result* _result;
+        QueryResultRowDecoder<Columns...> _decoder;
+};
+
 class TC_DATABASE_API ResultSet
 {
     public:
@@ -38,6 +175,11 @@ class TC_DATABASE_API ResultSet
 
         QueryResultFieldMetadata const& GetFieldMetadata(std::size_t index) const;
 
+        /// Typed rows from the current one to the end of the result
+        /// for (auto [guid, entry, name] : result->Rows<uint32, uint32, std::string_view>())
+        template<typename... Columns>
+        QueryResultRows<ResultSet, Columns...> Rows() { return { *this, false }; }
+
     protected:
         std::vector<QueryResultFieldMetadata> _fieldMetadata;
         uint64 _rowCount;
@@ -68,6 +210,10 @@ class TC_DATABASE_API PreparedResultSet
 
         QueryResultFieldMetadata const& GetFieldMetadata(std::size_t index) const;
 
+        /// Typed rows from the current one to the end of the result, see ResultSet::Rows
+        template<typename... Columns>
+        QueryResultRows<PreparedResultSet, Columns...> Rows() { return { *this, true }; }
+
     protected:
         std::vector<QueryResultFieldMetadata> m_fieldMetadata;
         std::vector<Field> m_rows;
@@ -381,7 +381,7 @@ SpellInfo const* ScriptedAI::SelectSpell(Unit* target, uint32 school, uint32 mec
 
 void ScriptedAI::DoTeleportTo(float x, float y, float z, uint32 time)
 {
-    me->Relocate(x, y, z);
+    me->GetMap()->CreatureRelocation(me, x, y, z, me->GetOrientation());
     float speed = me->GetDistance(x, y, z) / ((float)time * 0.001f);
     me->MonsterMoveWithSpeed(x, y, z, speed);
 }
@@ -876,7 +876,7 @@ void SmartAI::StopFollow(bool complete)
     GetScript()->ProcessEventsFor(SMART_EVENT_FOLLOW_COMPLETED, player);
 }
 
-void SmartAI::SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* invoker)
+void SmartAI::SetTimedActionList(SmartScriptHolder const& e, uint32 entry, Unit* invoker)
 {
     GetScript()->SetTimedActionList(e, entry, invoker);
 }
@@ -1085,7 +1085,7 @@ void SmartGameObjectAI::SetData(uint32 id, uint32 value, Unit* invoker)
     GetScript()->ProcessEventsFor(SMART_EVENT_DATA_SET, invoker, id, value);
 }
 
-void SmartGameObjectAI::SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* invoker)
+void SmartGameObjectAI::SetTimedActionList(SmartScriptHolder const& e, uint32 entry, Unit* invoker)
 {
     GetScript()->SetTimedActionList(e, entry, invoker);
 }
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SmartEventStats.h"
+#include <algorithm>
+
+SmartEventStats* SmartEventStats::instance()
+{
+    static SmartEventStats instance;
+    return &instance;
+}
+
+void SmartEventStats::Record(SMART_EVENT e, uint32 handlers, std::chrono::steady_clock::duration elapsed)
+{
+    if (e >= SMART_EVENT_END)
+        return;
+
+    uint64 nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    Counters& counters = _counters[e];
+    counters.Count.fetch_add(1, std::memory_order_relaxed);
+    counters.Handlers.fetch_add(handlers, std::memory_order_relaxed);
+    counters.TotalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    uint64 max = counters.MaxNanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !counters.MaxNanoseconds.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+        ;
+}
+
+std::vector<SmartEventStats::Entry> SmartEventStats::GetMostExpensive(std::size_t count) const
+{
+    std::vector<Entry> entries;
+    for (std::size_t e = 0; e < SMART_EVENT_END; ++e)
+    {
+        Counters const& counters = _counters[e];
+        if (!counters.Count.load(std::memory_order_relaxed))
+            continue;
+
+        Entry& entry = entries.emplace_back();
+        entry.Event = SMART_EVENT(e);
+        entry.Count = counters.Count.load(std::memory_order_relaxed);
+        entry.Handlers = counters.Handlers.load(std::memory_order_relaxed);
+        entry.TotalNanoseconds = counters.TotalNanoseconds.load(std::memory_order_relaxed);
+        entry.MaxNanoseconds = counters.MaxNanoseconds.load(std::memory_order_relaxed);
+    }
+
+    std::size_t resultSize = std::min(count, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + resultSize, entries.end(), [](Entry const& left, Entry const& right)
+    {
+        return left.TotalNanoseconds > right.TotalNanoseconds;
+    });
+    entries.resize(resultSize);
+    return entries;
+}
+
+void SmartEventStats::Reset()
+{
+    for (Counters& counters : _counters)
+    {
+        counters.Count.store(0, std::memory_order_relaxed);
+        counters.Handlers.store(0, std::memory_order_relaxed);
+        counters.TotalNanoseconds.store(0, std::memory_order_relaxed);
+        counters.MaxNanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
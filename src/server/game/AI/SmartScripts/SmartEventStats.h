@@ -0,0 +1,72 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SMARTEVENTSTATS_H
+#define TRINITY_SMARTEVENTSTATS_H
+
+#include "Define.h"
+#include "SmartScriptMgr.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/// Per SMART_EVENT counters of SmartScript event dispatch, used to find the event types that dominate SAI processing time
+class TC_GAME_API SmartEventStats
+{
+    public:
+        struct Entry
+        {
+            SMART_EVENT Event = SMART_EVENT_UPDATE_IC;
+            uint64 Count = 0;               // dispatches that had at least one handler of this event type
+            uint64 Handlers = 0;            // handlers that passed their conditions and were processed
+            uint64 TotalNanoseconds = 0;    // includes events fired by the handlers themselves
+            uint64 MaxNanoseconds = 0;
+        };
+
+        static SmartEventStats* instance();
+
+        /// Collection is off by default, timing every dispatch is not free
+        bool IsEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+        void SetEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+
+        void Record(SMART_EVENT e, uint32 handlers, std::chrono::steady_clock::duration elapsed);
+
+        /// Event types with the highest total processing time, most expensive first
+        std::vector<Entry> GetMostExpensive(std::size_t count) const;
+
+        void Reset();
+
+    private:
+        SmartEventStats() = default;
+        ~SmartEventStats() = default;
+
+        struct Counters
+        {
+            std::atomic<uint64> Count;
+            std::atomic<uint64> Handlers;
+            std::atomic<uint64> TotalNanoseconds;
+            std::atomic<uint64> MaxNanoseconds;
+        };
+
+        std::atomic<bool> _enabled = false;
+        std::array<Counters, SMART_EVENT_END> _counters = { };
+};
+
+#define sSmartEventStats SmartEventStats::instance()
+
+#endif
@@ -18,6 +18,7 @@
 #include "SmartScript.h"
 #include "CellImpl.h"
 #include "ChatTextBuilder.h"
+#include "ConditionMgr.h"
 #include "Containers.h"
 #include "Creature.h"
 #include "CreatureTextMgr.h"
@@ -36,6 +37,7 @@
 #include "ObjectMgr.h"
 #include "Random.h"
 #include "SmartAI.h"
+#include "SmartEventStats.h"
 #include "SpellAuras.h"
 #include "SpellMgr.h"
 #include "TemporarySummon.h"
@@ -61,6 +63,9 @@ SmartScript::SmartScript()
     mEventSortingRequired = false;
     mNestedEventsCounter = 0;
     mAllEventFlags = 0;
+    mEventBucketOffsets.fill(0);
+    mEventBucketsDirty = true;
+    mEventBucketsConditionGeneration = 0;
 }
 
 SmartScript::~SmartScript()
@@ -179,17 +184,17 @@ Creature* SmartScript::FindCreatureNear(WorldObject* searchObject, ObjectGuid::L
 void SmartScript::OnReset()
 {
     ResetBaseObject();
-    for (SmartScriptHolder& event : mEvents)
+    for (SmartScriptEventState& event : mEvents)
     {
-        if (!(event.event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
+        if (!(event.Holder->event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
         {
             InitTimer(event);
             event.runOnce = false;
         }
 
-        if (event.priority != SmartScriptHolder::DEFAULT_PRIORITY)
+        if (event.priority != SmartScriptEventState::DEFAULT_PRIORITY)
         {
-            event.priority = SmartScriptHolder::DEFAULT_PRIORITY;
+            event.priority = SmartScriptEventState::DEFAULT_PRIORITY;
             mEventSortingRequired = true;
         }
     }
@@ -236,36 +241,58 @@ void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint3
     {
         TC_LOG_WARN("scripts.ai", "SmartScript::ProcessEventsFor: reached the limit of max allowed nested ProcessEventsFor() calls with event {}, skipping!\n{}", e, GetBaseObject()->GetDebugInfo());
     }
-    else
+    else if (e < SMART_EVENT_END)
     {
-        for (SmartScriptHolder& event : mEvents)
+        // only the outermost dispatch regroups the events, so the bucket ranges stay put while handlers fire nested events
+        if (mNestedEventsCounter == 1)
+            UpdateEventBuckets();
+
+        uint32 begin = mEventBucketOffsets[e];
+        uint32 end = mEventBucketOffsets[e + 1];
+        if (begin != end)
         {
-            SMART_EVENT eventType = SMART_EVENT(event.GetEventType());
-            if (eventType == SMART_EVENT_LINK)//special handling
-                continue;
+            bool recordStats = sSmartEventStats->IsEnabled();
+            std::chrono::steady_clock::time_point start;
+            if (recordStats)
+                start = std::chrono::steady_clock::now();
+
+            uint32 handlers = 0;
+            for (uint32 i = begin; i < end; ++i)
+            {
+                EventBucketEntry const entry = mEventBuckets[i];
+                if (entry.Conditions)
+                {
+                    ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+                    if (!sConditionMgr->IsObjectMeetToConditions(sourceInfo, *entry.Conditions))
+                        continue;
+                }
+
+                ++handlers;
+                ProcessEvent(mEvents[entry.Index], unit, var0, var1, bvar, spell, gob);
+            }
 
-            if (eventType == e)
-                if (sConditionMgr->IsObjectMeetingSmartEventConditions(event.entryOrGuid, event.event_id, event.source_type, unit, GetBaseObject()))
-                    ProcessEvent(event, unit, var0, var1, bvar, spell, gob);
+            if (recordStats)
+                sSmartEventStats->Record(e, handlers, std::chrono::steady_clock::now() - start);
         }
     }
 
     --mNestedEventsCounter;
 }
 
-void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
+void SmartScript::ProcessAction(SmartScriptEventState& state, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
-    e.runOnce = true; //used for repeat check
+    SmartScriptHolder const& e = *state.Holder;
+    state.runOnce = true; //used for repeat check
 
     // calc random
-    if (e.GetEventType() != SMART_EVENT_LINK && e.event.event_chance < 100 && e.event.event_chance && !(e.event.event_flags & SMART_EVENT_FLAG_TEMP_IGNORE_CHANCE_ROLL))
+    if (e.GetEventType() != SMART_EVENT_LINK && e.event.event_chance < 100 && e.event.event_chance && !state.ignoreChanceRoll)
     {
         if (!roll_chance_i(e.event.event_chance))
             return;
     }
 
-    // Remove SMART_EVENT_FLAG_TEMP_IGNORE_CHANCE_ROLL flag after processing roll chances as it's not needed anymore
-    e.event.event_flags &= ~SMART_EVENT_FLAG_TEMP_IGNORE_CHANCE_ROLL;
+    // Clear ignoreChanceRoll after processing roll chances as it's not needed anymore
+    state.ignoreChanceRoll = false;
 
     if (unit)
         mLastInvoker = unit->GetGUID();
@@ -615,7 +642,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             // If there is at least 1 failed cast and no successful casts at all, retry again on next loop
             if (failedSpellCast && !successfulSpellCast)
             {
-                RetryLater(e, true);
+                RetryLater(state, true);
                 // Don't execute linked events
                 return;
             }
@@ -1551,8 +1578,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             ev.event_id = e.action.timeEvent.id;
             ev.target = e.target;
             ev.action = ac;
-            InitTimer(ev);
-            mStoredEvents.push_back(ev);
+            InitTimer(mStoredEvents.emplace_back(ev).State);
             break;
         }
         case SMART_ACTION_TRIGGER_TIMED_EVENT:
@@ -2103,8 +2129,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 ev.event_id = e.event_id;
                 ev.target = e.target;
                 ev.action = ac;
-                InitTimer(ev);
-                mStoredEvents.push_back(ev);
+                InitTimer(mStoredEvents.emplace_back(ev).State);
             }
             break;
         }
@@ -2145,8 +2170,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 ev.event_id = e.event_id;
                 ev.target = e.target;
                 ev.action = ac;
-                InitTimer(ev);
-                mStoredEvents.push_back(ev);
+                InitTimer(mStoredEvents.emplace_back(ev).State);
             }
             break;
         }
@@ -2330,24 +2354,26 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
     if (e.link && e.link != e.event_id)
     {
-        SmartScriptHolder& linked = SmartAIMgr::FindLinkedEvent(mEvents, e.link);
-        if (linked)
-            ProcessEvent(linked, unit, var0, var1, bvar, spell, gob);
+        if (SmartScriptEventState* linked = FindLinkedEvent(e.link))
+            ProcessEvent(*linked, unit, var0, var1, bvar, spell, gob);
         else
             TC_LOG_DEBUG("sql.sql", "SmartScript::ProcessAction: Entry {} SourceType {}, Event {}, Link Event {} not found or invalid, skipped.", e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
     }
 }
 
-void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
+void SmartScript::ProcessTimedAction(SmartScriptEventState& state, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
+    SmartScriptHolder const& e = *state.Holder;
     // We may want to execute action rarely and because of this if condition is not fulfilled the action will be rechecked in a long time
-    if (sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject()))
+    ConditionContainer const* conditions = GetEventConditions(state);
+    ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+    if (!conditions || sConditionMgr->IsObjectMeetToConditions(sourceInfo, *conditions))
     {
-        RecalcTimer(e, min, max);
-        ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+        RecalcTimer(state, min, max);
+        ProcessAction(state, unit, var0, var1, bvar, spell, gob);
     }
     else
-        RecalcTimer(e, std::min<uint32>(min, 5000), std::min<uint32>(min, 5000));
+        RecalcTimer(state, std::min<uint32>(min, 5000), std::min<uint32>(min, 5000));
 }
 
 SmartScriptHolder SmartScript::CreateSmartEvent(SMART_EVENT e, uint32 event_flags, uint32 event_param1, uint32 event_param2, uint32 event_param3, uint32 event_param4, uint32 event_param5, SMART_ACTION action, uint32 action_param1, uint32 action_param2, uint32 action_param3, uint32 action_param4, uint32 action_param5, uint32 action_param6, SMARTAI_TARGETS t, uint32 target_param1, uint32 target_param2, uint32 target_param3, uint32 target_param4, uint32 phaseMask)
@@ -2378,7 +2404,6 @@ SmartScriptHolder SmartScript::CreateSmartEvent(SMART_EVENT e, uint32 event_flag
     script.target.raw.param4 = target_param4;
 
     script.source_type = SMART_SCRIPT_TYPE_CREATURE;
-    InitTimer(script);
     return script;
 }
 
@@ -2754,12 +2779,13 @@ void SmartScript::GetWorldObjectsInDist(ObjectVector& targets, float dist) const
     Cell::VisitAllObjects(obj, searcher, dist);
 }
 
-void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
+void SmartScript::ProcessEvent(SmartScriptEventState& state, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
-    if (!e.active && e.GetEventType() != SMART_EVENT_LINK)
+    SmartScriptHolder const& e = *state.Holder;
+    if (!state.active && e.GetEventType() != SMART_EVENT_LINK)
         return;
 
-    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && e.runOnce))
+    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && state.runOnce))
         return;
 
     if (!(e.event.event_flags & SMART_EVENT_FLAG_WHILE_CHARMED) && IsCharmedCreature(me))
@@ -2768,21 +2794,21 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
     switch (e.GetEventType())
     {
         case SMART_EVENT_LINK://special handling
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         //called from Update tick
         case SMART_EVENT_UPDATE:
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_UPDATE_OOC:
             if (me && me->IsEngaged())
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_UPDATE_IC:
             if (!me || !me->IsEngaged())
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         case SMART_EVENT_HEALTH_PCT:
         {
@@ -2791,7 +2817,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = (uint32)me->GetHealthPct();
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_MANA_PCT:
@@ -2801,7 +2827,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 perc = uint32(me->GetPowerPct(POWER_MANA));
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_RANGE:
@@ -2810,9 +2836,9 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
 
             if (me->IsInRange(me->GetVictim(), (float)e.event.minMaxRepeat.min, (float)e.event.minMaxRepeat.max))
-                ProcessTimedAction(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
+                ProcessTimedAction(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax, me->GetVictim());
             else // make it predictable
-                RecalcTimer(e, 500, 500);
+                RecalcTimer(state, 500, 500);
             break;
         }
         case SMART_EVENT_VICTIM_CASTING:
@@ -2830,7 +2856,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                     if (currSpell->m_spellInfo->Id != e.event.targetCasting.spellId)
                         return;
 
-            ProcessTimedAction(e, e.event.targetCasting.repeatMin, e.event.targetCasting.repeatMax, me->GetVictim());
+            ProcessTimedAction(state, e.event.targetCasting.repeatMin, e.event.targetCasting.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_FRIENDLY_IS_CC:
@@ -2843,10 +2869,10 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (creatures.empty())
             {
                 // if there are at least two same npcs, they will perform the same action immediately even if this is useless...
-                RecalcTimer(e, 1000, 3000);
+                RecalcTimer(state, 1000, 3000);
                 return;
             }
-            ProcessTimedAction(e, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax, Trinity::Containers::SelectRandomContainerElement(creatures));
+            ProcessTimedAction(state, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax, Trinity::Containers::SelectRandomContainerElement(creatures));
             break;
         }
         case SMART_EVENT_FRIENDLY_MISSING_BUFF:
@@ -2857,7 +2883,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (creatures.empty())
                 return;
 
-            ProcessTimedAction(e, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax, Trinity::Containers::SelectRandomContainerElement(creatures));
+            ProcessTimedAction(state, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax, Trinity::Containers::SelectRandomContainerElement(creatures));
             break;
         }
         case SMART_EVENT_HAS_AURA:
@@ -2866,7 +2892,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             uint32 count = me->GetAuraCount(e.event.aura.spell);
             if ((!e.event.aura.count && !count) || (e.event.aura.count && count >= e.event.aura.count))
-                ProcessTimedAction(e, e.event.aura.repeatMin, e.event.aura.repeatMax);
+                ProcessTimedAction(state, e.event.aura.repeatMin, e.event.aura.repeatMax);
             break;
         }
         case SMART_EVENT_TARGET_BUFFED:
@@ -2876,13 +2902,13 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 count = me->EnsureVictim()->GetAuraCount(e.event.aura.spell);
             if (count < e.event.aura.count)
                 return;
-            ProcessTimedAction(e, e.event.aura.repeatMin, e.event.aura.repeatMax, me->GetVictim());
+            ProcessTimedAction(state, e.event.aura.repeatMin, e.event.aura.repeatMax, me->GetVictim());
             break;
         }
         case SMART_EVENT_CHARMED:
         {
             if (bvar == (e.event.charm.onRemove != 1))
-                ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+                ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         }
         //no params
@@ -2905,7 +2931,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         case SMART_EVENT_FOLLOW_COMPLETED:
         case SMART_EVENT_ON_SPELLCLICK:
         case SMART_EVENT_ON_DESPAWN:
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         case SMART_EVENT_GOSSIP_HELLO:
             switch (e.event.gossipHello.filter)
@@ -2928,13 +2954,13 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                     break;
             }
 
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(state, unit, var0, var1, bvar, spell, gob);
             break;
         case SMART_EVENT_RECEIVE_EMOTE:
             if (e.event.emote.emote == var0)
             {
-                RecalcTimer(e, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
-                ProcessAction(e, unit);
+                RecalcTimer(state, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
+                ProcessAction(state, unit);
             }
             break;
         case SMART_EVENT_KILL:
@@ -2945,8 +2971,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.kill.creature && unit->GetEntry() != e.event.kill.creature)
                 return;
-            RecalcTimer(e, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
-            ProcessAction(e, unit);
+            RecalcTimer(state, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_SPELLHIT_TARGET:
@@ -2957,8 +2983,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if ((!e.event.spellHit.spell || spell->Id == e.event.spellHit.spell) &&
                 (!e.event.spellHit.school || (spell->SchoolMask & e.event.spellHit.school)))
                 {
-                    RecalcTimer(e, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
-                    ProcessAction(e, unit, 0, 0, bvar, spell, gob);
+                    RecalcTimer(state, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
+                    ProcessAction(state, unit, 0, 0, bvar, spell, gob);
                 }
             break;
         }
@@ -2972,8 +2998,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (spell->Id != e.event.spellCast.spell)
                 return;
 
-            RecalcTimer(e, e.event.spellCast.cooldownMin, e.event.spellCast.cooldownMax);
-            ProcessAction(e, nullptr, 0, 0, bvar, spell);
+            RecalcTimer(state, e.event.spellCast.cooldownMin, e.event.spellCast.cooldownMax);
+            ProcessAction(state, nullptr, 0, 0, bvar, spell);
             break;
         }
         case SMART_EVENT_OOC_LOS:
@@ -2994,8 +3020,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 {
                     if (e.event.los.playerOnly && unit->GetTypeId() != TYPEID_PLAYER)
                         return;
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
-                    ProcessAction(e, unit);
+                    RecalcTimer(state, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(state, unit);
                 }
             }
             break;
@@ -3018,8 +3044,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 {
                     if (e.event.los.playerOnly && unit->GetTypeId() != TYPEID_PLAYER)
                         return;
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
-                    ProcessAction(e, unit);
+                    RecalcTimer(state, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(state, unit);
                 }
             }
             break;
@@ -3032,7 +3058,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.respawn.type == SMART_SCRIPT_RESPAWN_CONDITION_AREA && GetBaseObject()->GetZoneId() != e.event.respawn.area)
                 return;
-            ProcessAction(e);
+            ProcessAction(state);
             break;
         }
         case SMART_EVENT_SUMMONED_UNIT:
@@ -3042,8 +3068,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.summoned.creature && unit->GetEntry() != e.event.summoned.creature)
                 return;
-            RecalcTimer(e, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
-            ProcessAction(e, unit);
+            RecalcTimer(state, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_RECEIVE_HEAL:
@@ -3052,22 +3078,22 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (var0 > e.event.minMaxRepeat.max || var0 < e.event.minMaxRepeat.min)
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e, unit);
+            RecalcTimer(state, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_MOVEMENTINFORM:
         {
             if ((e.event.movementInform.type && var0 != e.event.movementInform.type) || (e.event.movementInform.id && var1 != e.event.movementInform.id))
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_TRANSPORT_RELOCATE:
         {
             if (e.event.transportRelocate.pointID && var0 != e.event.transportRelocate.pointID)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_WAYPOINT_REACHED:
@@ -3078,23 +3104,23 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!me || (e.event.waypoint.pointID && var0 != e.event.waypoint.pointID) || (e.event.waypoint.pathID && var1 != e.event.waypoint.pathID))
                 return;
-            ProcessAction(e, unit);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_SUMMON_DESPAWNED:
         {
             if (e.event.summoned.creature && e.event.summoned.creature != var0)
                 return;
-            RecalcTimer(e, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
-            ProcessAction(e, unit, var0);
+            RecalcTimer(state, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_INSTANCE_PLAYER_ENTER:
         {
             if (e.event.instancePlayerEnter.team && var0 != e.event.instancePlayerEnter.team)
                 return;
-            RecalcTimer(e, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
-            ProcessAction(e, unit, var0);
+            RecalcTimer(state, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_ACCEPTED_QUEST:
@@ -3102,37 +3128,37 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.quest.quest && var0 != e.event.quest.quest)
                 return;
-            RecalcTimer(e, e.event.quest.cooldownMin, e.event.quest.cooldownMax);
-            ProcessAction(e, unit, var0);
+            RecalcTimer(state, e.event.quest.cooldownMin, e.event.quest.cooldownMax);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_TRANSPORT_ADDCREATURE:
         {
             if (e.event.transportAddCreature.creature && var0 != e.event.transportAddCreature.creature)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_AREATRIGGER_ONTRIGGER:
         {
             if (e.event.areatrigger.id && var0 != e.event.areatrigger.id)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_TEXT_OVER:
         {
             if (var0 != e.event.textOver.textGroupID || (e.event.textOver.creatureEntry && e.event.textOver.creatureEntry != var1))
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_DATA_SET:
         {
             if (e.event.dataSet.id != var0 || e.event.dataSet.value != var1)
                 return;
-            RecalcTimer(e, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
-            ProcessAction(e, unit, var0, var1);
+            RecalcTimer(state, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_PASSENGER_REMOVED:
@@ -3140,14 +3166,14 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!unit)
                 return;
-            RecalcTimer(e, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
-            ProcessAction(e, unit);
+            RecalcTimer(state, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
+            ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_TIMED_EVENT_TRIGGERED:
         {
             if (e.event.timedEvent.id == var0)
-                ProcessAction(e, unit);
+                ProcessAction(state, unit);
             break;
         }
         case SMART_EVENT_GOSSIP_SELECT:
@@ -3155,7 +3181,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             TC_LOG_DEBUG("scripts.ai", "SmartScript: Gossip Select:  menu {} action {}", var0, var1);//little help for scripters
             if (e.event.gossip.sender != var0 || e.event.gossip.action != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GAME_EVENT_START:
@@ -3163,28 +3189,28 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.gameEvent.gameEventId != var0)
                 return;
-            ProcessAction(e, nullptr, var0);
+            ProcessAction(state, nullptr, var0);
             break;
         }
         case SMART_EVENT_GO_LOOT_STATE_CHANGED:
         {
             if (e.event.goLootStateChanged.lootState != var0)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(state, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GO_EVENT_INFORM:
         {
             if (e.event.eventInform.eventId != var0)
                 return;
-            ProcessAction(e, nullptr, var0);
+            ProcessAction(state, nullptr, var0);
             break;
         }
         case SMART_EVENT_ACTION_DONE:
         {
             if (e.event.doAction.eventId != var0)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(state, unit, var0);
             break;
         }
         case SMART_EVENT_FRIENDLY_HEALTH_PCT:
@@ -3230,7 +3256,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (!unitTarget)
                 return;
 
-            ProcessTimedAction(e, e.event.friendlyHealthPct.repeatMin, e.event.friendlyHealthPct.repeatMax, unitTarget);
+            ProcessTimedAction(state, e.event.friendlyHealthPct.repeatMin, e.event.friendlyHealthPct.repeatMax, unitTarget);
             break;
         }
         case SMART_EVENT_DISTANCE_CREATURE:
@@ -3259,7 +3285,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             }
 
             if (creature)
-                ProcessTimedAction(e, e.event.distance.repeat, e.event.distance.repeat, creature);
+                ProcessTimedAction(state, e.event.distance.repeat, e.event.distance.repeat, creature);
 
             break;
         }
@@ -3289,7 +3315,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             }
 
             if (gameobject)
-                ProcessTimedAction(e, e.event.distance.repeat, e.event.distance.repeat, nullptr, 0, 0, false, nullptr, gameobject);
+                ProcessTimedAction(state, e.event.distance.repeat, e.event.distance.repeat, nullptr, 0, 0, false, nullptr, gameobject);
 
             break;
         }
@@ -3297,7 +3323,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if (e.event.counter.id != var0 || GetCounterValue(e.event.counter.id) != e.event.counter.value)
                 return;
 
-            ProcessTimedAction(e, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
+            ProcessTimedAction(state, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
             break;
         default:
             TC_LOG_ERROR("sql.sql", "SmartScript::ProcessEvent: Unhandled Event type {}", e.GetEventType());
@@ -3305,34 +3331,36 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
     }
 }
 
-void SmartScript::InitTimer(SmartScriptHolder& e)
+void SmartScript::InitTimer(SmartScriptEventState& state)
 {
+    SmartScriptHolder const& e = *state.Holder;
     switch (e.GetEventType())
     {
         //set only events which have initial timers
         case SMART_EVENT_UPDATE:
         case SMART_EVENT_UPDATE_IC:
         case SMART_EVENT_UPDATE_OOC:
-            RecalcTimer(e, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
+            RecalcTimer(state, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
             break;
         case SMART_EVENT_DISTANCE_CREATURE:
         case SMART_EVENT_DISTANCE_GAMEOBJECT:
-            RecalcTimer(e, e.event.distance.repeat, e.event.distance.repeat);
+            RecalcTimer(state, e.event.distance.repeat, e.event.distance.repeat);
             break;
         default:
-            e.active = true;
+            state.active = true;
             break;
     }
 }
-void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
+void SmartScript::RecalcTimer(SmartScriptEventState& state, uint32 min, uint32 max)
 {
     // min/max was checked at loading!
-    e.timer = urand(min, max);
-    e.active = e.timer ? false : true;
+    state.timer = urand(min, max);
+    state.active = state.timer ? false : true;
 }
 
-void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
+void SmartScript::UpdateTimer(SmartScriptEventState& state, uint32 const diff)
 {
+    SmartScriptHolder const& e = *state.Holder;
     if (e.GetEventType() == SMART_EVENT_LINK)
         return;
 
@@ -3345,7 +3373,7 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
     if (e.GetEventType() == SMART_EVENT_UPDATE_OOC && (me && me->IsEngaged())) //can be used with me=nullptr (go script)
         return;
 
-    if (e.timer < diff)
+    if (state.timer < diff)
     {
         // delay spell cast event if another spell is being cast
         if (e.GetActionType() == SMART_ACTION_CAST)
@@ -3354,7 +3382,7 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
             {
                 if (me && me->HasUnitState(UNIT_STATE_CASTING))
                 {
-                    RaisePriority(e);
+                    RaisePriority(state);
                     return;
                 }
             }
@@ -3365,12 +3393,12 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
         {
             if (me && me->HasUnitState(UNIT_STATE_ROOT | UNIT_STATE_LOST_CONTROL))
             {
-                e.timer = 1;
+                state.timer = 1;
                 return;
             }
         }
 
-        e.active = true;//activate events with cooldown
+        state.active = true;//activate events with cooldown
 
         switch (e.GetEventType())//process ONLY timed events
         {
@@ -3394,12 +3422,12 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
                     Unit* invoker = nullptr;
                     if (me && mTimedActionListInvoker)
                         invoker = ObjectAccessor::GetUnit(*me, mTimedActionListInvoker);
-                    ProcessEvent(e, invoker);
-                    e.enableTimed = false;//disable event if it is in an ActionList and was processed once
-                    for (SmartScriptHolder& scriptholder : mTimedActionList)
+                    ProcessEvent(state, invoker);
+                    state.enableTimed = false;//disable event if it is in an ActionList and was processed once
+                    for (SmartScriptEventState& scriptholder : mTimedActionList)
                     {
                         //find the first event which is not the current one and enable it
-                        if (scriptholder.event_id > e.event_id)
+                        if (scriptholder.Holder->event_id > e.event_id)
                         {
                             scriptholder.enableTimed = true;
                             break;
@@ -3407,40 +3435,41 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
                     }
                 }
                 else
-                    ProcessEvent(e);
+                    ProcessEvent(state);
                 break;
             }
         }
 
-        if (e.priority != SmartScriptHolder::DEFAULT_PRIORITY)
+        if (state.priority != SmartScriptEventState::DEFAULT_PRIORITY)
         {
             // Reset priority to default one only if the event hasn't been rescheduled again to next loop
-            if (e.timer > 1)
+            if (state.timer > 1)
             {
                 // Re-sort events if this was moved to the top of the queue
                  mEventSortingRequired = true;
                 // Reset priority to default one
-                e.priority = SmartScriptHolder::DEFAULT_PRIORITY;
+                state.priority = SmartScriptEventState::DEFAULT_PRIORITY;
             }
         }
     }
     else
-        e.timer -= diff;
+        state.timer -= diff;
 }
 
-bool SmartScript::CheckTimer(SmartScriptHolder const& e) const
+bool SmartScript::CheckTimer(SmartScriptEventState const& state) const
 {
-    return e.active;
+    return state.active;
 }
 
 void SmartScript::InstallEvents()
 {
     if (!mInstallEvents.empty())
     {
-        for (SmartScriptHolder& installevent : mInstallEvents)
+        for (SmartScriptEventState& installevent : mInstallEvents)
             mEvents.push_back(installevent);//must be before UpdateTimers
 
         mInstallEvents.clear();
+        mEventBucketsDirty = true;
     }
 }
 
@@ -3450,7 +3479,7 @@ void SmartScript::RemoveStoredEvent(uint32 id)
     {
         for (auto i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
         {
-            if (i->event_id == id)
+            if (i->Holder.event_id == id)
             {
                 mStoredEvents.erase(i);
                 return;
@@ -3518,14 +3547,17 @@ void SmartScript::OnUpdate(uint32 const diff)
         if (!mTimedActionList.empty())
         {
             bool needCleanup = true;
-            for (SmartScriptHolder& scriptholder : mTimedActionList)
+            for (SmartScriptEventState& scriptholder : mTimedActionList)
             {
                 if (scriptholder.enableTimed)
                     needCleanup = false;
             }
 
             if (needCleanup)
+            {
                 mTimedActionList.clear();
+                mTimedActionListScript.reset();
+            }
         }
 
         return;
@@ -3537,18 +3569,19 @@ void SmartScript::OnUpdate(uint32 const diff)
     {
         SortEvents(mEvents);
         mEventSortingRequired = false;
+        mEventBucketsDirty = true;
     }
 
-    for (SmartScriptHolder& mEvent : mEvents)
+    for (SmartScriptEventState& mEvent : mEvents)
         UpdateTimer(mEvent, diff);
 
     if (!mStoredEvents.empty())
     {
-        SmartAIEventStoredList::iterator i, icurr;
+        std::list<StoredEvent>::iterator i, icurr;
         for (i = mStoredEvents.begin(); i != mStoredEvents.end();)
         {
             icurr = i++;
-            UpdateTimer(*icurr, diff);
+            UpdateTimer(icurr->State, diff);
         }
     }
 
@@ -3556,7 +3589,7 @@ void SmartScript::OnUpdate(uint32 const diff)
     if (!mTimedActionList.empty())
     {
         isProcessingTimedActionList = true;
-        for (SmartScriptHolder& scriptholder : mTimedActionList)
+        for (SmartScriptEventState& scriptholder : mTimedActionList)
         {
             if (scriptholder.enableTimed)
             {
@@ -3568,7 +3601,10 @@ void SmartScript::OnUpdate(uint32 const diff)
         isProcessingTimedActionList = false;
     }
     if (needCleanup)
+    {
         mTimedActionList.clear();
+        mTimedActionListScript.reset();
+    }
 
     if (!mRemIDs.empty())
     {
@@ -3593,36 +3629,88 @@ void SmartScript::OnUpdate(uint32 const diff)
     }
 }
 
-void SmartScript::SortEvents(SmartAIEventList& events)
+void SmartScript::SortEvents(SmartAIEventStateList& events)
 {
     std::sort(events.begin(), events.end());
 }
 
-void SmartScript::RaisePriority(SmartScriptHolder& e)
+void SmartScript::UpdateEventBuckets()
 {
-    e.timer = 1;
+    uint32 conditionGeneration = sConditionMgr->GetLoadGeneration();
+    if (!mEventBucketsDirty && mEventBucketsConditionGeneration == conditionGeneration)
+        return;
+
+    mEventBucketsDirty = false;
+    mEventBucketsConditionGeneration = conditionGeneration;
+
+    // count events per type, then turn the counts into bucket offsets
+    mEventBucketOffsets.fill(0);
+    for (SmartScriptEventState const& state : mEvents)
+        if (state.Holder->GetEventType() < SMART_EVENT_END && state.Holder->GetEventType() != SMART_EVENT_LINK)
+            ++mEventBucketOffsets[state.Holder->GetEventType() + 1];
+
+    for (std::size_t i = 1; i < mEventBucketOffsets.size(); ++i)
+        mEventBucketOffsets[i] += mEventBucketOffsets[i - 1];
+
+    mEventBuckets.resize(mEventBucketOffsets.back());
+    std::array<uint16, SMART_EVENT_END + 1> next = mEventBucketOffsets;
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+    {
+        SmartScriptHolder const& event = *mEvents[i].Holder;
+        if (event.GetEventType() >= SMART_EVENT_END || event.GetEventType() == SMART_EVENT_LINK)
+            continue;
+
+        mEventBuckets[next[event.GetEventType()]++] = { i, GetEventConditions(mEvents[i]) };
+    }
+}
+
+ConditionContainer const* SmartScript::GetEventConditions(SmartScriptEventState& state)
+{
+    uint32 conditionGeneration = sConditionMgr->GetLoadGeneration();
+    if (state.conditionGeneration != conditionGeneration)
+    {
+        SmartScriptHolder const& e = *state.Holder;
+        state.conditions = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
+        state.conditionGeneration = conditionGeneration;
+    }
+    return state.conditions;
+}
+
+void SmartScript::RaisePriority(SmartScriptEventState& state)
+{
+    state.timer = 1;
     // Change priority only if it's set to default, otherwise keep the current order of events
-    if (e.priority == SmartScriptHolder::DEFAULT_PRIORITY)
+    if (state.priority == SmartScriptEventState::DEFAULT_PRIORITY)
     {
-        e.priority = mCurrentPriority++;
+        state.priority = mCurrentPriority++;
         mEventSortingRequired = true;
     }
 }
 
-void SmartScript::RetryLater(SmartScriptHolder& e, bool ignoreChanceRoll)
+void SmartScript::RetryLater(SmartScriptEventState& state, bool ignoreChanceRoll)
 {
-    RaisePriority(e);
+    RaisePriority(state);
 
     // This allows to retry the action later without rolling again the chance roll (which might fail and end up not executing the action)
     if (ignoreChanceRoll)
-        e.event.event_flags |= SMART_EVENT_FLAG_TEMP_IGNORE_CHANCE_ROLL;
+        state.ignoreChanceRoll = true;
 
-    e.runOnce = false;
+    state.runOnce = false;
 }
 
-void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at)
+SmartScriptEventState* SmartScript::FindLinkedEvent(uint32 link)
 {
-    if (e.empty())
+    auto itr = std::find_if(mEvents.begin(), mEvents.end(), [link](SmartScriptEventState const& linked)
+    {
+        return linked.Holder->event_id == link && linked.Holder->GetEventType() == SMART_EVENT_LINK;
+    });
+
+    return itr != mEvents.end() ? &*itr : nullptr;
+}
+
+void SmartScript::FillScript(std::shared_ptr<SmartAIEventList const> script, WorldObject* obj, AreaTriggerEntry const* at)
+{
+    if (!script)
     {
         if (obj)
             TC_LOG_DEBUG("scripts.ai", "SmartScript: EventMap for Entry {} is empty but is using SmartScript.", obj->GetEntry());
@@ -3630,7 +3718,7 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
             TC_LOG_DEBUG("scripts.ai", "SmartScript: EventMap for AreaTrigger {} is empty but is using SmartScript.", at->ID);
         return;
     }
-    for (SmartScriptHolder& scriptholder : e)
+    for (SmartScriptHolder const& scriptholder : *script)
     {
         #ifndef TRINITY_DEBUG
             if (scriptholder.event.event_flags & SMART_EVENT_FLAG_DEBUG_ONLY)
@@ -3646,31 +3734,33 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
                 continue;
         }
         mAllEventFlags |= scriptholder.event.event_flags;
-        mEvents.push_back(scriptholder);//NOTE: 'world(0)' events still get processed in ANY instance mode
+        mEvents.emplace_back(&scriptholder);//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+    mScripts.push_back(std::move(script));
+    mEventBucketsDirty = true;
 }
 
 void SmartScript::GetScript()
 {
-    SmartAIEventList e;
+    std::shared_ptr<SmartAIEventList const> e;
     if (me)
     {
         e = sSmartScriptMgr->GetScript(-((int32)me->GetSpawnId()), mScriptType);
-        if (e.empty())
+        if (!e)
             e = sSmartScriptMgr->GetScript((int32)me->GetEntry(), mScriptType);
-        FillScript(e, me, nullptr);
+        FillScript(std::move(e), me, nullptr);
     }
     else if (go)
     {
         e = sSmartScriptMgr->GetScript(-((int32)go->GetSpawnId()), mScriptType);
-        if (e.empty())
+        if (!e)
             e = sSmartScriptMgr->GetScript((int32)go->GetEntry(), mScriptType);
-        FillScript(e, go, nullptr);
+        FillScript(std::move(e), go, nullptr);
     }
     else if (trigger)
     {
         e = sSmartScriptMgr->GetScript((int32)trigger->ID, mScriptType);
-        FillScript(e, nullptr, trigger);
+        FillScript(std::move(e), nullptr, trigger);
     }
 }
 
@@ -3712,9 +3802,9 @@ void SmartScript::OnInitialize(WorldObject* obj, AreaTriggerEntry const* at)
         return;
     }
 
-    GetScript();//load copy of script
+    GetScript();//load shared script, only the event states are our own
 
-    for (SmartScriptHolder& event : mEvents)
+    for (SmartScriptEventState& event : mEvents)
         InitTimer(event);//calculate timers for first time use
 
     ProcessEventsFor(SMART_EVENT_AI_INIT);
@@ -3788,7 +3878,7 @@ Unit* SmartScript::DoFindClosestFriendlyInRange(float range, bool playerOnly) co
     return unit;
 }
 
-void SmartScript::SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* invoker)
+void SmartScript::SetTimedActionList(SmartScriptHolder const& e, uint32 entry, Unit* invoker)
 {
     //do NOT clear mTimedActionList if it's being iterated because it will invalidate the iterator and delete
     // any SmartScriptHolder contained like the "e" parameter passed to this function
@@ -3803,22 +3893,18 @@ void SmartScript::SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* i
         return;
 
     mTimedActionList.clear();
-    mTimedActionList = sSmartScriptMgr->GetScript(entry, SMART_SCRIPT_TYPE_TIMED_ACTIONLIST);
-    if (mTimedActionList.empty())
+    // event types are already replaced according to the timer type in the compiled list
+    mTimedActionListScript = sSmartScriptMgr->GetTimedActionList(entry, e.action.timedActionList.timerType);
+    if (!mTimedActionListScript)
         return;
     mTimedActionListInvoker = invoker ? invoker->GetGUID() : ObjectGuid::Empty;
-    for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+    mTimedActionList.reserve(mTimedActionListScript->size());
+    for (SmartScriptHolder const& scriptholder : *mTimedActionListScript)
     {
-        i->enableTimed = i == mTimedActionList.begin();//enable processing only for the first action
-
-        if (e.action.timedActionList.timerType == 0)
-            i->event.type = SMART_EVENT_UPDATE_OOC;
-        else if (e.action.timedActionList.timerType == 1)
-            i->event.type = SMART_EVENT_UPDATE_IC;
-        else if (e.action.timedActionList.timerType > 1)
-            i->event.type = SMART_EVENT_UPDATE;
+        SmartScriptEventState& state = mTimedActionList.emplace_back(&scriptholder);
+        state.enableTimed = mTimedActionList.size() == 1;//enable processing only for the first action
 
-        InitTimer((*i));
+        InitTimer(state);
     }
 }
 
@@ -20,6 +20,10 @@
 
 #include "Define.h"
 #include "SmartScriptMgr.h"
+#include <array>
+#include <list>
+#include <memory>
+#include <vector>
 
 class Creature;
 class GameObject;
@@ -28,6 +32,7 @@ class SpellInfo;
 class Unit;
 class WorldObject;
 struct AreaTriggerEntry;
+struct Condition;
 
 class TC_GAME_API SmartScript
 {
@@ -37,16 +42,16 @@ class TC_GAME_API SmartScript
 
         void OnInitialize(WorldObject* obj, AreaTriggerEntry const* at = nullptr);
         void GetScript();
-        void FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at);
+        void FillScript(std::shared_ptr<SmartAIEventList const> script, WorldObject* obj, AreaTriggerEntry const* at);
 
         void ProcessEventsFor(SMART_EVENT e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
-        void ProcessEvent(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
-        bool CheckTimer(SmartScriptHolder const& e) const;
-        static void RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max);
-        void UpdateTimer(SmartScriptHolder& e, uint32 const diff);
-        static void InitTimer(SmartScriptHolder& e);
-        void ProcessAction(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
-        void ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
+        void ProcessEvent(SmartScriptEventState& state, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
+        bool CheckTimer(SmartScriptEventState const& state) const;
+        static void RecalcTimer(SmartScriptEventState& state, uint32 min, uint32 max);
+        void UpdateTimer(SmartScriptEventState& state, uint32 const diff);
+        static void InitTimer(SmartScriptEventState& state);
+        void ProcessAction(SmartScriptEventState& state, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
+        void ProcessTimedAction(SmartScriptEventState& state, uint32 const& min, uint32 const& max, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
         void GetTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker = nullptr) const;
         void GetWorldObjectsInDist(ObjectVector& objects, float dist) const;
         static SmartScriptHolder CreateSmartEvent(SMART_EVENT e, uint32 event_flags, uint32 event_param1, uint32 event_param2, uint32 event_param3, uint32 event_param4, uint32 event_param5, SMART_ACTION action, uint32 action_param1, uint32 action_param2, uint32 action_param3, uint32 action_param4, uint32 action_param5, uint32 action_param6, SMARTAI_TARGETS t, uint32 target_param1, uint32 target_param2, uint32 target_param3, uint32 target_param4, uint32 phaseMask);
@@ -87,7 +92,7 @@ class TC_GAME_API SmartScript
         void OnReset();
         void ResetBaseObject();
 
-        void SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* invoker);
+        void SetTimedActionList(SmartScriptHolder const& e, uint32 entry, Unit* invoker);
         Unit* GetLastInvoker(Unit* invoker = nullptr) const;
         ObjectGuid mLastInvoker;
         typedef std::unordered_map<uint32, uint32> CounterMap;
@@ -101,13 +106,32 @@ class TC_GAME_API SmartScript
         void SetPhase(uint32 p);
         bool IsInPhase(uint32 p) const;
 
-        void SortEvents(SmartAIEventList& events);
-        void RaisePriority(SmartScriptHolder& e);
-        void RetryLater(SmartScriptHolder& e, bool ignoreChanceRoll = false);
-
-        SmartAIEventList mEvents;
-        SmartAIEventList mInstallEvents;
-        SmartAIEventList mTimedActionList;
+        void SortEvents(SmartAIEventStateList& events);
+        // regroups mEvents by event type if they changed or conditions were reloaded since the last call
+        void UpdateEventBuckets();
+        // conditions of the event, looked up again only after conditions were reloaded
+        std::vector<Condition*> const* GetEventConditions(SmartScriptEventState& state);
+        void RaisePriority(SmartScriptEventState& state);
+        void RetryLater(SmartScriptEventState& state, bool ignoreChanceRoll = false);
+        SmartScriptEventState* FindLinkedEvent(uint32 link);
+
+        // compiled scripts shared with every other SmartScript of the same entry, they own the holders mEvents point to
+        std::vector<std::shared_ptr<SmartAIEventList const>> mScripts;
+        SmartAIEventStateList mEvents;
+        SmartAIEventStateList mInstallEvents;
+
+        struct EventBucketEntry
+        {
+            uint32 Index;                               // into mEvents
+            std::vector<Condition*> const* Conditions;  // nullptr if the event has no conditions
+        };
+        // mEvents of type e are listed in order at [mEventBucketOffsets[e], mEventBucketOffsets[e + 1]) of mEventBuckets, links are left out
+        std::vector<EventBucketEntry> mEventBuckets;
+        std::array<uint16, SMART_EVENT_END + 1> mEventBucketOffsets;
+        bool mEventBucketsDirty;
+        uint32 mEventBucketsConditionGeneration;
+        std::shared_ptr<SmartAIEventList const> mTimedActionListScript;
+        SmartAIEventStateList mTimedActionList;
         ObjectGuid mTimedActionListInvoker;
         bool isProcessingTimedActionList;
         Creature* me;
@@ -120,7 +144,17 @@ class TC_GAME_API SmartScript
         uint32 mEventPhase;
 
         uint32 mPathId;
-        SmartAIEventStoredList mStoredEvents;
+        // events created by actions at runtime, unlike mEvents they own their holder
+        struct StoredEvent
+        {
+            explicit StoredEvent(SmartScriptHolder const& holder) : Holder(holder), State(&Holder) { }
+            StoredEvent(StoredEvent const&) = delete;
+            StoredEvent& operator=(StoredEvent const&) = delete;
+
+            SmartScriptHolder Holder;
+            SmartScriptEventState State;
+        };
+        std::list<StoredEvent> mStoredEvents;
         std::vector<uint32> mRemIDs;
 
         uint32 mTextTimer;
@@ -31,6 +31,7 @@
 #include "UnitDefines.h"
 #include "Unit.h"
 #include "WaypointDefines.h"
+#include "WorldDatabaseSnapshot.h"
 
 #define TC_SAI_IS_BOOLEAN_VALID(e, value) \
 { \
@@ -125,34 +126,82 @@ void SmartAIMgr::LoadSmartAIFromDB()
 
     uint32 oldMSTime = getMSTime();
 
-    for (SmartAIEventMap& eventmap : mEventMap)
-        eventmap.clear();  //Drop Existing SmartAI List
-
-    WorldDatabasePreparedStatement* stmt = WorldDatabase.GetPreparedStatement(WORLD_SEL_SMART_SCRIPTS);
-    PreparedQueryResult result = WorldDatabase.Query(stmt);
-
-    if (!result)
+    // Drop Existing SmartAI List, scripts still running them keep their own reference
+    for (SmartAICompiledEventMap& eventmap : mEventMap)
+        eventmap.clear();
+    for (SmartAICompiledEventMap& eventmap : mTimedActionListMap)
+        eventmap.clear();
+
+    // the snapshot keeps the rows as they were read from the table, they are validated below just like the queried ones
+    auto rows = sWorldDatabaseSnapshot->Query<int32, uint8, uint16, uint16, uint8, uint16, uint8, uint16,
+        uint32, uint32, uint32, uint32, uint32,
+        uint8, uint32, uint32, uint32, uint32, uint32, uint32,
+        uint8, uint32, uint32, uint32, uint32, float, float, float, float>("smart_scripts",
+    //          0            1            2   3     4           5                 6             7
+        "SELECT entryorguid, source_type, id, link, event_type, event_phase_mask, event_chance, event_flags, "
+    //   8             9             10            11            12
+        "event_param1, event_param2, event_param3, event_param4, event_param5, "
+    //   13           14             15             16             17             18             19
+        "action_type, action_param1, action_param2, action_param3, action_param4, action_param5, action_param6, "
+    //   20           21             22             23             24             25        26        27        28
+        "target_type, target_param1, target_param2, target_param3, target_param4, target_x, target_y, target_z, target_o "
+        "FROM smart_scripts ORDER BY entryorguid, source_type, id, link");
+
+    if (rows.empty())
     {
         TC_LOG_INFO("server.loading", ">> Loaded 0 SmartAI scripts. DB table `smartai_scripts` is empty.");
         return;
     }
 
     uint32 count = 0;
+    SmartAIEventMap eventMaps[SMART_SCRIPT_TYPE_MAX];
 
-    do
+    for (auto const& [entryOrGuid, sourceType, eventId, link, eventType, eventPhaseMask, eventChance, eventFlags,
+        eventParam1, eventParam2, eventParam3, eventParam4, eventParam5,
+        actionType, actionParam1, actionParam2, actionParam3, actionParam4, actionParam5, actionParam6,
+        targetType, targetParam1, targetParam2, targetParam3, targetParam4, targetX, targetY, targetZ, targetO] : rows)
     {
-        Field* fields = result->Fetch();
-
         SmartScriptHolder temp;
+        temp.entryOrGuid = entryOrGuid;
+        temp.source_type = (SmartScriptType)sourceType;
+        temp.event_id = eventId;
+        temp.link = link;
+        temp.event.type = (SMART_EVENT)eventType;
+        temp.event.event_phase_mask = eventPhaseMask;
+        temp.event.event_chance = eventChance;
+        temp.event.event_flags = eventFlags;
+
+        temp.event.raw.param1 = eventParam1;
+        temp.event.raw.param2 = eventParam2;
+        temp.event.raw.param3 = eventParam3;
+        temp.event.raw.param4 = eventParam4;
+        temp.event.raw.param5 = eventParam5;
+
+        temp.action.type = (SMART_ACTION)actionType;
+        temp.action.raw.param1 = actionParam1;
+        temp.action.raw.param2 = actionParam2;
+        temp.action.raw.param3 = actionParam3;
+        temp.action.raw.param4 = actionParam4;
+        temp.action.raw.param5 = actionParam5;
+        temp.action.raw.param6 = actionParam6;
+
+        temp.target.type = (SMARTAI_TARGETS)targetType;
+        temp.target.raw.param1 = targetParam1;
+        temp.target.raw.param2 = targetParam2;
+        temp.target.raw.param3 = targetParam3;
+        temp.target.raw.param4 = targetParam4;
+        temp.target.x = targetX;
+        temp.target.y = targetY;
+        temp.target.z = targetZ;
+        temp.target.o = targetO;
 
-        temp.entryOrGuid = fields[0].GetInt32();
         if (!temp.entryOrGuid)
         {
             TC_LOG_ERROR("sql.sql", "SmartAIMgr::LoadSmartAIFromDB: invalid entryorguid (0), skipped loading.");
             continue;
         }
 
-        SmartScriptType source_type = (SmartScriptType)fields[1].GetUInt8();
+        SmartScriptType source_type = temp.source_type;
         if (source_type >= SMART_SCRIPT_TYPE_MAX)
         {
             TC_LOG_ERROR("sql.sql", "SmartAIMgr::LoadSmartAIFromDB: invalid source_type ({}), skipped loading.", uint32(source_type));
@@ -266,38 +315,6 @@ void SmartAIMgr::LoadSmartAIFromDB()
             }
         }
 
-        temp.source_type = source_type;
-        temp.event_id = fields[2].GetUInt16();
-        temp.link = fields[3].GetUInt16();
-        temp.event.type = (SMART_EVENT)fields[4].GetUInt8();
-        temp.event.event_phase_mask = fields[5].GetUInt16();
-        temp.event.event_chance = fields[6].GetUInt8();
-        temp.event.event_flags = fields[7].GetUInt16();
-
-        temp.event.raw.param1 = fields[8].GetUInt32();
-        temp.event.raw.param2 = fields[9].GetUInt32();
-        temp.event.raw.param3 = fields[10].GetUInt32();
-        temp.event.raw.param4 = fields[11].GetUInt32();
-        temp.event.raw.param5 = fields[12].GetUInt32();
-
-        temp.action.type = (SMART_ACTION)fields[13].GetUInt8();
-        temp.action.raw.param1 = fields[14].GetUInt32();
-        temp.action.raw.param2 = fields[15].GetUInt32();
-        temp.action.raw.param3 = fields[16].GetUInt32();
-        temp.action.raw.param4 = fields[17].GetUInt32();
-        temp.action.raw.param5 = fields[18].GetUInt32();
-        temp.action.raw.param6 = fields[19].GetUInt32();
-
-        temp.target.type = (SMARTAI_TARGETS)fields[20].GetUInt8();
-        temp.target.raw.param1 = fields[21].GetUInt32();
-        temp.target.raw.param2 = fields[22].GetUInt32();
-        temp.target.raw.param3 = fields[23].GetUInt32();
-        temp.target.raw.param4 = fields[24].GetUInt32();
-        temp.target.x = fields[25].GetFloat();
-        temp.target.y = fields[26].GetFloat();
-        temp.target.z = fields[27].GetFloat();
-        temp.target.o = fields[28].GetFloat();
-
         //check target
         if (!IsTargetValid(temp))
             continue;
@@ -347,19 +364,18 @@ void SmartAIMgr::LoadSmartAIFromDB()
         }
 
         // creature entry / guid not found in storage, create empty event list for it and increase counters
-        if (mEventMap[source_type].find(temp.entryOrGuid) == mEventMap[source_type].end())
+        if (eventMaps[source_type].find(temp.entryOrGuid) == eventMaps[source_type].end())
         {
             ++count;
             SmartAIEventList eventList;
-            mEventMap[source_type][temp.entryOrGuid] = eventList;
+            eventMaps[source_type][temp.entryOrGuid] = eventList;
         }
         // store the new event
-        mEventMap[source_type][temp.entryOrGuid].push_back(temp);
+        eventMaps[source_type][temp.entryOrGuid].push_back(temp);
     }
-    while (result->NextRow());
 
     // Post Loading Validation
-    for (SmartAIEventMap& eventmap : mEventMap)
+    for (SmartAIEventMap& eventmap : eventMaps)
     {
         for (std::pair<int32 const, SmartAIEventList>& eventlistpair : eventmap)
         {
@@ -386,45 +402,78 @@ void SmartAIMgr::LoadSmartAIFromDB()
         }
     }
 
+    // Compile the read-only lists shared by all SmartScripts, timed action lists get one copy per timer type
+    for (std::pair<int32 const, SmartAIEventList>& eventlistpair : eventMaps[SMART_SCRIPT_TYPE_TIMED_ACTIONLIST])
+    {
+        for (uint32 timerType = 0; timerType < TIMED_ACTIONLIST_TIMER_TYPES; ++timerType)
+        {
+            SmartAIEventList actionList = eventlistpair.second;
+            for (SmartScriptHolder& e : actionList)
+            {
+                if (timerType == 0)
+                    e.event.type = SMART_EVENT_UPDATE_OOC;
+                else if (timerType == 1)
+                    e.event.type = SMART_EVENT_UPDATE_IC;
+                else
+                    e.event.type = SMART_EVENT_UPDATE;
+            }
+
+            mTimedActionListMap[timerType][eventlistpair.first] = std::make_shared<SmartAIEventList const>(std::move(actionList));
+        }
+    }
+
+    for (uint32 i = 0; i < SMART_SCRIPT_TYPE_MAX; ++i)
+        for (std::pair<int32 const, SmartAIEventList>& eventlistpair : eventMaps[i])
+            mEventMap[i][eventlistpair.first] = std::make_shared<SmartAIEventList const>(std::move(eventlistpair.second));
+
     TC_LOG_INFO("server.loading", ">> Loaded {} SmartAI scripts in {} ms", count, GetMSTimeDiffToNow(oldMSTime));
 
     UnLoadHelperStores();
 }
 
-SmartAIEventList SmartAIMgr::GetScript(int32 entry, SmartScriptType type)
+std::shared_ptr<SmartAIEventList const> SmartAIMgr::GetScript(int32 entry, SmartScriptType type) const
 {
-    SmartAIEventList temp;
-    if (mEventMap[uint32(type)].find(entry) != mEventMap[uint32(type)].end())
-        return mEventMap[uint32(type)][entry];
-    else
-    {
-        if (entry > 0)//first search is for guid (negative), do not drop error if not found
-            TC_LOG_DEBUG("scripts.ai", "SmartAIMgr::GetScript: Could not load Script for Entry {} ScriptType {}.", entry, uint32(type));
-        return temp;
-    }
+    auto itr = mEventMap[uint32(type)].find(entry);
+    if (itr != mEventMap[uint32(type)].end())
+        return itr->second;
+
+    if (entry > 0)//first search is for guid (negative), do not drop error if not found
+        TC_LOG_DEBUG("scripts.ai", "SmartAIMgr::GetScript: Could not load Script for Entry {} ScriptType {}.", entry, uint32(type));
+    return nullptr;
+}
+
+std::shared_ptr<SmartAIEventList const> SmartAIMgr::GetTimedActionList(int32 entry, uint32 timerType) const
+{
+    SmartAICompiledEventMap const& timedActionLists = mTimedActionListMap[std::min(timerType, TIMED_ACTIONLIST_TIMER_TYPES - 1)];
+    auto itr = timedActionLists.find(entry);
+    if (itr != timedActionLists.end())
+        return itr->second;
+
+    TC_LOG_DEBUG("scripts.ai", "SmartAIMgr::GetTimedActionList: Could not load Script for Entry {} ScriptType {}.", entry, uint32(SMART_SCRIPT_TYPE_TIMED_ACTIONLIST));
+    return nullptr;
 }
 
-SmartScriptHolder& SmartAIMgr::FindLinkedSourceEvent(SmartAIEventList& list, uint32 eventId)
+SmartScriptHolder const& SmartAIMgr::FindLinkedSourceEvent(SmartAIEventList const& list, uint32 eventId)
 {
-    SmartAIEventList::iterator itr = std::find_if(list.begin(), list.end(),
-        [eventId](SmartScriptHolder& source) { return source.link == eventId; });
+    SmartAIEventList::const_iterator itr = std::find_if(list.begin(), list.end(),
+        [eventId](SmartScriptHolder const& source) { return source.link == eventId; });
 
     if (itr != list.end())
         return *itr;
 
-    static SmartScriptHolder SmartScriptHolderDummy;
+    static SmartScriptHolder const SmartScriptHolderDummy;
     return SmartScriptHolderDummy;
 }
 
-SmartScriptHolder& SmartAIMgr::FindLinkedEvent(SmartAIEventList& list, uint32 link)
+SmartScriptHolder const& SmartAIMgr::FindLinkedEvent(SmartAIEventList const& list, uint32 link)
 {
-    SmartAIEventList::iterator itr = std::find_if(list.begin(), list.end(),
-        [link](SmartScriptHolder& linked) { return linked.event_id == link && linked.GetEventType() == SMART_EVENT_LINK; });
+    SmartAIEventList::const_iterator itr = std::find_if(list.begin(), list.end(),
+        [link](SmartScriptHolder const& linked) { return linked.event_id == link && linked.GetEventType() == SMART_EVENT_LINK; });
 
     if (itr != list.end())
         return *itr;
 
-    static SmartScriptHolder SmartScriptHolderDummy;
+    static SmartScriptHolder const SmartScriptHolderDummy;
     return SmartScriptHolderDummy;
 }
 
@@ -25,10 +25,13 @@
 #include "advstd.h"
 #include <limits>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class WorldObject;
+struct Condition;
 enum SpellEffIndex : uint8;
 typedef uint32 SAIBool;
 
@@ -1550,12 +1553,11 @@ enum SmartCastFlags
     SMARTCAST_COMBAT_MOVE            = 0x40                      // Prevents combat movement if cast successful. Allows movement on range, OOM, LOS
 };
 
-// one line in DB is one event
+// one line in DB is one event, compiled once by SmartAIMgr and shared read-only by every SmartScript running it
 struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE)
-        , event_id(0), link(0), event(), action(), target(), timer(0), priority(DEFAULT_PRIORITY), active(false), runOnce(false)
-        , enableTimed(false) { }
+        , event_id(0), link(0), event(), action(), target() { }
 
     int32 entryOrGuid;
     SmartScriptType source_type;
@@ -1571,25 +1573,38 @@ struct SmartScriptHolder
     uint32 GetActionType() const { return (uint32)action.type; }
     uint32 GetTargetType() const { return (uint32)target.type; }
 
+    operator bool() const { return entryOrGuid != 0; }
+};
+
+// per instance state of a SmartScriptHolder, the only part of an event a running SmartScript may change
+struct SmartScriptEventState
+{
+    explicit SmartScriptEventState(SmartScriptHolder const* holder) : Holder(holder), timer(0), priority(DEFAULT_PRIORITY), active(false), runOnce(false)
+        , enableTimed(false), ignoreChanceRoll(false), conditions(nullptr), conditionGeneration(0) { }
+
+    SmartScriptHolder const* Holder;
+
     uint32 timer;
     uint32 priority;
     bool active;
     bool runOnce;
     bool enableTimed;
+    bool ignoreChanceRoll;                                  // skip the next chance roll, set when an action is retried later
+    std::vector<Condition*> const* conditions;              // resolved by SmartScript::GetEventConditions
+    uint32 conditionGeneration;                             // ConditionMgr load generation conditions were resolved for, 0 if never
 
-    operator bool() const { return entryOrGuid != 0; }
     // Default comparision operator using priority field as first ordering field
-    std::strong_ordering operator<=>(SmartScriptHolder const& right) const
+    std::strong_ordering operator<=>(SmartScriptEventState const& right) const
     {
         if (std::strong_ordering cmp = priority <=> right.priority; advstd::is_neq(cmp))
             return cmp;
-        if (std::strong_ordering cmp = entryOrGuid <=> right.entryOrGuid; advstd::is_neq(cmp))
+        if (std::strong_ordering cmp = Holder->entryOrGuid <=> right.Holder->entryOrGuid; advstd::is_neq(cmp))
             return cmp;
-        if (std::strong_ordering cmp = source_type <=> right.source_type; advstd::is_neq(cmp))
+        if (std::strong_ordering cmp = Holder->source_type <=> right.Holder->source_type; advstd::is_neq(cmp))
             return cmp;
-        if (std::strong_ordering cmp = event_id <=> right.event_id; advstd::is_neq(cmp))
+        if (std::strong_ordering cmp = Holder->event_id <=> right.Holder->event_id; advstd::is_neq(cmp))
             return cmp;
-        if (std::strong_ordering cmp = link <=> right.link; advstd::is_neq(cmp))
+        if (std::strong_ordering cmp = Holder->link <=> right.Holder->link; advstd::is_neq(cmp))
             return cmp;
         return std::strong_ordering::equal;
     }
@@ -1643,10 +1658,11 @@ class TC_GAME_API SmartWaypointMgr
 
 // all events for a single entry
 typedef std::vector<SmartScriptHolder> SmartAIEventList;
-typedef std::vector<SmartScriptHolder> SmartAIEventStoredList;
+typedef std::vector<SmartScriptEventState> SmartAIEventStateList;
 
 // all events for all entries / guids
 typedef std::unordered_map<int32, SmartAIEventList> SmartAIEventMap;
+typedef std::unordered_map<int32, std::shared_ptr<SmartAIEventList const>> SmartAICompiledEventMap;
 
 // Helper Stores
 typedef std::map<uint32 /*entry*/, std::pair<uint32 /*spellId*/, SpellEffIndex /*effIndex*/> > CacheSpellContainer;
@@ -1663,15 +1679,21 @@ class TC_GAME_API SmartAIMgr
 
         void LoadSmartAIFromDB();
 
-        SmartAIEventList GetScript(int32 entry, SmartScriptType type);
+        // returns nullptr if the entry has no script, the list stays valid for as long as it is referenced, even across reloads
+        std::shared_ptr<SmartAIEventList const> GetScript(int32 entry, SmartScriptType type) const;
+        // timed action list with every event type replaced by the one matching timerType (0 - out of combat, 1 - in combat, 2+ - always)
+        std::shared_ptr<SmartAIEventList const> GetTimedActionList(int32 entry, uint32 timerType) const;
 
-        static SmartScriptHolder& FindLinkedSourceEvent(SmartAIEventList& list, uint32 eventId);
+        static SmartScriptHolder const& FindLinkedSourceEvent(SmartAIEventList const& list, uint32 eventId);
 
-        static SmartScriptHolder& FindLinkedEvent(SmartAIEventList& list, uint32 link);
+        static SmartScriptHolder const& FindLinkedEvent(SmartAIEventList const& list, uint32 link);
 
     private:
+        static constexpr uint32 TIMED_ACTIONLIST_TIMER_TYPES = 3;
+
         //event stores
-        SmartAIEventMap mEventMap[SMART_SCRIPT_TYPE_MAX];
+        SmartAICompiledEventMap mEventMap[SMART_SCRIPT_TYPE_MAX];
+        SmartAICompiledEventMap mTimedActionListMap[TIMED_ACTIONLIST_TIMER_TYPES];
 
         static bool EventHasInvoker(SMART_EVENT event);
 
@@ -997,7 +997,7 @@ void BattlegroundSA::UpdateDemolisherSpawns()
                     {
                         if (DemoliserRespawnList[i] < GameTime::GetGameTimeMS())
                         {
-                            Demolisher->Relocate(BG_SA_NpcSpawnlocs[i]);
+                            Demolisher->GetMap()->CreatureRelocation(Demolisher, BG_SA_NpcSpawnlocs[i].GetPositionX(), BG_SA_NpcSpawnlocs[i].GetPositionY(), BG_SA_NpcSpawnlocs[i].GetPositionZ(), BG_SA_NpcSpawnlocs[i].GetOrientation());
                             Demolisher->Respawn();
                             DemoliserRespawnList.erase(i);
                         }
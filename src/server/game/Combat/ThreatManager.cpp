@@ -32,23 +32,15 @@
 #include "ObjectAccessor.h"
 #include "WorldPacket.h"
 #include <algorithm>
-#include <boost/heap/fibonacci_heap.hpp>
 
 const CompareThreatLessThan ThreatManager::CompareThreat;
 
-class ThreatManager::Heap : public boost::heap::fibonacci_heap<ThreatReference const*, boost::heap::compare<CompareThreatLessThan>>
-{
-};
-
 void ThreatReference::AddThreat(float amount)
 {
     if (amount == 0.0f)
         return;
     _baseAmount = std::max<float>(_baseAmount + amount, 0.0f);
-    if (amount > 0.0f)
-        HeapNotifyIncreased();
-    else
-        HeapNotifyDecreased();
+    ListNotifyChanged();
     _mgr._needClientUpdate = true;
 }
 
@@ -57,10 +49,7 @@ void ThreatReference::ScaleThreat(float factor)
     if (factor == 1.0f)
         return;
     _baseAmount *= factor;
-    if (factor > 1.0f)
-        HeapNotifyIncreased();
-    else
-        HeapNotifyDecreased();
+    ListNotifyChanged();
     _mgr._needClientUpdate = true;
 }
 
@@ -73,13 +62,13 @@ void ThreatReference::UpdateOffline()
     if (shouldBeOffline)
     {
         _online = ONLINE_STATE_OFFLINE;
-        HeapNotifyDecreased();
+        ListNotifyChanged();
         _mgr.SendRemoveToClients(_victim);
     }
     else
     {
         _online = ShouldBeSuppressed() ? ONLINE_STATE_SUPPRESSED : ONLINE_STATE_ONLINE;
-        HeapNotifyIncreased();
+        ListNotifyChanged();
         _mgr.RegisterForAIUpdate(GetVictim()->GetGUID());
     }
 }
@@ -134,12 +123,8 @@ void ThreatReference::UpdateTauntState(TauntState state)
     if (state == _taunted)
         return;
 
-    std::swap(state, _taunted);
-
-    if (_taunted < state)
-        HeapNotifyDecreased();
-    else
-        HeapNotifyIncreased();
+    _taunted = state;
+    ListNotifyChanged();
 
     _mgr._needClientUpdate = true;
 }
@@ -160,18 +145,11 @@ class ThreatReferenceImpl : public ThreatReference
 {
 public:
     explicit ThreatReferenceImpl(ThreatManager* mgr, Unit* victim) : ThreatReference(mgr, victim) { }
-
-    ThreatManager::Heap::handle_type _handle;
 };
 
-void ThreatReference::HeapNotifyIncreased()
+void ThreatReference::ListNotifyChanged()
 {
-    _mgr._sortedThreatList->increase(static_cast<ThreatReferenceImpl*>(this)->_handle);
-}
-
-void ThreatReference::HeapNotifyDecreased()
-{
-    _mgr._sortedThreatList->decrease(static_cast<ThreatReferenceImpl*>(this)->_handle);
+    _mgr._threatListSorted = false;
 }
 
 /*static*/ bool ThreatManager::CanHaveThreatList(Unit const* who)
@@ -195,7 +173,7 @@ void ThreatReference::HeapNotifyDecreased()
 }
 
 ThreatManager::ThreatManager(Unit* owner) : _owner(owner), _ownerCanHaveThreatList(false), _needClientUpdate(false), _updateTimer(THREAT_UPDATE_INTERVAL),
-    _sortedThreatList(std::make_unique<Heap>()), _currentVictimRef(nullptr), _fixateRef(nullptr)
+    _threatListSorted(true), _currentVictimRef(nullptr), _fixateRef(nullptr)
 {
     for (int8 i = 0; i < MAX_SPELL_SCHOOL; ++i)
         _singleSchoolModifiers[i] = 1.0f;
@@ -203,8 +181,8 @@ ThreatManager::ThreatManager(Unit* owner) : _owner(owner), _ownerCanHaveThreatLi
 
 ThreatManager::~ThreatManager()
 {
-    ASSERT(_myThreatListEntries.empty(), "ThreatManager::~ThreatManager - %s: we still have %zu things threatening us, one of them is %s.", _owner->GetGUID().ToString().c_str(), _myThreatListEntries.size(), _myThreatListEntries.begin()->first.ToString().c_str());
-    ASSERT(_sortedThreatList->empty(), "ThreatManager::~ThreatManager - %s: we still have %zu things threatening us, one of them is %s.", _owner->GetGUID().ToString().c_str(), _sortedThreatList->size(), (*_sortedThreatList->begin())->GetVictim()->GetGUID().ToString().c_str());
+    ASSERT(_threatListGuids.empty(), "ThreatManager::~ThreatManager - %s: we still have %zu things threatening us, one of them is %s.", _owner->GetGUID().ToString().c_str(), _threatListGuids.size(), _threatListGuids.front().ToString().c_str());
+    ASSERT(_sortedThreatList.empty(), "ThreatManager::~ThreatManager - %s: we still have %zu things threatening us, one of them is %s.", _owner->GetGUID().ToString().c_str(), _sortedThreatList.size(), _sortedThreatList.front()->GetVictim()->GetGUID().ToString().c_str());
     ASSERT(_threatenedByMe.empty(), "ThreatManager::~ThreatManager - %s: we are still threatening %zu things, one of them is %s.", _owner->GetGUID().ToString().c_str(), _threatenedByMe.size(), _threatenedByMe.begin()->first.ToString().c_str());
 }
 
@@ -243,7 +221,7 @@ Unit* ThreatManager::GetLastVictim() const
 
 Unit* ThreatManager::GetAnyTarget() const
 {
-    for (ThreatReference const* ref : *_sortedThreatList)
+    for (ThreatReference const* ref : _threatListRefs)
         if (!ref->IsOffline())
             return ref->GetVictim();
     return nullptr;
@@ -252,8 +230,8 @@ Unit* ThreatManager::GetAnyTarget() const
 bool ThreatManager::IsThreatListEmpty(bool includeOffline) const
 {
     if (includeOffline)
-        return _sortedThreatList->empty();
-    for (ThreatReference const* ref : *_sortedThreatList)
+        return _threatListRefs.empty();
+    for (ThreatReference const* ref : _threatListRefs)
         if (ref->IsAvailable())
             return false;
     return true;
@@ -261,61 +239,41 @@ bool ThreatManager::IsThreatListEmpty(bool includeOffline) const
 
 bool ThreatManager::IsThreatenedBy(ObjectGuid const& who, bool includeOffline) const
 {
-    auto it = _myThreatListEntries.find(who);
-    if (it == _myThreatListEntries.end())
+    ThreatReference const* ref = GetThreatListRef(who);
+    if (!ref)
         return false;
-    return (includeOffline || it->second->IsAvailable());
+    return (includeOffline || ref->IsAvailable());
 }
 bool ThreatManager::IsThreatenedBy(Unit const* who, bool includeOffline) const { return IsThreatenedBy(who->GetGUID(), includeOffline); }
 
 float ThreatManager::GetThreat(Unit const* who, bool includeOffline) const
 {
-    auto it = _myThreatListEntries.find(who->GetGUID());
-    if (it == _myThreatListEntries.end())
+    ThreatReference const* ref = GetThreatListRef(who->GetGUID());
+    if (!ref)
         return 0.0f;
-    return (includeOffline || it->second->IsAvailable()) ? it->second->GetThreat() : 0.0f;
+    return (includeOffline || ref->IsAvailable()) ? ref->GetThreat() : 0.0f;
 }
 
 size_t ThreatManager::GetThreatListSize() const
 {
-    return _sortedThreatList->size();
+    return _threatListRefs.size();
 }
 
 Trinity::IteratorPair<ThreatManager::ThreatListIterator, std::nullptr_t> ThreatManager::GetUnsortedThreatList() const
 {
-    auto itr = _myThreatListEntries.begin();
-    auto end = _myThreatListEntries.end();
-    std::function<ThreatReference const* ()> generator = [itr, end]() mutable -> ThreatReference const*
-    {
-        if (itr == end)
-            return nullptr;
-
-        return (itr++)->second;
-    };
-    return { ThreatListIterator{ std::move(generator) }, nullptr };
+    return { ThreatListIterator{ _threatListRefs.data(), _threatListRefs.data() + _threatListRefs.size() }, nullptr };
 }
 
 Trinity::IteratorPair<ThreatManager::ThreatListIterator, std::nullptr_t> ThreatManager::GetSortedThreatList() const
 {
-    auto itr = _sortedThreatList->ordered_begin();
-    auto end = _sortedThreatList->ordered_end();
-    std::function<ThreatReference const* ()> generator = [itr, end]() mutable -> ThreatReference const*
-    {
-        if (itr == end)
-            return nullptr;
-
-        return *(itr++);
-    };
-    return { ThreatListIterator{ std::move(generator) }, nullptr };
+    SortThreatList();
+    return { ThreatListIterator{ _sortedThreatList.data(), _sortedThreatList.data() + _sortedThreatList.size() }, nullptr };
 }
 
 std::vector<ThreatReference*> ThreatManager::GetModifiableThreatList()
 {
-    std::vector<ThreatReference*> list;
-    list.reserve(_myThreatListEntries.size());
-    for (auto it = _sortedThreatList->ordered_begin(), end = _sortedThreatList->ordered_end(); it != end; ++it)
-        list.push_back(const_cast<ThreatReference*>(*it));
-    return list;
+    SortThreatList();
+    return { _sortedThreatList.begin(), _sortedThreatList.end() };
 }
 
 bool ThreatManager::IsThreateningAnyone(bool includeOffline) const
@@ -345,12 +303,12 @@ void ThreatManager::EvaluateSuppressed(bool canExpire)
         if (pair.second->IsOnline() && shouldBeSuppressed)
         {
             pair.second->_online = ThreatReference::ONLINE_STATE_SUPPRESSED;
-            pair.second->HeapNotifyDecreased();
+            pair.second->ListNotifyChanged();
         }
         else if (canExpire && pair.second->IsSuppressed() && !shouldBeSuppressed)
         {
             pair.second->_online = ThreatReference::ONLINE_STATE_ONLINE;
-            pair.second->HeapNotifyIncreased();
+            pair.second->ListNotifyChanged();
         }
     }
 }
@@ -415,9 +373,8 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
             {
                 auto const pair = redirInfo[i]; // (victim,pct)
                 Unit* redirTarget = nullptr;
-                auto it = _myThreatListEntries.find(pair.first); // try to look it up in our threat list first (faster)
-                if (it != _myThreatListEntries.end())
-                    redirTarget = it->second->_victim;
+                if (ThreatReference* ref = GetThreatListRef(pair.first)) // try to look it up in our threat list first (faster)
+                    redirTarget = ref->_victim;
                 else
                     redirTarget = ObjectAccessor::GetUnit(*_owner, pair.first);
 
@@ -437,16 +394,14 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
 
     // ok, now we actually apply threat
     // check if we already have an entry - if we do, just increase threat for that entry and we're done
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
+    if (ThreatReference* const ref = GetThreatListRef(target->GetGUID()))
     {
-        ThreatReference* const ref = it->second;
         // SUPPRESSED threat states don't go back to ONLINE until threat is caused by them (retail behavior)
         if (ref->GetOnlineState() == ThreatReference::ONLINE_STATE_SUPPRESSED)
             if (!ref->ShouldBeSuppressed())
             {
                 ref->_online = ThreatReference::ONLINE_STATE_ONLINE;
-                ref->HeapNotifyIncreased();
+                ref->ListNotifyChanged();
             }
 
         if (ref->IsOnline())
@@ -471,17 +426,17 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
 
 void ThreatManager::ScaleThreat(Unit* target, float factor)
 {
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
-        it->second->ScaleThreat(std::max<float>(factor,0.0f));
+    if (ThreatReference* ref = GetThreatListRef(target->GetGUID()))
+        ref->ScaleThreat(std::max<float>(factor,0.0f));
 }
 
 void ThreatManager::MatchUnitThreatToHighestThreat(Unit* target)
 {
-    if (_sortedThreatList->empty())
+    if (_sortedThreatList.empty())
         return;
 
-    auto it = _sortedThreatList->ordered_begin(), end = _sortedThreatList->ordered_end();
+    SortThreatList();
+    auto it = _sortedThreatList.begin(), end = _sortedThreatList.end();
     ThreatReference const* highest = *it;
     if (!highest->IsAvailable())
         return;
@@ -506,13 +461,13 @@ void ThreatManager::TauntUpdate()
     for (auto it = tauntEffects.begin(), end = tauntEffects.end(); it != end; ++it)
         tauntStates[(*it)->GetCasterGUID()] = ThreatReference::TauntState(state++);
 
-    for (auto const& pair : _myThreatListEntries)
+    for (size_t i = 0; i < _threatListGuids.size(); ++i)
     {
-        auto it = tauntStates.find(pair.first);
+        auto it = tauntStates.find(_threatListGuids[i]);
         if (it != tauntStates.end())
-            pair.second->UpdateTauntState(it->second);
+            _threatListRefs[i]->UpdateTauntState(it->second);
         else
-            pair.second->UpdateTauntState();
+            _threatListRefs[i]->UpdateTauntState();
     }
 
     // taunt aura update also re-evaluates all suppressed states (retail behavior)
@@ -521,15 +476,14 @@ void ThreatManager::TauntUpdate()
 
 void ThreatManager::ResetAllThreat()
 {
-    for (auto const& pair : _myThreatListEntries)
-        pair.second->ScaleThreat(0.0f);
+    for (ThreatReference* ref : _threatListRefs)
+        ref->ScaleThreat(0.0f);
 }
 
 void ThreatManager::ClearThreat(Unit* target)
 {
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
-        ClearThreat(it->second);
+    if (ThreatReference* ref = GetThreatListRef(target->GetGUID()))
+        ClearThreat(ref);
 }
 
 void ThreatManager::ClearThreat(ThreatReference* ref)
@@ -542,12 +496,12 @@ void ThreatManager::ClearThreat(ThreatReference* ref)
 
 void ThreatManager::ClearAllThreat()
 {
-    if (!_myThreatListEntries.empty())
+    if (!_threatListRefs.empty())
     {
         SendClearAllThreatToClients();
         do
-            _myThreatListEntries.begin()->second->UnregisterAndFree();
-        while (!_myThreatListEntries.empty());
+            _threatListRefs.back()->UnregisterAndFree();
+        while (!_threatListRefs.empty());
     }
 }
 
@@ -555,10 +509,9 @@ void ThreatManager::FixateTarget(Unit* target)
 {
     if (target)
     {
-        auto it = _myThreatListEntries.find(target->GetGUID());
-        if (it != _myThreatListEntries.end())
+        if (ThreatReference const* ref = GetThreatListRef(target->GetGUID()))
         {
-            _fixateRef = it->second;
+            _fixateRef = ref;
             return;
         }
     }
@@ -590,11 +543,13 @@ void ThreatManager::UpdateVictim()
 
 ThreatReference const* ThreatManager::ReselectVictim()
 {
-    if (_sortedThreatList->empty())
+    if (_sortedThreatList.empty())
         return nullptr;
 
-    for (auto const& pair : _myThreatListEntries)
-        pair.second->UpdateOffline(); // AI notifies are processed in ::UpdateVictim caller
+    for (ThreatReference* ref : _threatListRefs)
+        ref->UpdateOffline(); // AI notifies are processed in ::UpdateVictim caller
+
+    SortThreatList();
 
     // fixated target is always preferred
     if (_fixateRef && _fixateRef->IsAvailable())
@@ -604,7 +559,7 @@ ThreatReference const* ThreatManager::ReselectVictim()
     if (oldVictimRef && oldVictimRef->IsOffline())
         oldVictimRef = nullptr;
     // in 99% of cases - we won't need to actually look at anything beyond the first element
-    ThreatReference const* highest = _sortedThreatList->top();
+    ThreatReference const* highest = _sortedThreatList.front();
     // if the highest reference is offline, the entire list is offline, and we indicate this
     if (!highest->IsAvailable())
         return nullptr;
@@ -621,8 +576,8 @@ ThreatReference const* ThreatManager::ReselectVictim()
     if (_owner->IsWithinMeleeRange(highest->_victim))
         return highest;
     // If we get here, highest threat is ranged, but below 130% of current - there might be a melee that breaks 110% below us somewhere, so now we need to actually look at the next highest element
-    // luckily, this is a heap, so getting the next highest element is O(log n), and we're just gonna do that repeatedly until we've seen enough targets (or find a target)
-    auto it = _sortedThreatList->ordered_begin(), end = _sortedThreatList->ordered_end();
+    // the list is sorted at this point, so we're just gonna walk it until we've seen enough targets (or find a target)
+    auto it = _sortedThreatList.begin(), end = _sortedThreatList.end();
     while (it != end)
     {
         ThreatReference const* next = *it;
@@ -650,7 +605,7 @@ void ThreatManager::ProcessAIUpdates()
     if (!ai)
         return;
     for (ObjectGuid const& guid : v)
-        if (ThreatReference const* ref = Trinity::Containers::MapGetValuePtr(_myThreatListEntries, guid))
+        if (ThreatReference const* ref = GetThreatListRef(guid))
             ai->JustStartedThreateningMe(ref->GetVictim());
 }
 
@@ -767,14 +722,10 @@ void ThreatManager::UpdateMyTempModifiers()
         return;
 
     auto it = _threatenedByMe.begin();
-    bool const isIncrease = (it->second->_tempModifier < mod);
     do
     {
         it->second->_tempModifier = mod;
-        if (isIncrease)
-            it->second->HeapNotifyIncreased();
-        else
-            it->second->HeapNotifyDecreased();
+        it->second->ListNotifyChanged();
     } while ((++it) != _threatenedByMe.end());
 }
 
@@ -830,14 +781,15 @@ void ThreatManager::SendRemoveToClients(Unit const* victim) const
 
 void ThreatManager::SendThreatListToClients(bool newHighest) const
 {
-    WorldPacket data(newHighest ? SMSG_HIGHEST_THREAT_UPDATE : SMSG_THREAT_UPDATE, (_sortedThreatList->size() + 2) * 8); // guess
+    SortThreatList();
+    WorldPacket data(newHighest ? SMSG_HIGHEST_THREAT_UPDATE : SMSG_THREAT_UPDATE, (_sortedThreatList.size() + 2) * 8); // guess
     data << _owner->GetPackGUID();
     if (newHighest)
         data << _currentVictimRef->GetVictim()->GetPackGUID();
     size_t countPos = data.wpos();
     data << uint32(0); // placeholder
     uint32 count = 0;
-    for (ThreatReference const* ref : *_sortedThreatList)
+    for (ThreatReference const* ref : _sortedThreatList)
     {
         if (!ref->IsAvailable())
             continue;
@@ -852,20 +804,27 @@ void ThreatManager::SendThreatListToClients(bool newHighest) const
 void ThreatManager::PutThreatListRef(ObjectGuid const& guid, ThreatReference* ref)
 {
     _needClientUpdate = true;
-    auto& inMap = _myThreatListEntries[guid];
-    ASSERT(!inMap, "Duplicate threat reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
-    inMap = ref;
-    static_cast<ThreatReferenceImpl*>(ref)->_handle = _sortedThreatList->push(ref);
+    ASSERT(!GetThreatListRef(guid), "Duplicate threat reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
+    _threatListGuids.push_back(guid);
+    _threatListRefs.push_back(ref);
+    _sortedThreatList.push_back(ref);
+    _threatListSorted = false;
 }
 
 void ThreatManager::PurgeThreatListRef(ObjectGuid const& guid)
 {
-    auto it = _myThreatListEntries.find(guid);
-    if (it == _myThreatListEntries.end())
+    auto it = std::find(_threatListGuids.begin(), _threatListGuids.end(), guid);
+    if (it == _threatListGuids.end())
         return;
-    ThreatReference* ref = it->second;
-    _myThreatListEntries.erase(it);
-    _sortedThreatList->erase(static_cast<ThreatReferenceImpl*>(ref)->_handle);
+    size_t const index = std::distance(_threatListGuids.begin(), it);
+    ThreatReference* ref = _threatListRefs[index];
+    // unsorted list order is arbitrary, fill the gap with the last entry
+    _threatListGuids[index] = _threatListGuids.back();
+    _threatListGuids.pop_back();
+    _threatListRefs[index] = _threatListRefs.back();
+    _threatListRefs.pop_back();
+    // removing an entry keeps the remaining ones in order
+    _sortedThreatList.erase(std::find(_sortedThreatList.begin(), _sortedThreatList.end(), ref));
 
     if (_fixateRef == ref)
         _fixateRef = nullptr;
@@ -873,6 +832,31 @@ void ThreatManager::PurgeThreatListRef(ObjectGuid const& guid)
         _currentVictimRef = nullptr;
 }
 
+ThreatReference* ThreatManager::GetThreatListRef(ObjectGuid const& guid) const
+{
+    for (size_t i = 0; i < _threatListGuids.size(); ++i)
+        if (_threatListGuids[i] == guid)
+            return _threatListRefs[i];
+    return nullptr;
+}
+
+void ThreatManager::SortThreatList() const
+{
+    if (_threatListSorted)
+        return;
+
+    // most changes only move a few entries, insertion sort keeps that cheap
+    for (size_t i = 1; i < _sortedThreatList.size(); ++i)
+    {
+        ThreatReference* ref = _sortedThreatList[i];
+        size_t j = i;
+        for (; j > 0 && CompareThreat(_sortedThreatList[j - 1], ref); --j)
+            _sortedThreatList[j] = _sortedThreatList[j - 1];
+        _sortedThreatList[j] = ref;
+    }
+    _threatListSorted = true;
+}
+
 void ThreatManager::PutThreatenedByMeRef(ObjectGuid const& guid, ThreatReference* ref)
 {
     auto& inMap = _threatenedByMe[guid];
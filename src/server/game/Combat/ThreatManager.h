@@ -26,6 +26,7 @@
 #include <memory>
 #include <unordered_map>
 #include <vector>
+#include <boost/container/small_vector.hpp>
 
 class Creature;
 class Unit;
@@ -47,8 +48,8 @@ class SpellInfo;
  *  - Adding threat will also create a combat reference between the units if one doesn't exist yet (even if the owner can't have a threat list!)        *
  *  - Ending combat between two units will also delete any threat references that may exist between them.                                               *
  *                                                                                                                                                      *
- * To manage a creature's threat list, ThreatManager maintains a heap of threat reference const pointers.                                               *
- * This heap is kept well-structured in all methods that modify ThreatReference, and is used to select the next target.                                 *
+ * To manage a creature's threat list, ThreatManager maintains a flat array of threat reference pointers, sorted by the criteria below.                 *
+ * Methods that modify ThreatReference only flag this array as unsorted; it is re-sorted once the next time it is read in order (target selection).     *
  *                                                                                                                                                      *
  * Selection uses the following properties on ThreatReference, in order:                                                                                *
  * - Online state (one of ONLINE, SUPPRESSED, OFFLINE):                                                                                                 *
@@ -65,7 +66,7 @@ class SpellInfo;
  * The current (= last selected) victim can be accessed using GetCurrentVictim.                                                                         *
  * Beyond that, ThreatManager has a variety of helpers and notifiers, which are documented inline below.                                                *
  *                                                                                                                                                      *
- * SPECIAL NOTE: Please be aware that any iterator may be invalidated if you modify a ThreatReference. The heap holds const pointers for a reason, but  *
+ * SPECIAL NOTE: Please be aware that any iterator may be invalidated if you modify a ThreatReference. The list holds const pointers for a reason, but  *
  *                 that doesn't mean you're scot free. A variety of actions (casting spells, teleporting units, and so forth) can cause changes to      *
  *                 the threat list. Use with care - or default to GetModifiableThreatList(), which inherently copies entries.                           *
 \********************************************************************************************************************************************************/
@@ -81,7 +82,6 @@ struct CompareThreatLessThan
 class TC_GAME_API ThreatManager
 {
     public:
-        class Heap;
         class ThreatListIterator;
         static const uint32 THREAT_UPDATE_INTERVAL = 1000u;
 
@@ -195,11 +195,25 @@ class TC_GAME_API ThreatManager
         ///== MY THREAT LIST ==
         void PutThreatListRef(ObjectGuid const& guid, ThreatReference* ref);
         void PurgeThreatListRef(ObjectGuid const& guid);
+        // linear scan of _threatListGuids, threat lists rarely grow beyond a raid and walking 40 contiguous
+        // guids is as cheap as hashing one, without keeping a second container in sync on every insert and removal
+        ThreatReference* GetThreatListRef(ObjectGuid const& guid) const;
+        // re-sorts _sortedThreatList if any reference changed since the last sort
+        void SortThreatList() const;
+
+        // a party worth of entries is stored inline, larger lists move to a single heap allocation
+        static constexpr size_t THREAT_LIST_INLINE_SIZE = 5;
+        template<typename T>
+        using ThreatListStorage = boost::container::small_vector<T, THREAT_LIST_INLINE_SIZE>;
 
         bool _needClientUpdate;
         uint32 _updateTimer;
-        std::unique_ptr<Heap> _sortedThreatList;
-        std::unordered_map<ObjectGuid, ThreatReference*> _myThreatListEntries;
+        // unsorted threat list, victim guids and references share the same index
+        ThreatListStorage<ObjectGuid> _threatListGuids;
+        ThreatListStorage<ThreatReference*> _threatListRefs;
+        // same references, highest threat first (see CompareReferencesLT) while _threatListSorted is set
+        mutable ThreatListStorage<ThreatReference*> _sortedThreatList;
+        mutable bool _threatListSorted;
 
         // AI notifies are delayed to ensure we are in a consistent state before we call out to arbitrary logic
         // threat references might register themselves here when ::UpdateOffline() is called - MAKE SURE THIS IS PROCESSED JUST BEFORE YOU EXIT THREATMANAGER LOGIC
@@ -232,27 +246,28 @@ class TC_GAME_API ThreatManager
         class ThreatListIterator
         {
         private:
-            std::function<ThreatReference const* ()> _generator;
-            ThreatReference const* _current;
+            ThreatReference* const* _itr;
+            ThreatReference* const* _end;
 
             friend ThreatManager;
-            explicit ThreatListIterator(std::function<ThreatReference const* ()>&& generator)
-                : _generator(std::move(generator)), _current(_generator()) {}
+            explicit ThreatListIterator(ThreatReference* const* begin, ThreatReference* const* end)
+                : _itr(begin), _end(end) {}
 
         public:
-            ThreatReference const* operator*() const { return _current; }
-            ThreatReference const* operator->() const { return _current; }
-            ThreatListIterator& operator++() { _current = _generator(); return *this; }
-            bool operator==(ThreatListIterator const& o) const { return _current == o._current; }
-            bool operator!=(ThreatListIterator const& o) const { return _current != o._current; }
-            bool operator==(std::nullptr_t) const { return _current == nullptr; }
-            bool operator!=(std::nullptr_t) const { return _current != nullptr; }
+            ThreatReference const* operator*() const { return *_itr; }
+            ThreatReference const* operator->() const { return *_itr; }
+            ThreatListIterator& operator++() { ++_itr; return *this; }
+            bool operator==(ThreatListIterator const& o) const { return _itr == o._itr; }
+            bool operator!=(ThreatListIterator const& o) const { return _itr != o._itr; }
+            bool operator==(std::nullptr_t) const { return _itr == _end; }
+            bool operator!=(std::nullptr_t) const { return _itr != _end; }
         };
 
     friend class ThreatReference;
     friend class ThreatReferenceImpl;
     friend struct CompareThreatLessThan;
     friend class debug_commandscript;
+    friend class UnitTestDataLoader;
 };
 
 // Please check Game/Combat/ThreatManager.h for documentation on how this class works!
@@ -300,8 +315,7 @@ class TC_GAME_API ThreatReference
         void UpdateTauntState(TauntState state = TAUNT_STATE_NONE);
         Creature* const _owner;
         ThreatManager& _mgr;
-        void HeapNotifyIncreased();
-        void HeapNotifyDecreased();
+        void ListNotifyChanged();
         Unit* const _victim;
         OnlineState _online;
         float _baseAmount;
@@ -314,6 +328,7 @@ class TC_GAME_API ThreatReference
 
     friend class ThreatManager;
     friend struct CompareThreatLessThan;
+    friend class UnitTestDataLoader;
 };
 
 inline bool CompareThreatLessThan::operator()(ThreatReference const* a, ThreatReference const* b) const { return ThreatManager::CompareReferencesLT(a, b, 1.0f); }
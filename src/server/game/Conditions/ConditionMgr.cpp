@@ -785,7 +785,7 @@ std::string Condition::ToString(bool ext /*= false*/) const
     return ss.str();
 }
 
-ConditionMgr::ConditionMgr() { }
+ConditionMgr::ConditionMgr() : _loadGeneration(0) { }
 
 ConditionMgr::~ConditionMgr()
 {
@@ -1005,6 +1005,16 @@ bool ConditionMgr::IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint
 }
 
 bool ConditionMgr::IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const
+{
+    if (ConditionContainer const* conditions = GetConditionsForSmartEvent(entryOrGuid, eventId, sourceType))
+    {
+        ConditionSourceInfo sourceInfo(unit, baseObject);
+        return IsObjectMeetToConditions(sourceInfo, *conditions);
+    }
+    return true;
+}
+
+ConditionContainer const* ConditionMgr::GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const
 {
     SmartEventConditionContainer::const_iterator itr = SmartEventConditionStore.find(std::make_pair(entryOrGuid, sourceType));
     if (itr != SmartEventConditionStore.end())
@@ -1013,11 +1023,10 @@ bool ConditionMgr::IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32
         if (i != itr->second.end())
         {
             TC_LOG_DEBUG("condition", "GetConditionsForSmartEvent: found conditions for Smart Event entry or guid {} eventId {}", entryOrGuid, eventId);
-            ConditionSourceInfo sourceInfo(unit, baseObject);
-            return IsObjectMeetToConditions(sourceInfo, i->second);
+            return &i->second;
         }
     }
-    return true;
+    return nullptr;
 }
 
 bool ConditionMgr::IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const
@@ -2403,6 +2412,8 @@ void ConditionMgr::LogUselessConditionValue(Condition* cond, uint8 index, uint32
 
 void ConditionMgr::Clean()
 {
+    ++_loadGeneration;
+
     for (ConditionReferenceContainer::iterator itr = ConditionReferenceStore.begin(); itr != ConditionReferenceStore.end(); ++itr)
         for (ConditionContainer::const_iterator it = itr->second.begin(); it != itr->second.end(); ++it)
             delete *it;
@@ -275,10 +275,14 @@ class TC_GAME_API ConditionMgr
         ConditionContainer const* GetConditionsForSpellClickEvent(uint32 creatureId, uint32 spellId) const;
         bool IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint32 spellId, Player* player, Unit* vehicle) const;
         bool IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const;
+        ConditionContainer const* GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const;
         bool IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const;
 
         bool IsSpellUsedInSpellClickConditions(uint32 spellId) const;
 
+        // changes every time conditions are (re)loaded, pointers to condition containers obtained earlier are invalid after that
+        uint32 GetLoadGeneration() const { return _loadGeneration; }
+
         struct ConditionTypeInfo
         {
             char const* Name;
@@ -310,6 +314,8 @@ class TC_GAME_API ConditionMgr
         SmartEventConditionContainer    SmartEventConditionStore;
 
         std::unordered_set<uint32> SpellsUsedInSpellClickConditions;
+
+        uint32 _loadGeneration;
 };
 
 #define sConditionMgr ConditionMgr::instance()
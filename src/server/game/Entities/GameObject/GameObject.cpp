@@ -2760,79 +2760,83 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player co
         return;
 
     bool forcedFlags = GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules && HasLootRecipient();
-    bool targetIsGM = target->IsGameMaster();
 
-    ByteBuffer fieldBuffer;
-
-    UpdateMaskPacketBuilder updateMask(m_valuesCount);
-
-    uint32* flags = GameObjectUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMaskPacketBuilder updateMask(m_valuesCount);
+    BuildValuesUpdateMask(updateType, GameObjectUpdateFieldFlags, visibleFlag, _fieldNotifyFlags, updateMask);
+    if (forcedFlags)
+        updateMask.SetBit(GAMEOBJECT_FLAGS);
+
+    updateMask.AppendToPacket(data);
+    updateMask.ForEachSetBit([&](uint16 index)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == GAMEOBJECT_FLAGS && forcedFlags))
-        {
-            updateMask.SetBit(index);
+        if (IsUpdateFieldTargetDependent(index))
+            *data << GetUpdateFieldValueForTarget(index, target);
+        else
+            *data << m_uint32Values[index];                // other cases
+    });
+}
 
-            if (index == GAMEOBJECT_DYNAMIC)
+bool GameObject::IsUpdateFieldTargetDependent(uint16 index) const
+{
+    return index == GAMEOBJECT_DYNAMIC || index == GAMEOBJECT_FLAGS;
+}
+
+uint32 GameObject::GetUpdateFieldValueForTarget(uint16 index, Player const* target) const
+{
+    if (index == GAMEOBJECT_DYNAMIC)
+    {
+        uint16 dynFlags = 0;
+        int16 pathProgress = -1;
+        switch (GetGoType())
+        {
+            case GAMEOBJECT_TYPE_QUESTGIVER:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                break;
+            case GAMEOBJECT_TYPE_CHEST:
+            case GAMEOBJECT_TYPE_GOOBER:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                else if (target->IsGameMaster())
+                    dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                break;
+            case GAMEOBJECT_TYPE_GENERIC:
+                if (ActivateToQuest(target))
+                    dynFlags |= GO_DYNFLAG_LO_SPARKLE;
+                break;
+            case GAMEOBJECT_TYPE_TRANSPORT:
+            case GAMEOBJECT_TYPE_MO_TRANSPORT:
             {
-                uint16 dynFlags = 0;
-                int16 pathProgress = -1;
-                switch (GetGoType())
+                if (uint32 transportPeriod = GetTransportPeriod())
                 {
-                    case GAMEOBJECT_TYPE_QUESTGIVER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_CHEST:
-                    case GAMEOBJECT_TYPE_GOOBER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
-                        else if (targetIsGM)
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_GENERIC:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_SPARKLE;
-                        break;
-                    case GAMEOBJECT_TYPE_TRANSPORT:
-                    case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                    {
-                        if (uint32 transportPeriod = GetTransportPeriod())
-                        {
-                            float timer = float(m_goValue.Transport.PathProgress % transportPeriod);
-                            pathProgress = int16(timer / float(transportPeriod) * 65535.0f);
-                        }
-                        break;
-                    }
-                    default:
-                        break;
+                    float timer = float(m_goValue.Transport.PathProgress % transportPeriod);
+                    pathProgress = int16(timer / float(transportPeriod) * 65535.0f);
                 }
-
-                fieldBuffer << uint16(dynFlags);
-                fieldBuffer << int16(pathProgress);
+                break;
             }
-            else if (index == GAMEOBJECT_FLAGS)
-            {
-                uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
-                if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
-                    if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
-                        goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
-
-                fieldBuffer << goFlags;
-            }
-            else
-                fieldBuffer << m_uint32Values[index];                // other cases
+            default:
+                break;
         }
+
+        // sent as uint16 flags followed by int16 path progress
+        return uint32(dynFlags) | (uint32(uint16(pathProgress)) << 16);
     }
 
-    updateMask.AppendToPacket(data);
-    data->append(fieldBuffer);
+    if (index == GAMEOBJECT_FLAGS)
+    {
+        uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
+        if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
+            if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
+                goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
+
+        return goFlags;
+    }
+
+    return m_uint32Values[index];
 }
 
 void GameObject::GetRespawnPosition(float &x, float &y, float &z, float* ori /* = nullptr*/) const
@@ -2896,12 +2900,7 @@ void GameObject::UpdateModelPosition()
     if (!m_model)
         return;
 
-    if (GetMap()->ContainsGameObjectModel(*m_model))
-    {
-        GetMap()->RemoveGameObjectModel(*m_model);
-        m_model->UpdatePosition();
-        GetMap()->InsertGameObjectModel(*m_model);
-    }
+    GetMap()->RelocateGameObjectModel(*m_model);
 }
 
 class GameObjectModelOwnerImpl : public GameObjectModelOwnerBase
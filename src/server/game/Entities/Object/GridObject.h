@@ -12,7 +12,7 @@ class GridObject
 
         bool IsInGrid() const { return _gridRef.isValid(); }
         void AddToGrid(GridRefManager<T>& m) { ASSERT(!IsInGrid()); _gridRef.link(&m, (T*)this); }
-        void RemoveFromGrid() { ASSERT(IsInGrid()); _gridRef.unlink(); }
+        void RemoveFromGrid() { ASSERT(IsInGrid()); ((T*)this)->RemoveFromCellIndex(); _gridRef.unlink(); }
     private:
         GridReference<T> _gridRef;
 };
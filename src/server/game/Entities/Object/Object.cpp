@@ -455,25 +455,45 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player const*
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
-    UpdateMaskPacketBuilder updateMask(m_valuesCount);
-
     uint32* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
     ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMaskPacketBuilder updateMask(m_valuesCount);
+    BuildValuesUpdateMask(updateType, flags, visibleFlag, _fieldNotifyFlags, updateMask);
+
+    updateMask.AppendToPacket(data);
+    updateMask.ForEachSetBit([&](uint16 index)
+    {
+        *data << m_uint32Values[index];
+    });
+}
+
+void Object::BuildValuesUpdateMask(uint8 updateType, uint32 const* flags, uint32 visibleFlag, uint32 forcedFlags, UpdateMaskPacketBuilder& updateMask) const
+{
+    UpdateFieldFlagMasks const& flagMasks = GetUpdateFieldFlagMasks(flags);
+    uint32 blockCount = updateMask.GetBlockCount();
+    for (uint32 block = 0; block < blockCount; ++block)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
+        UpdateMask::BlockType visible = flagMasks.GetBlock(visibleFlag, block);
+        UpdateMask::BlockType bits = flagMasks.GetBlock(forcedFlags, block);
+        if (updateType == UPDATETYPE_VALUES)
+            bits |= _changesMask.GetBlock(block) & visible;
+        else
         {
-            updateMask.SetBit(index);
-            fieldBuffer << m_uint32Values[index];
+            UpdateMask::ForEachSetBit(block, visible & ~bits, [&](uint16 index)
+            {
+                if (index < m_valuesCount && m_uint32Values[index])
+                    bits |= UpdateMask::GetBlockFlag(index);
+            });
         }
-    }
 
-    updateMask.AppendToPacket(data);
-    data->append(fieldBuffer);
+        // flag arrays are shared by types with different field counts (items and containers, units and players)
+        if (block + 1 == blockCount)
+            bits &= UpdateMask::GetLastBlockMask(m_valuesCount);
+
+        updateMask.SetBlock(block, bits);
+    }
 }
 
 void Object::AddToObjectUpdateIfNeeded()
@@ -495,10 +515,50 @@ void Object::ClearUpdateMask(bool remove)
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateBlockCache* cache /*= nullptr*/) const
 {
     UpdateDataMapType::iterator iter = data_map.try_emplace(player).first;
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!cache)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    // the update mask and all values except target dependent fields only depend on visibility flags
+    uint32* flags = nullptr;
+    uint32 visibleFlag = GetUpdateFieldData(player, flags);
+    auto block = std::find_if(cache->begin(), cache->end(), [visibleFlag](ValuesUpdateBlock const& cached) { return cached.VisibleFlag == visibleFlag; });
+    if (block == cache->end())
+    {
+        block = cache->emplace(cache->end());
+        block->VisibleFlag = visibleFlag;
+        block->Data << uint8(UPDATETYPE_VALUES);
+        block->Data << GetPackGUID();
+
+        std::size_t maskPos = block->Data.wpos();
+        BuildValuesUpdate(UPDATETYPE_VALUES, &block->Data, player);
+
+        uint8 maskBlockCount = block->Data[maskPos];
+        std::size_t valuePos = maskPos + 1 + maskBlockCount * sizeof(UpdateMask::BlockType);
+        for (uint8 maskBlock = 0; maskBlock < maskBlockCount; ++maskBlock)
+        {
+            UpdateMask::ForEachSetBit(maskBlock, block->Data.read<UpdateMask::BlockType>(maskPos + 1 + maskBlock * sizeof(UpdateMask::BlockType)), [&](uint16 index)
+            {
+                if (IsUpdateFieldTargetDependent(index))
+                    block->TargetDependentFields.emplace_back(index, valuePos);
+
+                valuePos += sizeof(uint32);
+            });
+        }
+    }
+
+    ByteBuffer& buf = iter->second.GetBuffer();
+    std::size_t blockPos = buf.wpos();
+    buf.append(block->Data);
+    for (auto const& [index, offset] : block->TargetDependentFields)
+        buf.put<uint32>(blockPos + offset, GetUpdateFieldValueForTarget(index, player));
+
+    iter->second.AddUpdateBlock();
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -950,6 +1010,9 @@ m_currMap(nullptr), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_notifyflag
 
 WorldObject::~WorldObject()
 {
+    // objects deleted while still stored in a cell, see ObjectGridUnloader
+    RemoveFromCellIndex();
+
     // this may happen because there are many !create/delete
     if (IsStoredInWorldObjectGridContainer() && m_currMap)
     {
@@ -1205,17 +1268,9 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, LineOfSightChecks ch
 {
     if (IsInWorld())
     {
-        oz += GetCollisionHeight();
-        float x, y, z;
-        if (GetTypeId() == TYPEID_PLAYER)
-        {
-            GetPosition(x, y, z);
-            z += GetCollisionHeight();
-        }
-        else
-            GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
-
-        return GetMap()->isInLineOfSight(x, y, z, ox, oy, oz, GetPhaseMask(), checks, ignoreFlags);
+        VMAP::LineOfSightQuery query;
+        GetLineOfSightQuery(ox, oy, oz, query);
+        return GetMap()->isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, GetPhaseMask(), checks, ignoreFlags);
     }
 
     return true;
@@ -1226,25 +1281,42 @@ bool WorldObject::IsWithinLOSInMap(WorldObject const* obj, LineOfSightChecks che
     if (!IsInMap(obj))
         return false;
 
-    float ox, oy, oz;
+    VMAP::LineOfSightQuery query;
+    GetLineOfSightQuery(obj, query);
+    return GetMap()->isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, GetPhaseMask(), checks, ignoreFlags);
+}
+
+void WorldObject::GetLineOfSightQuery(float ox, float oy, float oz, VMAP::LineOfSightQuery& query) const
+{
+    query.x2 = ox;
+    query.y2 = oy;
+    query.z2 = oz + GetCollisionHeight();
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        GetPosition(query.x1, query.y1, query.z1);
+        query.z1 += GetCollisionHeight();
+    }
+    else
+        GetHitSpherePointFor({ query.x2, query.y2, query.z2 }, query.x1, query.y1, query.z1);
+}
+
+void WorldObject::GetLineOfSightQuery(WorldObject const* obj, VMAP::LineOfSightQuery& query) const
+{
     if (obj->GetTypeId() == TYPEID_PLAYER)
     {
-        obj->GetPosition(ox, oy, oz);
-        oz += GetCollisionHeight();
+        obj->GetPosition(query.x2, query.y2, query.z2);
+        query.z2 += GetCollisionHeight();
     }
     else
-        obj->GetHitSpherePointFor({ GetPositionX(), GetPositionY(), GetPositionZ() + GetCollisionHeight() }, ox, oy, oz);
+        obj->GetHitSpherePointFor({ GetPositionX(), GetPositionY(), GetPositionZ() + GetCollisionHeight() }, query.x2, query.y2, query.z2);
 
-    float x, y, z;
     if (GetTypeId() == TYPEID_PLAYER)
     {
-        GetPosition(x, y, z);
-        z += GetCollisionHeight();
+        GetPosition(query.x1, query.y1, query.z1);
+        query.z1 += GetCollisionHeight();
     }
     else
-        GetHitSpherePointFor({ obj->GetPositionX(), obj->GetPositionY(), obj->GetPositionZ() + obj->GetCollisionHeight() }, x, y, z);
-
-    return GetMap()->isInLineOfSight(x, y, z, ox, oy, oz, GetPhaseMask(), checks, ignoreFlags);
+        GetHitSpherePointFor({ obj->GetPositionX(), obj->GetPositionY(), obj->GetPositionZ() + obj->GetCollisionHeight() }, query.x1, query.y1, query.z1);
 }
 
 void WorldObject::GetHitSpherePointFor(Position const& dest, float& x, float& y, float& z) const
@@ -3441,6 +3513,7 @@ void WorldObject::MovePositionToFirstCollision(Position &pos, float dist, float
 void WorldObject::SetPhaseMask(uint32 newPhaseMask, bool update)
 {
     m_phaseMask = newPhaseMask;
+    UpdateCellIndex();
 
     if (update && IsInWorld())
         UpdateObjectVisibility();
@@ -3513,6 +3586,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     GuidSet plr_list;
+    ValuesUpdateBlockCache i_valuesBlocks;
     WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) { }
     void Visit(PlayerMapType &m)
     {
@@ -3570,7 +3644,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, &i_valuesBlocks);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -18,6 +18,7 @@
 #ifndef _OBJECT_H
 #define _OBJECT_H
 
+#include "CellObjectIndex.h"
 #include "Common.h"
 #include "Duration.h"
 #include "EventProcessor.h"
@@ -67,8 +68,20 @@ class Forge;
 struct FactionTemplateEntry;
 struct QuaternionData;
 
+namespace VMAP { struct LineOfSightQuery; }
+
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+// Values update block of one object, shared by every player seeing it with the same visibility flags
+struct ValuesUpdateBlock
+{
+    uint32 VisibleFlag = 0;
+    ByteBuffer Data;
+    std::vector<std::pair<uint16, std::size_t>> TargetDependentFields;  // field index, offset of its value in Data
+};
+
+typedef std::vector<ValuesUpdateBlock> ValuesUpdateBlockCache;
+
 float const DEFAULT_COLLISION_HEIGHT = 2.03128f; // Most common value in dbc
 
 class TC_GAME_API Object
@@ -162,7 +175,7 @@ class TC_GAME_API Object
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         void SetIsNewObject(bool enable) { m_isNewObject = enable; }
         virtual void BuildUpdate(UpdateDataMapType&) { }
-        void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, ValuesUpdateBlockCache* cache = nullptr) const;
 
         void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
         void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= uint16(~flag); }
@@ -234,6 +247,12 @@ class TC_GAME_API Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 flags) const;
         virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player const* target) const;
+        // fields with any of forcedFlags, plus changed (values update) or non-zero (create update) fields visible with visibleFlag
+        void BuildValuesUpdateMask(uint8 updateType, uint32 const* flags, uint32 visibleFlag, uint32 forcedFlags, UpdateMaskPacketBuilder& updateMask) const;
+
+        // fields whose sent value differs between players with the same visibility flags
+        virtual bool IsUpdateFieldTargetDependent(uint16 /*index*/) const { return false; }
+        virtual uint32 GetUpdateFieldValueForTarget(uint16 index, Player const* /*target*/) const { return m_uint32Values[index]; }
 
         uint16 m_objectType;
 
@@ -348,6 +367,10 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         virtual void Update(uint32 /*time_diff*/) { }
 
+        // position index of the cell the object is stored in, updated by the Map::*Relocation functions
+        void UpdateCellIndex() { if (m_cellIndexSlot.Index) m_cellIndexSlot.Index->Update(this); }
+        void RemoveFromCellIndex() { if (m_cellIndexSlot.Index) m_cellIndexSlot.Index->Remove(this); }
+
         void _Create(ObjectGuid::LowType guidlow, HighGuid guidhigh, uint32 phaseMask);
         void AddToWorld() override;
         void RemoveFromWorld() override;
@@ -409,6 +432,9 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         bool IsWithinDistInMap(WorldObject const* obj, float dist2compare, bool is3D = true, bool incOwnRadius = true, bool incTargetRadius = true) const;
         bool IsWithinLOS(float x, float y, float z, LineOfSightChecks checks = LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags ignoreFlags = VMAP::ModelIgnoreFlags::Nothing) const;
         bool IsWithinLOSInMap(WorldObject const* obj, LineOfSightChecks checks = LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags ignoreFlags = VMAP::ModelIgnoreFlags::Nothing) const;
+        // fill the ray IsWithinLOS/IsWithinLOSInMap would check, for batched checks through Map::isInLineOfSight
+        void GetLineOfSightQuery(float ox, float oy, float oz, VMAP::LineOfSightQuery& query) const;
+        void GetLineOfSightQuery(WorldObject const* obj, VMAP::LineOfSightQuery& query) const;
         Position GetHitSpherePointFor(Position const& dest) const;
         void GetHitSpherePointFor(Position const& dest, float& x, float& y, float& z) const;
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
@@ -645,6 +671,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         //difference from IsAlwaysVisibleFor: 1. after distance check; 2. use owner or charmer as seer
         virtual bool IsAlwaysDetectableFor(WorldObject const* /*seer*/) const { return false; }
     private:
+        friend class CellObjectIndex;
+
         Map* m_currMap;                                   // current object's Map location
 
         uint32 m_InstanceId;                              // in map copy with instance id
@@ -652,6 +680,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         uint16 m_notifyflags;
 
+        CellObjectIndexSlot m_cellIndexSlot;
+
         ObjectGuid _privateObjectOwner;
 
         virtual bool _IsWithinDist(WorldObject const* obj, float dist2compare, bool is3D, bool incOwnRadius = true, bool incTargetRadius = true) const;
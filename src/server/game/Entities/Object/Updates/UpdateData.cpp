@@ -22,6 +22,8 @@
 #include "World.h"
 #include "WorldPacket.h"
 #include <zlib.h>
+#include <atomic>
+#include <chrono>
 
 UpdateData::UpdateData() : m_blockCount(0) { }
 
@@ -35,44 +37,116 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid guid)
     m_outOfRangeGUIDs.insert(guid);
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+namespace
 {
-    z_stream c_stream;
+    // deflate state is about 256 KB, keep one per thread for its whole lifetime and only reset it between packets
+    class UpdateDataCompressor
+    {
+    public:
+        UpdateDataCompressor() : _initialized(false), _level(0) { }
+
+        ~UpdateDataCompressor()
+        {
+            if (_initialized)
+                deflateEnd(&_stream);
+        }
+
+        UpdateDataCompressor(UpdateDataCompressor const&) = delete;
+        UpdateDataCompressor& operator=(UpdateDataCompressor const&) = delete;
+
+        z_stream* GetStream(int level)
+        {
+            if (_initialized && _level != level)
+            {
+                deflateEnd(&_stream);
+                _initialized = false;
+            }
+
+            if (!_initialized)
+            {
+                _stream.zalloc = (alloc_func)nullptr;
+                _stream.zfree = (free_func)nullptr;
+                _stream.opaque = (voidpf)nullptr;
+
+                int z_res = deflateInit(&_stream, level);
+                if (z_res != Z_OK)
+                {
+                    TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: {} ({})", z_res, zError(z_res));
+                    return nullptr;
+                }
+
+                _initialized = true;
+                _level = level;
+                return &_stream;
+            }
+
+            int z_res = deflateReset(&_stream);
+            if (z_res != Z_OK)
+            {
+                TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateReset) Error code: {} ({})", z_res, zError(z_res));
+                deflateEnd(&_stream);
+                _initialized = false;
+                return nullptr;
+            }
+
+            return &_stream;
+        }
+
+    private:
+        z_stream _stream;
+        bool _initialized;
+        int _level;
+    };
+
+    thread_local UpdateDataCompressor Compressor;
+
+    std::atomic<uint64> CompressedPackets(0);
+    std::atomic<uint64> CompressionInputBytes(0);
+    std::atomic<uint64> CompressionOutputBytes(0);
+    std::atomic<uint64> CompressionMicroseconds(0);
+}
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+void UpdateData::Compress(void* dst, uint32 *dst_size, ByteBuffer const& header, ByteBuffer const& data)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getIntConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = Compressor.GetStream(sWorld->getIntConfig(CONFIG_COMPRESSION));
+    if (!c_stream)
     {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: {} ({})", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
+    // header and object blocks are fed separately so they never have to be copied into one buffer
+    for (ByteBuffer const* input : { &header, &data })
     {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate) Error code: {} ({})", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    if (c_stream.avail_in != 0)
-    {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
+        if (!input->wpos())
+            continue;
+
+        c_stream->next_in = (Bytef*)input->contents();
+        c_stream->avail_in = (uInt)input->wpos();
+
+        int z_res = deflate(c_stream, Z_NO_FLUSH);
+        if (z_res != Z_OK)
+        {
+            TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate) Error code: {} ({})", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
+
+        if (c_stream->avail_in != 0)
+        {
+            TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate not greedy)");
+            *dst_size = 0;
+            return;
+        }
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    int z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate should report Z_STREAM_END instead {} ({})", z_res, zError(z_res));
@@ -80,45 +154,50 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateEnd) Error code: {} ({})", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    *dst_size = c_stream->total_out;
 
-    *dst_size = c_stream.total_out;
+    CompressedPackets.fetch_add(1, std::memory_order_relaxed);
+    CompressionInputBytes.fetch_add(c_stream->total_in, std::memory_order_relaxed);
+    CompressionOutputBytes.fetch_add(c_stream->total_out, std::memory_order_relaxed);
+    CompressionMicroseconds.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
+
+UpdateDataCompressionStats UpdateData::GetCompressionStats()
+{
+    UpdateDataCompressionStats stats;
+    stats.Packets = CompressedPackets.load(std::memory_order_relaxed);
+    stats.InputBytes = CompressionInputBytes.load(std::memory_order_relaxed);
+    stats.OutputBytes = CompressionOutputBytes.load(std::memory_order_relaxed);
+    stats.Microseconds = CompressionMicroseconds.load(std::memory_order_relaxed);
+    return stats;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     ASSERT(packet->empty());                                // shouldn't happen
 
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    ByteBuffer header(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()));
 
-    buf << (uint32) (!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
+    header << (uint32) (!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << uint8(UPDATETYPE_OUT_OF_RANGE_OBJECTS);
-        buf << uint32(m_outOfRangeGUIDs.size());
+        header << uint8(UPDATETYPE_OUT_OF_RANGE_OBJECTS);
+        header << uint32(m_outOfRangeGUIDs.size());
 
         for (GuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
-            buf << i->WriteAsPacked();
+            header << i->WriteAsPacked();
     }
 
-    buf.append(m_data);
-
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = header.wpos() + m_data.wpos();           // use real used data size
 
-    if (pSize > 100)                                       // compress large packets
+    if (pSize > sWorld->getIntConfig(CONFIG_COMPRESSION_MIN_SIZE))  // compress large packets
     {
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
 
         packet->put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, header, m_data);
         if (destsize == 0)
             return false;
 
@@ -127,7 +206,8 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
     }
     else                                                    // send small packets without compression
     {
-        packet->append(buf);
+        packet->append(header);
+        packet->append(m_data);
         packet->SetOpcode(SMSG_UPDATE_OBJECT);
     }
 
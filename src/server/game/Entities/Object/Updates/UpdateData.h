@@ -51,6 +51,14 @@ enum OBJECT_UPDATE_FLAGS
     UPDATEFLAG_NO_BIRTH_ANIM        = 0x0400
 };
 
+struct UpdateDataCompressionStats
+{
+    uint64 Packets = 0;
+    uint64 InputBytes = 0;
+    uint64 OutputBytes = 0;
+    uint64 Microseconds = 0;
+};
+
 class UpdateData
 {
     public:
@@ -71,12 +79,15 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        /// Totals of all update packets compressed since startup
+        static UpdateDataCompressionStats GetCompressionStats();
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
-        void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        static void Compress(void* dst, uint32 *dst_size, ByteBuffer const& header, ByteBuffer const& data);
 
         UpdateData(UpdateData const& right) = delete;
         UpdateData& operator=(UpdateData const& right) = delete;
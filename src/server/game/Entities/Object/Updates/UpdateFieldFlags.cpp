@@ -16,6 +16,7 @@
  */
 
 #include "UpdateFieldFlags.h"
+#include "Errors.h"
 
 uint32 ItemUpdateFieldFlags[CONTAINER_END] =
 {
@@ -1566,3 +1567,32 @@ uint32 CorpseUpdateFieldFlags[CORPSE_END] =
     UF_FLAG_DYNAMIC,                                        // CORPSE_FIELD_DYNAMIC_FLAGS
     UF_FLAG_NONE,                                           // CORPSE_FIELD_PAD
 };
+
+UpdateFieldFlagMasks::UpdateFieldFlagMasks(uint32 const* flags, uint32 fieldCount) : _blockCount((fieldCount + 31) / 32), _masks(FLAG_COUNT * _blockCount, 0)
+{
+    for (uint32 index = 0; index < fieldCount; ++index)
+        for (uint32 flag = 0; flag < FLAG_COUNT; ++flag)
+            if (flags[index] & (1 << flag))
+                _masks[flag * _blockCount + index / 32] |= 1u << (index % 32);
+}
+
+UpdateFieldFlagMasks const& GetUpdateFieldFlagMasks(uint32 const* flags)
+{
+    static UpdateFieldFlagMasks const itemMasks(ItemUpdateFieldFlags, CONTAINER_END);
+    static UpdateFieldFlagMasks const unitMasks(UnitUpdateFieldFlags, PLAYER_END);
+    static UpdateFieldFlagMasks const gameObjectMasks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+    static UpdateFieldFlagMasks const dynamicObjectMasks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+    static UpdateFieldFlagMasks const corpseMasks(CorpseUpdateFieldFlags, CORPSE_END);
+
+    if (flags == UnitUpdateFieldFlags)
+        return unitMasks;
+    if (flags == GameObjectUpdateFieldFlags)
+        return gameObjectMasks;
+    if (flags == ItemUpdateFieldFlags)
+        return itemMasks;
+    if (flags == DynamicObjectUpdateFieldFlags)
+        return dynamicObjectMasks;
+
+    ASSERT(flags == CorpseUpdateFieldFlags);
+    return corpseMasks;
+}
@@ -20,6 +20,8 @@
 
 #include "UpdateFields.h"
 #include "Define.h"
+#include <bit>
+#include <vector>
 
 enum UpdatefieldFlags
 {
@@ -41,4 +43,31 @@ TC_GAME_API extern uint32 GameObjectUpdateFieldFlags[GAMEOBJECT_END];
 TC_GAME_API extern uint32 DynamicObjectUpdateFieldFlags[DYNAMICOBJECT_END];
 TC_GAME_API extern uint32 CorpseUpdateFieldFlags[CORPSE_END];
 
+/// Fields having a given UpdatefieldFlags bit, precomputed as 32 bit blocks in UpdateMask layout
+class TC_GAME_API UpdateFieldFlagMasks
+{
+public:
+    UpdateFieldFlagMasks(uint32 const* flags, uint32 fieldCount);
+
+    /// Block of fields having any of the given flags
+    uint32 GetBlock(uint32 flags, uint32 block) const
+    {
+        uint32 bits = 0;
+        for (; flags; flags &= flags - 1)
+            bits |= _masks[std::countr_zero(flags) * _blockCount + block];
+
+        return bits;
+    }
+
+    uint32 GetBlockCount() const { return _blockCount; }
+
+private:
+    static constexpr uint32 FLAG_COUNT = 9;
+
+    uint32 _blockCount;
+    std::vector<uint32> _masks;
+};
+
+TC_GAME_API UpdateFieldFlagMasks const& GetUpdateFieldFlagMasks(uint32 const* flags);
+
 #endif // _UPDATEFIELDFLAGS_H
@@ -21,95 +21,141 @@
 #include "UpdateFields.h"
 #include "ByteBuffer.h"
 #include "Errors.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
 
+/// Changed fields of an object, one bit per field packed in the same 32 bit blocks the client reads
 class UpdateMask
 {
 public:
-    UpdateMask() : _bits(nullptr), _fieldCount(0) { }
+    using BlockType = uint32;
+
+    enum UpdateMaskCount
+    {
+        BLOCK_BITS = sizeof(BlockType) * 8,
+    };
+
+    UpdateMask() : _blocks(nullptr), _blockCount(0) { }
 
     void SetBit(uint32 index)
     {
-        _bits[index] = 1;
+        _blocks[GetBlockIndex(index)] |= GetBlockFlag(index);
     }
 
     void UnsetBit(uint32 index)
     {
-        _bits[index] = 0;
+        _blocks[GetBlockIndex(index)] &= ~GetBlockFlag(index);
     }
 
     bool GetBit(uint32 index) const
     {
-        return _bits[index] != 0;
+        return (_blocks[GetBlockIndex(index)] & GetBlockFlag(index)) != 0;
     }
 
+    BlockType GetBlock(uint32 block) const { return _blocks[block]; }
+    uint32 GetBlockCount() const { return _blockCount; }
+
     void SetCount(uint32 valuesCount)
     {
-        _bits = std::make_unique<uint8[]>(valuesCount);
-        std::uninitialized_fill_n(&_bits[0], valuesCount, 0);
-        _fieldCount = valuesCount;
+        _blockCount = CalculateBlockCount(valuesCount);
+        _blocks = std::make_unique<BlockType[]>(_blockCount);
+        std::uninitialized_fill_n(&_blocks[0], _blockCount, 0);
     }
 
     void Clear()
     {
-        if (_bits)
-            std::fill_n(&_bits[0], _fieldCount, 0);
+        if (_blocks)
+            std::fill_n(&_blocks[0], _blockCount, 0);
+    }
+
+    static constexpr uint32 CalculateBlockCount(uint32 fieldCount)
+    {
+        return (fieldCount + BLOCK_BITS - 1) / BLOCK_BITS;
+    }
+
+    static constexpr uint32 GetBlockIndex(uint32 bit)
+    {
+        return bit / BLOCK_BITS;
+    }
+
+    static constexpr BlockType GetBlockFlag(uint32 bit)
+    {
+        return BlockType(1) << (bit % BLOCK_BITS);
+    }
+
+    /// Mask of the bits below fieldCount in the block containing field fieldCount - 1
+    static constexpr BlockType GetLastBlockMask(uint32 fieldCount)
+    {
+        return fieldCount % BLOCK_BITS ? GetBlockFlag(fieldCount) - 1 : ~BlockType(0);
+    }
+
+    /// Calls visitor for every set bit in block, lowest first
+    template<typename Visitor>
+    static void ForEachSetBit(uint32 block, BlockType bits, Visitor&& visitor)
+    {
+        for (; bits; bits &= bits - 1)
+            visitor(uint16(block * BLOCK_BITS + std::countr_zero(bits)));
     }
 
 private:
-    std::unique_ptr<uint8[]> _bits;
-    uint32 _fieldCount;
+    std::unique_ptr<BlockType[]> _blocks;
+    uint32 _blockCount;
 };
 
 class UpdateMaskPacketBuilder
 {
 public:
     /// Type representing how client reads update mask
-    using ClientUpdateMaskType = uint32;
+    using ClientUpdateMaskType = UpdateMask::BlockType;
 
     enum UpdateMaskCount
     {
         CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
     };
 
-    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _lastSetBit(0)
+    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _blockCount(UpdateMask::CalculateBlockCount(valuesCount)), _usedBlockCount(0)
     {
-        std::size_t blockCount = CalculateBlockCount(valuesCount);
-        _mask = std::make_unique<ClientUpdateMaskType[]>(blockCount);
-        std::uninitialized_fill_n(&_mask[0], blockCount, 0);
+        ASSERT(_blockCount <= _mask.size());
+        _mask.fill(0);
     }
 
     void SetBit(uint32 bit)
     {
-        _mask[GetBlockIndex(bit)] |= GetBlockFlag(bit);
-        _lastSetBit = bit;
+        uint32 block = UpdateMask::GetBlockIndex(bit);
+        _mask[block] |= UpdateMask::GetBlockFlag(bit);
+        _usedBlockCount = std::max(_usedBlockCount, block + 1);
     }
 
-    void AppendToPacket(ByteBuffer* data)
+    void SetBlock(uint32 block, ClientUpdateMaskType bits)
     {
-        uint8 blockCount = CalculateBlockCount(_lastSetBit + 1);
-        *data << uint8(blockCount);
-        if (blockCount)
-            data->append(&_mask[0], blockCount);
+        _mask[block] = bits;
+        if (bits)
+            _usedBlockCount = std::max(_usedBlockCount, block + 1);
     }
 
-private:
-    static constexpr uint8 CalculateBlockCount(uint32 fieldCount)
-    {
-        return (fieldCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
-    }
+    uint32 GetBlockCount() const { return _blockCount; }
 
-    static constexpr std::size_t GetBlockIndex(uint32 bit)
+    /// Calls visitor with the index of every field in the mask, in the order their values are sent
+    template<typename Visitor>
+    void ForEachSetBit(Visitor&& visitor) const
     {
-        return bit / 32;
+        for (uint32 block = 0; block < _usedBlockCount; ++block)
+            UpdateMask::ForEachSetBit(block, _mask[block], visitor);
     }
 
-    static constexpr uint32 GetBlockFlag(uint32 bit)
+    void AppendToPacket(ByteBuffer* data)
     {
-        return 1u << (bit % 32);
+        *data << uint8(_usedBlockCount);
+        if (_usedBlockCount)
+            data->append(&_mask[0], _usedBlockCount);
     }
 
-    std::unique_ptr<ClientUpdateMaskType[]> _mask;
-    uint32 _lastSetBit;
+private:
+    std::array<ClientUpdateMaskType, UpdateMask::CalculateBlockCount(PLAYER_END)> _mask;
+    uint32 _blockCount;
+    uint32 _usedBlockCount;
 };
 
 #endif
@@ -6269,6 +6269,11 @@ void Player::SendDirectMessage(WorldPacket const* data) const
     m_session->SendPacket(data);
 }
 
+void Player::SendDirectMessage(WorldPacket&& data) const
+{
+    m_session->SendPacket(std::move(data));
+}
+
 void Player::SendCinematicStart(uint32 CinematicSequenceId) const
 {
     WorldPackets::Misc::TriggerCinematic packet;
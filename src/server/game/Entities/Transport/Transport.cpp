@@ -762,8 +762,9 @@ void Transport::BuildUpdate(UpdateDataMapType& data_map)
     if (players.isEmpty())
         return;
 
+    ValuesUpdateBlockCache valuesBlocks;
     for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
-        BuildFieldsUpdate(itr->GetSource(), data_map);
+        BuildFieldsUpdate(itr->GetSource(), data_map, &valuesBlocks);
 
     ClearUpdateMask(true);
 }
@@ -40,6 +40,7 @@
 #include "GameTime.h"
 #include "GridNotifiersImpl.h"
 #include "Group.h"
+#include "IVMapManager.h"
 #include "InstanceSaveMgr.h"
 #include "InstanceScript.h"
 #include "Item.h"
@@ -10612,11 +10613,21 @@ Unit* Unit::SelectNearbyTarget(Unit* exclude, float dist) const
     if (exclude)
         targets.remove(exclude);
 
-    // remove not LoS targets
-    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end();)
+    targets.remove_if([](Unit* target) { return target->IsTotem() || target->IsSpiritService() || target->IsCritter(); });
+
+    // remove not LoS targets, all rays are checked in one batch
+    std::vector<VMAP::LineOfSightQuery> queries(targets.size());
+    std::size_t i = 0;
+    for (Unit* target : targets)
+        GetLineOfSightQuery(target, queries[i++]);
+
+    GetMap()->isInLineOfSight(queries, GetPhaseMask(), LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::Nothing);
+
+    auto query = queries.begin();
+    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end(); ++query)
     {
-        if (!IsWithinLOSInMap(*tIter) || (*tIter)->IsTotem() || (*tIter)->IsSpiritService() || (*tIter)->IsCritter())
-            targets.erase(tIter++);
+        if (!query->inLineOfSight)
+            tIter = targets.erase(tIter);
         else
             ++tIter;
     }
@@ -13441,11 +13452,6 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player const* t
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
-
-    UpdateMaskPacketBuilder updateMask(m_valuesCount);
-
-    uint32* flags = UnitUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
     if (target == this)
@@ -13462,142 +13468,166 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player const* t
     if (plr && plr->IsInSameRaidWith(target))
         visibleFlag |= UF_FLAG_PARTY_MEMBER;
 
-    Creature const* creature = ToCreature();
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMaskPacketBuilder updateMask(m_valuesCount);
+    BuildValuesUpdateMask(updateType, UnitUpdateFieldFlags, visibleFlag, _fieldNotifyFlags | (visibleFlag & UF_FLAG_SPECIAL_INFO), updateMask);
+    if (HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK))
+        updateMask.SetBit(UNIT_FIELD_AURASTATE);
+
+    updateMask.AppendToPacket(data);
+    updateMask.ForEachSetBit([&](uint16 index)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK)))
+        if (IsUpdateFieldTargetDependent(index))
+            *data << GetUpdateFieldValueForTarget(index, target);
+        // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+        else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
         {
-            updateMask.SetBit(index);
+            // convert from float to uint32 and send
+            *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+        }
+        // there are some float values which may be negative or can't get negative due to other checks
+        else if ((index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4) ||
+            (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+            (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+            (index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4))
+        {
+            *data << uint32(m_floatValues[index]);
+        }
+        else
+        {
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
+        }
+    });
+}
 
-            if (index == UNIT_NPC_FLAGS)
-            {
-                uint32 appendValue = m_uint32Values[UNIT_NPC_FLAGS];
+bool Unit::IsUpdateFieldTargetDependent(uint16 index) const
+{
+    switch (index)
+    {
+        case UNIT_NPC_FLAGS:
+        case UNIT_FIELD_AURASTATE:
+        case UNIT_FIELD_FLAGS:
+        case UNIT_FIELD_DISPLAYID:
+        case UNIT_DYNAMIC_FLAGS:
+        case UNIT_FIELD_BYTES_2:
+        case UNIT_FIELD_FACTIONTEMPLATE:
+            return true;
+        default:
+            break;
+    }
 
-                if (creature)
-                    if (!target->CanSeeSpellClickOn(creature))
-                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+    return false;
+}
 
-                fieldBuffer << uint32(appendValue);
-            }
-            else if (index == UNIT_FIELD_AURASTATE)
-            {
-                // Check per caster aura states to not enable using a spell in client if specified aura is not by target
-                fieldBuffer << BuildAuraStateUpdateForTarget(target);
-            }
-            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-            {
-                // convert from float to uint32 and send
-                fieldBuffer << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
-            }
-            // there are some float values which may be negative or can't get negative due to other checks
-            else if ((index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4) ||
-                (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                (index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4))
-            {
-                fieldBuffer << uint32(m_floatValues[index]);
-            }
+uint32 Unit::GetUpdateFieldValueForTarget(uint16 index, Player const* target) const
+{
+    Creature const* creature = ToCreature();
+    switch (index)
+    {
+        case UNIT_NPC_FLAGS:
+        {
+            uint32 appendValue = m_uint32Values[UNIT_NPC_FLAGS];
+
+            if (creature)
+                if (!target->CanSeeSpellClickOn(creature))
+                    appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+
+            return appendValue;
+        }
+        case UNIT_FIELD_AURASTATE:
+            // Check per caster aura states to not enable using a spell in client if specified aura is not by target
+            return BuildAuraStateUpdateForTarget(target);
+        case UNIT_FIELD_FLAGS:
+        {
             // Gamemasters should be always able to interact with units - remove uninteractible flag
-            else if (index == UNIT_FIELD_FLAGS)
-            {
-                uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
-                if (target->IsGameMaster())
-                    appendValue &= ~UNIT_FLAG_UNINTERACTIBLE;
+            uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
+            if (target->IsGameMaster())
+                appendValue &= ~UNIT_FLAG_UNINTERACTIBLE;
 
-                fieldBuffer << uint32(appendValue);
-            }
+            return appendValue;
+        }
+        case UNIT_FIELD_DISPLAYID:
+        {
             // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-            else if (index == UNIT_FIELD_DISPLAYID)
+            uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAYID];
+            if (creature)
             {
-                uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAYID];
-                if (creature)
-                {
-                    CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
+                CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
 
-                    // this also applies for transform auras
-                    if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(GetTransformSpell()))
+                // this also applies for transform auras
+                if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(GetTransformSpell()))
+                {
+                    for (SpellEffectInfo const& spellEffectInfo : transform->GetEffects())
                     {
-                        for (SpellEffectInfo const& spellEffectInfo : transform->GetEffects())
+                        if (spellEffectInfo.IsAura(SPELL_AURA_TRANSFORM))
                         {
-                            if (spellEffectInfo.IsAura(SPELL_AURA_TRANSFORM))
+                            if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(spellEffectInfo.MiscValue))
                             {
-                                if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(spellEffectInfo.MiscValue))
-                                {
-                                    cinfo = transformInfo;
-                                    break;
-                                }
+                                cinfo = transformInfo;
+                                break;
                             }
                         }
                     }
-
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
-                        if (target->IsGameMaster())
-                            displayId = cinfo->GetFirstVisibleModel();
                 }
 
-                fieldBuffer << uint32(displayId);
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                    if (target->IsGameMaster())
+                        displayId = cinfo->GetFirstVisibleModel();
             }
+
+            return displayId;
+        }
+        case UNIT_DYNAMIC_FLAGS:
+        {
             // hide lootable animation for unallowed players
-            else if (index == UNIT_DYNAMIC_FLAGS)
-            {
-                uint32 dynamicFlags = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+            uint32 dynamicFlags = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
 
-                if (creature)
+            if (creature)
+            {
+                if (creature->hasLootRecipient())
                 {
-                    if (creature->hasLootRecipient())
-                    {
-                        dynamicFlags |= UNIT_DYNFLAG_TAPPED;
-                        if (creature->isTappedBy(target))
-                            dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                    }
-
-                    if (!target->isAllowedToLoot(creature))
-                        dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
+                    dynamicFlags |= UNIT_DYNFLAG_TAPPED;
+                    if (creature->isTappedBy(target))
+                        dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
                 }
 
-                // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
-                if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
-                    if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
-                        dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
-
-                fieldBuffer << dynamicFlags;
+                if (!target->isAllowedToLoot(creature))
+                    dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
             }
+
+            // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
+            if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
+                if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
+                    dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
+
+            return dynamicFlags;
+        }
+        case UNIT_FIELD_BYTES_2:
+        case UNIT_FIELD_FACTIONTEMPLATE:
+        {
             // FG: pretend that OTHER players in own group are friendly ("blue")
-            else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
+            if (IsControlledByPlayer() && target != this && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
             {
-                if (IsControlledByPlayer() && target != this && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
+                FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
+                FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
+                if (!ft1->IsFriendlyTo(*ft2))
                 {
-                    FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
-                    FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
-                    if (!ft1->IsFriendlyTo(*ft2))
-                    {
-                        if (index == UNIT_FIELD_BYTES_2)
-                            // Allow targetting opposite faction in party when enabled in config
-                            fieldBuffer << (m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8)); // this flag is at uint8 offset 1 !!
-                        else
-                            // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                            fieldBuffer << uint32(target->GetFaction());
-                    }
+                    if (index == UNIT_FIELD_BYTES_2)
+                        // Allow targetting opposite faction in party when enabled in config
+                        return m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8); // this flag is at uint8 offset 1 !!
                     else
-                        fieldBuffer << m_uint32Values[index];
+                        // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                        return target->GetFaction();
                 }
-                else
-                    fieldBuffer << m_uint32Values[index];
-            }
-            else
-            {
-                // send in current format (float as float, uint32 as uint32)
-                fieldBuffer << m_uint32Values[index];
             }
+
+            return m_uint32Values[index];
         }
+        default:
+            break;
     }
 
-    updateMask.AppendToPacket(data);
-    data->append(fieldBuffer);
+    return m_uint32Values[index];
 }
 
 void Unit::DestroyForPlayer(Player* target, bool onDeath) const
@@ -835,7 +835,7 @@ class TC_GAME_API Unit : public WorldObject
         bool CanDualWield() const { return m_canDualWield; }
         virtual void SetCanDualWield(bool value) { m_canDualWield = value; }
         float GetCombatReach() const override { return GetFloatValue(UNIT_FIELD_COMBATREACH); }
-        void SetCombatReach(float combatReach) { SetFloatValue(UNIT_FIELD_COMBATREACH, combatReach); }
+        void SetCombatReach(float combatReach) { SetFloatValue(UNIT_FIELD_COMBATREACH, combatReach); UpdateCellIndex(); }
         float GetBoundingRadius() const { return GetFloatValue(UNIT_FIELD_BOUNDINGRADIUS); }
         void SetBoundingRadius(float boundingRadius) { SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, boundingRadius); }
         bool IsWithinCombatRange(Unit const* obj, float dist2compare) const;
@@ -1834,6 +1834,8 @@ class TC_GAME_API Unit : public WorldObject
         explicit Unit (bool isWorldObject);
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player const* target) const override;
+        bool IsUpdateFieldTargetDependent(uint16 index) const override;
+        uint32 GetUpdateFieldValueForTarget(uint16 index, Player const* target) const override;
         void DestroyForPlayer(Player* target, bool onDeath) const override;
 
         void _UpdateSpells(uint32 time);
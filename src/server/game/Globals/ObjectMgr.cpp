@@ -57,6 +57,7 @@
 #include "Util.h"
 #include "Vehicle.h"
 #include "World.h"
+#include "WorldDatabaseSnapshot.h"
 
 ScriptMapMap sSpellScripts;
 ScriptMapMap sEventScripts;
@@ -2171,8 +2172,11 @@ void ObjectMgr::LoadCreatures()
 {
     uint32 oldMSTime = getMSTime();
 
-    //                                               0              1   2    3           4           5           6            7        8             9              10
-    QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, position_x, position_y, position_z, orientation, modelid, equipment_id, spawntimesecs, wander_distance, "
+    auto rows = sWorldDatabaseSnapshot->Query<ObjectGuid::LowType, uint32, uint16, float, float, float, float, uint32, int8, uint32, float,
+        uint32, uint32, uint32, uint8, uint8, uint32, int8, uint32, uint32, uint32, uint32,
+        std::string, std::string, float>("creature",
+    //          0              1   2    3           4           5           6            7        8             9              10
+        "SELECT creature.guid, id, map, position_x, position_y, position_z, orientation, modelid, equipment_id, spawntimesecs, wander_distance, "
     //   11               12         13       14            15         16          17          18                19                   20                    21
         "currentwaypoint, curhealth, curmana, MovementType, spawnMask, phaseMask, eventEntry, poolSpawnId, creature.npcflag, creature.unit_flags, creature.dynamicflags, "
     //   22                   23
@@ -2181,7 +2185,7 @@ void ObjectMgr::LoadCreatures()
         "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
         "LEFT OUTER JOIN pool_members ON pool_members.type = 0 AND creature.guid = pool_members.spawnId");
 
-    if (!result)
+    if (rows.empty())
     {
         TC_LOG_INFO("server.loading", ">> Loaded 0 creatures. DB table `creature` is empty.");
         return;
@@ -2195,15 +2199,12 @@ void ObjectMgr::LoadCreatures()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    _creatureDataStore.rehash(result->GetRowCount());
+    _creatureDataStore.rehash(rows.size());
 
-    do
+    for (auto& [guid, entry, mapId, posX, posY, posZ, orientation, displayId, equipmentId, spawntimesecs, wanderDistance,
+        currentWaypoint, curHealth, curMana, movementType, spawnMask, phaseMask, gameEvent, PoolId, npcflag, unitFlags, dynamicFlags,
+        scriptName, stringId, size] : rows)
     {
-        Field* fields = result->Fetch();
-
-        ObjectGuid::LowType guid = fields[0].GetUInt32();
-        uint32 entry        = fields[1].GetUInt32();
-
         CreatureTemplate const* cInfo = GetCreatureTemplate(entry);
         if (!cInfo)
         {
@@ -2214,26 +2215,24 @@ void ObjectMgr::LoadCreatures()
         CreatureData& data = _creatureDataStore[guid];
         data.spawnId        = guid;
         data.id             = entry;
-        data.mapId          = fields[2].GetUInt16();
-        data.spawnPoint.Relocate(fields[3].GetFloat(), fields[4].GetFloat(), fields[5].GetFloat(), fields[6].GetFloat());
-        data.displayid      = fields[7].GetUInt32();
-        data.equipmentId    = fields[8].GetInt8();
-        data.spawntimesecs  = fields[9].GetUInt32();
-        data.wander_distance      = fields[10].GetFloat();
-        data.currentwaypoint= fields[11].GetUInt32();
-        data.curhealth      = fields[12].GetUInt32();
-        data.curmana        = fields[13].GetUInt32();
-        data.movementType   = fields[14].GetUInt8();
-        data.spawnMask      = fields[15].GetUInt8();
-        data.phaseMask      = fields[16].GetUInt32();
-        int16 gameEvent     = fields[17].GetInt8();
-        uint32 PoolId       = fields[18].GetUInt32();
-        data.npcflag        = fields[19].GetUInt32();
-        data.unit_flags     = fields[20].GetUInt32();
-        data.dynamicflags   = fields[21].GetUInt32();
-        data.scriptId       = GetScriptId(fields[22].GetString());
-        data.StringId       = fields[23].GetString();
-        data.size           = fields[24].GetFloat();
+        data.mapId          = mapId;
+        data.spawnPoint.Relocate(posX, posY, posZ, orientation);
+        data.displayid      = displayId;
+        data.equipmentId    = equipmentId;
+        data.spawntimesecs  = spawntimesecs;
+        data.wander_distance      = wanderDistance;
+        data.currentwaypoint= currentWaypoint;
+        data.curhealth      = curHealth;
+        data.curmana        = curMana;
+        data.movementType   = movementType;
+        data.spawnMask      = spawnMask;
+        data.phaseMask      = phaseMask;
+        data.npcflag        = npcflag;
+        data.unit_flags     = unitFlags;
+        data.dynamicflags   = dynamicFlags;
+        data.scriptId       = GetScriptId(scriptName);
+        data.StringId       = std::move(stringId);
+        data.size           = size;
         data.spawnGroupData = GetDefaultSpawnGroup();
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapId);
@@ -2346,7 +2345,6 @@ void ObjectMgr::LoadCreatures()
         if (gameEvent == 0 && PoolId == 0)
             AddCreatureToGrid(guid, &data);
     }
-    while (result->NextRow());
 
     TC_LOG_INFO("server.loading", ">> Loaded {} creatures in {} ms", _creatureDataStore.size(), GetMSTimeDiffToNow(oldMSTime));
 }
@@ -2494,8 +2492,11 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 oldMSTime = getMSTime();
 
-    //                                                0                1   2    3           4           5           6
-    QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
+    auto rows = sWorldDatabaseSnapshot->Query<ObjectGuid::LowType, uint32, uint16, float, float, float, float,
+        float, float, float, float, int32, uint8, uint8, uint8, uint32, int8, uint32,
+        std::string, std::string, float>("gameobject",
+    //          0                1   2    3           4           5           6
+        "SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
     //   7          8          9          10         11             12            13     14         15         16          17
         "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseMask, eventEntry, poolSpawnId, "
     //   18          19
@@ -2503,7 +2504,7 @@ void ObjectMgr::LoadGameObjects()
         "FROM gameobject LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
         "LEFT OUTER JOIN pool_members ON pool_members.type = 1 AND gameobject.guid = pool_members.spawnId");
 
-    if (!result)
+    if (rows.empty())
     {
         TC_LOG_INFO("server.loading", ">> Loaded 0 gameobjects. DB table `gameobject` is empty.");
         return;
@@ -2517,14 +2518,11 @@ void ObjectMgr::LoadGameObjects()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    _gameObjectDataStore.rehash(result->GetRowCount());
+    _gameObjectDataStore.rehash(rows.size());
 
-    do
+    for (auto& [guid, entry, mapId, posX, posY, posZ, orientation, rotationX, rotationY, rotationZ, rotationW,
+        spawntimesecs, animprogress, goState, spawnMask, phaseMask, gameEvent, PoolId, scriptName, stringId, size] : rows)
     {
-        Field* fields = result->Fetch();
-
-        ObjectGuid::LowType guid = fields[0].GetUInt32();
-        uint32 entry        = fields[1].GetUInt32();
 
         GameObjectTemplate const* gInfo = GetGameObjectTemplate(entry);
         if (!gInfo)
@@ -2556,13 +2554,13 @@ void ObjectMgr::LoadGameObjects()
 
         data.spawnId        = guid;
         data.id             = entry;
-        data.mapId          = fields[2].GetUInt16();
-        data.spawnPoint.Relocate(fields[3].GetFloat(), fields[4].GetFloat(), fields[5].GetFloat(), fields[6].GetFloat());
-        data.rotation.x     = fields[7].GetFloat();
-        data.rotation.y     = fields[8].GetFloat();
-        data.rotation.z     = fields[9].GetFloat();
-        data.rotation.w     = fields[10].GetFloat();
-        data.spawntimesecs  = fields[11].GetInt32();
+        data.mapId          = mapId;
+        data.spawnPoint.Relocate(posX, posY, posZ, orientation);
+        data.rotation.x     = rotationX;
+        data.rotation.y     = rotationY;
+        data.rotation.z     = rotationZ;
+        data.rotation.w     = rotationW;
+        data.spawntimesecs  = spawntimesecs;
         data.spawnGroupData = GetDefaultSpawnGroup();
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapId);
@@ -2577,10 +2575,10 @@ void ObjectMgr::LoadGameObjects()
             TC_LOG_ERROR("sql.sql", "Table `gameobject` has gameobject (GUID: {} Entry: {}) with `spawntimesecs` (0) value, but the gameobejct is marked as despawnable at action.", guid, data.id);
         }
 
-        data.animprogress   = fields[12].GetUInt8();
+        data.animprogress   = animprogress;
         data.artKit         = 0;
 
-        uint32 go_state     = fields[13].GetUInt8();
+        uint32 go_state     = goState;
         if (go_state >= MAX_GO_STATE)
         {
             TC_LOG_ERROR("sql.sql", "Table `gameobject` has gameobject (GUID: {} Entry: {}) with invalid `state` ({}) value, skip", guid, data.id, go_state);
@@ -2588,7 +2586,7 @@ void ObjectMgr::LoadGameObjects()
         }
         data.goState       = GOState(go_state);
 
-        data.spawnMask      = fields[14].GetUInt8();
+        data.spawnMask      = spawnMask;
 
         if (!IsTransportMap(data.mapId))
         {
@@ -2598,13 +2596,11 @@ void ObjectMgr::LoadGameObjects()
         else
             data.spawnGroupData = GetLegacySpawnGroup(); // force compatibility group for transport spawns
 
-        data.phaseMask      = fields[15].GetUInt32();
-        int16 gameEvent     = fields[16].GetInt8();
-        uint32 PoolId        = fields[17].GetUInt32();
+        data.phaseMask      = phaseMask;
 
-        data.scriptId = GetScriptId(fields[18].GetString());
-        data.StringId = fields[19].GetString();
-        data.size = fields[20].GetFloat();
+        data.scriptId = GetScriptId(scriptName);
+        data.StringId = std::move(stringId);
+        data.size = size;
 
         if (data.rotation.x < -1.0f || data.rotation.x > 1.0f)
         {
@@ -2666,7 +2662,6 @@ void ObjectMgr::LoadGameObjects()
         if (gameEvent == 0 && PoolId == 0)                      // if not this is to be managed by GameEvent System or Pool system
             AddGameobjectToGrid(guid, &data);
     }
-    while (result->NextRow());
 
     TC_LOG_INFO("server.loading", ">> Loaded {} gameobjects in {} ms", _gameObjectDataStore.size(), GetMSTimeDiffToNow(oldMSTime));
 }
@@ -0,0 +1,221 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldDatabaseSnapshot.h"
+#include "DatabaseEnv.h"
+#include "GitRevision.h"
+#include "Log.h"
+#include "Timer.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdio>
+#include <string_view>
+
+namespace
+{
+    constexpr uint32 SNAPSHOT_FORMAT_VERSION = 3;
+
+    struct SnapshotHeader
+    {
+        char Magic[4];
+        uint32 FormatVersion;
+        uint64 Version;
+        uint64 PayloadSize;
+    };
+
+    // FNV-1a
+    uint64 HashBytes(uint64 hash, std::string_view data)
+    {
+        for (char c : data)
+        {
+            hash ^= uint8(c);
+            hash *= UI64LIT(0x100000001B3);
+        }
+        return hash;
+    }
+}
+
+WorldDatabaseSnapshot::Reader::Reader() : _data(nullptr), _size(0), _position(0)
+{
+}
+
+WorldDatabaseSnapshot::Reader::~Reader() = default;
+
+bool WorldDatabaseSnapshot::Reader::ReadBytes(void* data, std::size_t size)
+{
+    if (size > _size - _position)
+    {
+        _position = _size;
+        return false;
+    }
+
+    if (size)
+        std::memcpy(data, _data + _position, size);
+    _position += size;
+    return true;
+}
+
+WorldDatabaseSnapshot* WorldDatabaseSnapshot::instance()
+{
+    static WorldDatabaseSnapshot instance;
+    return &instance;
+}
+
+void WorldDatabaseSnapshot::Initialize(std::string const& directory)
+{
+    _directory.clear();
+    _version = 0;
+
+    if (directory.empty())
+        return;
+
+    uint32 oldMSTime = getMSTime();
+
+    QueryResult result = WorldDatabase.Query("SELECT name, hash FROM updates ORDER BY name");
+    if (!result)
+    {
+        TC_LOG_ERROR("server.loading", "World database snapshots are disabled, the `updates` table of the world database is empty.");
+        return;
+    }
+
+    // the columns a loader reads can change with the core revision, so a snapshot is only valid for the one that wrote it
+    uint64 version = UI64LIT(0xCBF29CE484222325);
+    version = HashBytes(version, GitRevision::GetHash());
+    do
+    {
+        Field* fields = result->Fetch();
+        version = HashBytes(version, fields[0].GetStringView());
+        version = HashBytes(version, std::string_view("\0", 1));
+        version = HashBytes(version, fields[1].GetStringView());
+        version = HashBytes(version, std::string_view("\0", 1));
+    }
+    while (result->NextRow());
+
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        TC_LOG_ERROR("server.loading", "World database snapshots are disabled, could not create directory {}: {}", directory, error.message());
+        return;
+    }
+
+    _directory = directory;
+    _version = version;
+
+    TC_LOG_INFO("server.loading", ">> Using world database snapshots in {} (version {:016X}) in {} ms", _directory, _version, GetMSTimeDiffToNow(oldMSTime));
+}
+
+std::string WorldDatabaseSnapshot::GetFileName(std::string const& name) const
+{
+    return _directory + "/" + name + ".snapshot";
+}
+
+std::unique_ptr<WorldDatabaseSnapshot::Reader> WorldDatabaseSnapshot::Open(std::string const& name) const
+{
+    if (!IsEnabled() || !_reading)
+        return nullptr;
+
+    return OpenFile(GetFileName(name), _version);
+}
+
+void WorldDatabaseSnapshot::Save(std::string const& name, Writer const& writer) const
+{
+    if (!IsEnabled())
+        return;
+
+    SaveFile(GetFileName(name), _version, writer);
+}
+
+std::unique_ptr<WorldDatabaseSnapshot::Reader> WorldDatabaseSnapshot::OpenFile(std::string const& fileName, uint64 version)
+{
+    boost::system::error_code error;
+    if (!boost::filesystem::is_regular_file(fileName, error))
+        return nullptr;
+
+    std::unique_ptr<Reader> reader(new Reader());
+    try
+    {
+        boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+        reader->_region = std::make_unique<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot::OpenFile: could not map {} into memory ({}), loading from the database instead", fileName, e.what());
+        return nullptr;
+    }
+
+    uint8 const* data = static_cast<uint8 const*>(reader->_region->get_address());
+    std::size_t size = reader->_region->get_size();
+
+    SnapshotHeader header;
+    if (size < sizeof(header))
+        return nullptr;
+
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.Magic, "TCWS", 4) || header.FormatVersion != SNAPSHOT_FORMAT_VERSION || header.PayloadSize != size - sizeof(header))
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot::OpenFile: {} is corrupt, loading from the database instead", fileName);
+        return nullptr;
+    }
+
+    if (header.Version != version)
+    {
+        TC_LOG_INFO("server.loading", "World database snapshot {} is outdated, loading from the database instead", fileName);
+        return nullptr;
+    }
+
+    reader->_data = data + sizeof(header);
+    reader->_size = header.PayloadSize;
+    return reader;
+}
+
+bool WorldDatabaseSnapshot::SaveFile(std::string const& fileName, uint64 version, Writer const& writer)
+{
+    std::string tempFileName = fileName + ".tmp";
+
+    SnapshotHeader header;
+    std::memcpy(header.Magic, "TCWS", 4);
+    header.FormatVersion = SNAPSHOT_FORMAT_VERSION;
+    header.Version = version;
+    header.PayloadSize = writer._buffer.size();
+
+    FILE* out = fopen(tempFileName.c_str(), "wb");
+    if (!out)
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot::SaveFile: could not create {}", tempFileName);
+        return false;
+    }
+
+    bool success = fwrite(&header, sizeof(header), 1, out) == 1;
+    if (success && !writer._buffer.empty())
+        success = fwrite(writer._buffer.data(), writer._buffer.size(), 1, out) == 1;
+    success = fclose(out) == 0 && success;
+
+    boost::system::error_code error;
+    if (success)
+        boost::filesystem::rename(tempFileName, fileName, error);
+
+    if (!success || error)
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot::SaveFile: could not write {}", fileName);
+        boost::filesystem::remove(tempFileName, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,204 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_WORLDDATABASESNAPSHOT_H
+#define TRINITY_WORLDDATABASESNAPSHOT_H
+
+#include "Define.h"
+#include "DatabaseEnv.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+/// Binary copies of rows read from static world database tables, so a restart on unchanged data skips querying them.
+/// The rows are stored as the query returned them, loaders still validate them against the rest of the data on every start.
+/// Every snapshot is tagged with a hash of the world `updates` table and the core revision, applying sql updates invalidates all of them.
+class TC_GAME_API WorldDatabaseSnapshot
+{
+    public:
+        /// Sequential access to a memory mapped snapshot, every read fails once the payload is exhausted
+        class TC_GAME_API Reader
+        {
+            public:
+                ~Reader();
+
+                Reader(Reader const&) = delete;
+                Reader& operator=(Reader const&) = delete;
+
+                template<typename T>
+                bool Read(T& value)
+                {
+                    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be stored in a snapshot");
+                    return ReadBytes(&value, sizeof(T));
+                }
+
+                bool Read(std::string& value)
+                {
+                    uint32 length = 0;
+                    if (!Read(length) || length > _size - _position)
+                        return false;
+
+                    value.assign(reinterpret_cast<char const*>(_data + _position), length);
+                    _position += length;
+                    return true;
+                }
+
+                bool IsAtEnd() const { return _position == _size; }
+                std::size_t GetRemainingSize() const { return _size - _position; }
+
+            private:
+                friend class WorldDatabaseSnapshot;
+
+                Reader();
+
+                bool ReadBytes(void* data, std::size_t size);
+
+                std::unique_ptr<boost::interprocess::mapped_region> _region;
+                uint8 const* _data;
+                std::size_t _size;
+                std::size_t _position;
+        };
+
+        class Writer
+        {
+            public:
+                template<typename T>
+                void Write(T const& value)
+                {
+                    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be stored in a snapshot");
+                    WriteBytes(&value, sizeof(T));
+                }
+
+                void Write(std::string const& value)
+                {
+                    Write(uint32(value.length()));
+                    WriteBytes(value.data(), value.length());
+                }
+
+            private:
+                friend class WorldDatabaseSnapshot;
+
+                void WriteBytes(void const* data, std::size_t size)
+                {
+                    std::size_t offset = _buffer.size();
+                    _buffer.resize(offset + size);
+                    if (size)
+                        std::memcpy(_buffer.data() + offset, data, size);
+                }
+
+                std::vector<uint8> _buffer;
+        };
+
+        static WorldDatabaseSnapshot* instance();
+
+        /// An empty directory disables snapshots, otherwise their version is computed from the world database
+        void Initialize(std::string const& directory);
+        bool IsEnabled() const { return !_directory.empty(); }
+
+        /// nullptr if snapshots are disabled or the named one does not exist or was written for another version
+        std::unique_ptr<Reader> Open(std::string const& name) const;
+
+        /// Replaces the named snapshot, the data goes to a temporary file first so a crash never leaves a truncated one behind
+        void Save(std::string const& name, Writer const& writer) const;
+
+        /// Snapshots are only read while the server starts, reloads query the database and refresh the snapshots instead
+        void StopReading() { _reading = false; }
+
+        /// Rows of a static world table query, taken from the named snapshot when it is up to date.
+        /// Otherwise the query runs and its rows replace the snapshot.
+        template<typename... Columns>
+        std::vector<std::tuple<Columns...>> Query(std::string const& name, std::string const& sql) const
+        {
+            std::vector<std::tuple<Columns...>> rows;
+            if (std::unique_ptr<Reader> reader = Open(name))
+            {
+                if (ReadRows(*reader, rows))
+                    return rows;
+
+                rows.clear();
+            }
+
+            if (QueryResult result = WorldDatabase.Query(sql.c_str()))
+            {
+                rows.reserve(result->GetRowCount());
+                for (std::tuple<Columns...> row : result->Rows<Columns...>())
+                    rows.push_back(std::move(row));
+            }
+
+            if (IsEnabled())
+            {
+                Writer writer;
+                WriteRows(writer, rows);
+                Save(name, writer);
+            }
+
+            return rows;
+        }
+
+        /// Row storage behind Query, a string column is stored as its length followed by its characters
+        template<typename... Columns>
+        static void WriteRows(Writer& writer, std::vector<std::tuple<Columns...>> const& rows)
+        {
+            writer.Write(uint64(rows.size()));
+            for (std::tuple<Columns...> const& row : rows)
+                std::apply([&writer](Columns const&... columns) { (writer.Write(columns), ...); }, row);
+        }
+
+        /// Fails unless the rest of the payload holds exactly the rows
+        template<typename... Columns>
+        static bool ReadRows(Reader& reader, std::vector<std::tuple<Columns...>>& rows)
+        {
+            uint64 count = 0;
+            if (!reader.Read(count))
+                return false;
+
+            // every column takes at least one byte, a corrupt count must not reserve more than the file could hold
+            rows.reserve(std::min<uint64>(count, reader.GetRemainingSize()));
+            for (uint64 i = 0; i < count; ++i)
+            {
+                std::tuple<Columns...>& row = rows.emplace_back();
+                if (!std::apply([&reader](Columns&... columns) { return (reader.Read(columns) && ...); }, row))
+                    return false;
+            }
+
+            return reader.IsAtEnd();
+        }
+
+        /// Files behind Open and Save, for a snapshot of the given version
+        static std::unique_ptr<Reader> OpenFile(std::string const& fileName, uint64 version);
+        static bool SaveFile(std::string const& fileName, uint64 version, Writer const& writer);
+
+    private:
+        WorldDatabaseSnapshot() : _version(0), _reading(true) { }
+        ~WorldDatabaseSnapshot() { }
+
+        std::string GetFileName(std::string const& name) const;
+
+        std::string _directory;
+        uint64 _version;
+        bool _reading;
+};
+
+#define sWorldDatabaseSnapshot WorldDatabaseSnapshot::instance()
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CellObjectIndex.h"
+#include "Errors.h"
+#include "GridDefines.h"
+#include "Object.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CELL_OBJECT_INDEX_SSE2
+#endif
+
+namespace
+{
+    GridMapTypeMask GetGridMapTypeMask(WorldObject const* object)
+    {
+        switch (object->GetTypeId())
+        {
+            case TYPEID_UNIT:
+                return GRID_MAP_TYPE_MASK_CREATURE;
+            case TYPEID_PLAYER:
+                return GRID_MAP_TYPE_MASK_PLAYER;
+            case TYPEID_GAMEOBJECT:
+                return GRID_MAP_TYPE_MASK_GAMEOBJECT;
+            case TYPEID_DYNAMICOBJECT:
+                return GRID_MAP_TYPE_MASK_DYNAMICOBJECT;
+            case TYPEID_CORPSE:
+                return GRID_MAP_TYPE_MASK_CORPSE;
+            default:
+                break;
+        }
+
+        ABORT_MSG("CellObjectIndex: object %s can not be stored in a grid", object->GetGUID().ToString().c_str());
+        return GRID_MAP_TYPE_MASK_ALL;
+    }
+
+    float GetSearchReach(WorldObject const* object)
+    {
+        // gameobjects are matched by their model bounds, keep everything but units out of distance filtering
+        if (!object->IsUnit())
+            return std::numeric_limits<float>::infinity();
+
+        return object->GetCombatReach();
+    }
+}
+
+CellObjectIndex::~CellObjectIndex()
+{
+    for (WorldObject* object : _objects)
+        object->m_cellIndexSlot = CellObjectIndexSlot();
+}
+
+void CellObjectIndex::Insert(WorldObject* object)
+{
+    ASSERT(!object->m_cellIndexSlot.Index);
+
+    object->m_cellIndexSlot.Index = this;
+    object->m_cellIndexSlot.Position = uint32(_objects.size());
+
+    _x.push_back(object->GetPositionX());
+    _y.push_back(object->GetPositionY());
+    _reach.push_back(GetSearchReach(object));
+    _phaseMask.push_back(object->GetPhaseMask());
+    _typeMask.push_back(GetGridMapTypeMask(object));
+    _objects.push_back(object);
+}
+
+void CellObjectIndex::Remove(WorldObject* object)
+{
+    ASSERT(object->m_cellIndexSlot.Index == this);
+
+    // move the last object into the freed slot
+    uint32 position = object->m_cellIndexSlot.Position;
+    uint32 last = uint32(_objects.size() - 1);
+    if (position != last)
+    {
+        _x[position] = _x[last];
+        _y[position] = _y[last];
+        _reach[position] = _reach[last];
+        _phaseMask[position] = _phaseMask[last];
+        _typeMask[position] = _typeMask[last];
+        _objects[position] = _objects[last];
+        _objects[position]->m_cellIndexSlot.Position = position;
+    }
+
+    _x.pop_back();
+    _y.pop_back();
+    _reach.pop_back();
+    _phaseMask.pop_back();
+    _typeMask.pop_back();
+    _objects.pop_back();
+
+    object->m_cellIndexSlot = CellObjectIndexSlot();
+}
+
+void CellObjectIndex::Update(WorldObject const* object)
+{
+    uint32 position = object->m_cellIndexSlot.Position;
+    _x[position] = object->GetPositionX();
+    _y[position] = object->GetPositionY();
+    _reach[position] = GetSearchReach(object);
+    _phaseMask[position] = object->GetPhaseMask();
+}
+
+uint32 CellObjectIndex::Filter(uint32 begin, float x, float y, float radius, uint32 typeMask, uint32 phaseMask, uint32* candidates) const
+{
+    uint32 end = std::min<uint32>(begin + FILTER_BATCH_SIZE, uint32(_objects.size()));
+    uint32 count = 0;
+    uint32 i = begin;
+
+#ifdef CELL_OBJECT_INDEX_SSE2
+    __m128 const centerX = _mm_set1_ps(x);
+    __m128 const centerY = _mm_set1_ps(y);
+    __m128 const searchRadius = _mm_set1_ps(radius);
+    __m128i const types = _mm_set1_epi32(int32(typeMask));
+    __m128i const phases = _mm_set1_epi32(int32(phaseMask));
+    __m128i const noPhaseFilter = _mm_set1_epi32(phaseMask ? 0 : -1);
+    __m128i const zero = _mm_setzero_si128();
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&_x[i]), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&_y[i]), centerY);
+        __m128 limit = _mm_add_ps(_mm_loadu_ps(&_reach[i]), searchRadius);
+        __m128 inRange = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(limit, limit));
+
+        __m128i typeMatch = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&_typeMask[i])), types), zero);
+        __m128i phaseMatch = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&_phaseMask[i])), phases), zero);
+        // both compares are set for mismatches
+        __m128i rejected = _mm_or_si128(typeMatch, _mm_andnot_si128(noPhaseFilter, phaseMatch));
+
+        int mask = _mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(rejected), inRange));
+        for (uint32 j = 0; mask; ++j, mask >>= 1)
+            if (mask & 1)
+                candidates[count++] = i + j;
+    }
+#endif
+
+    for (; i < end; ++i)
+    {
+        if (!(_typeMask[i] & typeMask))
+            continue;
+
+        if (phaseMask && !(_phaseMask[i] & phaseMask))
+            continue;
+
+        float dx = _x[i] - x;
+        float dy = _y[i] - y;
+        float limit = radius + _reach[i];
+        if (dx * dx + dy * dy > limit * limit)
+            continue;
+
+        candidates[count++] = i;
+    }
+
+    return count;
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_CELLOBJECTINDEX_H
+#define TRINITY_CELLOBJECTINDEX_H
+
+#include "Define.h"
+#include <array>
+#include <vector>
+
+class CellObjectIndex;
+class WorldObject;
+
+// place of an object in the index of the cell it is stored in
+struct CellObjectIndexSlot
+{
+    CellObjectIndex* Index = nullptr;
+    uint32 Position = 0;
+};
+
+/*
+ * Packed positions of the objects of one cell container, kept in sync by the Map::*Relocation functions.
+ * Range searches filter the whole cell with a few vector compares and only dereference the objects that
+ * can be in range. Only units are filtered by distance (radius + combat reach in 2D, so it never rejects
+ * what a 3D or cylinder check would accept), other object types are always passed to the caller.
+ */
+class TC_GAME_API CellObjectIndex
+{
+    public:
+        CellObjectIndex() = default;
+        ~CellObjectIndex();
+
+        CellObjectIndex(CellObjectIndex const&) = delete;
+        CellObjectIndex& operator=(CellObjectIndex const&) = delete;
+
+        void Insert(WorldObject* object);
+        void Remove(WorldObject* object);
+        void Update(WorldObject const* object);
+
+        std::size_t GetSize() const { return _objects.size(); }
+
+        /// Calls callback(WorldObject*, GridMapTypeMask) for every candidate until it returns false,
+        /// phaseMask 0 does not filter phases
+        template<class Callback>
+        void Visit(float x, float y, float radius, uint32 typeMask, uint32 phaseMask, Callback&& callback) const
+        {
+            std::array<uint32, FILTER_BATCH_SIZE> candidates;
+            for (uint32 begin = 0; begin < _objects.size(); begin += FILTER_BATCH_SIZE)
+            {
+                uint32 count = Filter(begin, x, y, radius, typeMask, phaseMask, candidates.data());
+                for (uint32 i = 0; i < count; ++i)
+                    if (!callback(_objects[candidates[i]], _typeMask[candidates[i]]))
+                        return;
+            }
+        }
+
+    private:
+        static constexpr uint32 FILTER_BATCH_SIZE = 64;
+
+        uint32 Filter(uint32 begin, float x, float y, float radius, uint32 typeMask, uint32 phaseMask, uint32* candidates) const;
+
+        std::vector<float> _x;
+        std::vector<float> _y;
+        std::vector<float> _reach;                      // combat reach of units, infinity for objects never filtered by distance
+        std::vector<uint32> _phaseMask;
+        std::vector<uint32> _typeMask;
+        std::vector<WorldObject*> _objects;
+};
+
+#endif
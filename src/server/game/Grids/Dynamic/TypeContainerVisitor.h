@@ -91,6 +91,16 @@ class TypeContainerVisitor
             VisitorHelper(i_visitor, c);
         }
 
+        // visitors providing VisitIndex only get the objects of the index that can be inside their own search area
+        template<class INDEX>
+        void Visit(TYPE_CONTAINER& c, INDEX const& index)
+        {
+            if constexpr (requires { i_visitor.VisitIndex(index); })
+                i_visitor.VisitIndex(index);
+            else
+                VisitorHelper(i_visitor, c);
+        }
+
         void Visit(TYPE_CONTAINER const& c) const
         {
             VisitorHelper(i_visitor, c);
@@ -30,6 +30,7 @@
 */
 
 #include "Define.h"
+#include "CellObjectIndex.h"
 #include "TypeContainer.h"
 #include "TypeContainerVisitor.h"
 
@@ -59,6 +60,7 @@ class Grid
         {
             i_objects.template insert<SPECIFIC_OBJECT>(obj);
             ASSERT(obj->IsInGrid());
+            i_objectIndex.Insert(obj);
         }
 
         /** an object of interested exits the grid
@@ -87,14 +89,14 @@ class Grid
         template<class T>
         void Visit(TypeContainerVisitor<T, TypeMapContainer<GRID_OBJECT_TYPES> > &visitor)
         {
-            visitor.Visit(i_container);
+            visitor.Visit(i_container, i_containerIndex);
         }
 
         // Visit world objects
         template<class T>
         void Visit(TypeContainerVisitor<T, TypeMapContainer<WORLD_OBJECT_TYPES> > &visitor)
         {
-            visitor.Visit(i_objects);
+            visitor.Visit(i_objects, i_objectIndex);
         }
 
         /** Returns the number of object within the grid.
@@ -112,6 +114,7 @@ class Grid
         {
             i_container.template insert<SPECIFIC_OBJECT>(obj);
             ASSERT(obj->IsInGrid());
+            i_containerIndex.Insert(obj);
         }
 
         /** Removes a containter type object from the grid
@@ -136,6 +139,9 @@ class Grid
 
         TypeMapContainer<GRID_OBJECT_TYPES> i_container;
         TypeMapContainer<WORLD_OBJECT_TYPES> i_objects;
+        // objects leave them in GridObject::RemoveFromGrid
+        CellObjectIndex i_containerIndex;
+        CellObjectIndex i_objectIndex;
         //typedef std::set<void*> ActiveGridObjects;
         //ActiveGridObjects m_activeGridObjects;
 };
@@ -199,6 +199,32 @@ namespace Trinity
 
     // SEARCHERS & LIST SEARCHERS & WORKERS
 
+    // Searchers whose Check declares "static constexpr bool IsRangeLimited = true" are visited through the cell
+    // position index (see CellObjectIndex). Such a check must reject every unit further away from GetSearchCenter()
+    // than GetSearchRadius() plus the unit's combat reach, units outside of it are never passed to it.
+
+    // Object taken from a cell position index cast back to its own type, only types in TypeMask are expected
+    template<uint32 TypeMask, class Visitor>
+    bool VisitIndexedObject(WorldObject* object, uint32 typeMask, Visitor&& visitor)
+    {
+        if constexpr ((TypeMask & GRID_MAP_TYPE_MASK_CORPSE) != 0)
+            if (typeMask == GRID_MAP_TYPE_MASK_CORPSE)
+                return visitor(static_cast<Corpse*>(object));
+        if constexpr ((TypeMask & GRID_MAP_TYPE_MASK_CREATURE) != 0)
+            if (typeMask == GRID_MAP_TYPE_MASK_CREATURE)
+                return visitor(static_cast<Creature*>(object));
+        if constexpr ((TypeMask & GRID_MAP_TYPE_MASK_DYNAMICOBJECT) != 0)
+            if (typeMask == GRID_MAP_TYPE_MASK_DYNAMICOBJECT)
+                return visitor(static_cast<DynamicObject*>(object));
+        if constexpr ((TypeMask & GRID_MAP_TYPE_MASK_GAMEOBJECT) != 0)
+            if (typeMask == GRID_MAP_TYPE_MASK_GAMEOBJECT)
+                return visitor(static_cast<GameObject*>(object));
+        if constexpr ((TypeMask & GRID_MAP_TYPE_MASK_PLAYER) != 0)
+            if (typeMask == GRID_MAP_TYPE_MASK_PLAYER)
+                return visitor(static_cast<Player*>(object));
+        return true;
+    }
+
     // WorldObject searchers & workers
     enum class WorldObjectSearcherContinuation
     {
@@ -288,6 +314,8 @@ namespace Trinity
 
         template<class T>
         void Visit(GridRefManager<T>&);
+
+        void VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited;
     };
 
     template<class Check>
@@ -410,6 +438,8 @@ namespace Trinity
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) { }
 
+        void VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited;
+
     private:
         template<class T> void VisitImpl(GridRefManager<T>& m);
     };
@@ -454,6 +484,8 @@ namespace Trinity
         void Visit(CreatureMapType& m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) { }
+
+        void VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited;
     };
 
     template<class Check>
@@ -513,6 +545,8 @@ namespace Trinity
         void Visit(PlayerMapType& m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) { }
+
+        void VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited;
     };
 
     template<class Check>
@@ -955,8 +989,13 @@ namespace Trinity
     class AnyUnfriendlyUnitInObjectRangeCheck
     {
         public:
+            static constexpr bool IsRangeLimited = true;
+
             AnyUnfriendlyUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range) : i_obj(obj), i_funit(funit), i_range(range) { }
 
+            Position const* GetSearchCenter() const { return i_obj; }
+            float GetSearchRadius() const { return i_range + i_obj->GetCombatReach(); }
+
             bool operator()(Unit* u) const
             {
                 if (u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range) && !i_funit->IsFriendlyTo(u))
@@ -1005,9 +1044,14 @@ namespace Trinity
     class AnyFriendlyUnitInObjectRangeCheck
     {
         public:
+            static constexpr bool IsRangeLimited = true;
+
             AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range, bool playerOnly = false, bool incOwnRadius = true, bool incTargetRadius = true)
                 : i_obj(obj), i_funit(funit), i_range(range), i_playerOnly(playerOnly), i_incOwnRadius(incOwnRadius), i_incTargetRadius(incTargetRadius) { }
 
+            Position const* GetSearchCenter() const { return i_obj; }
+            float GetSearchRadius() const { return i_range + (i_incOwnRadius ? i_obj->GetCombatReach() : 0.0f); }
+
             bool operator()(Unit* u) const
             {
                 if (!u->IsAlive())
@@ -1084,8 +1128,13 @@ namespace Trinity
     class AnyUnitInObjectRangeCheck
     {
         public:
+            static constexpr bool IsRangeLimited = true;
+
             AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) { }
 
+            Position const* GetSearchCenter() const { return i_obj; }
+            float GetSearchRadius() const { return i_range + i_obj->GetCombatReach(); }
+
             bool operator()(Unit* u) const
             {
                 if (u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range))
@@ -1103,8 +1152,13 @@ namespace Trinity
     class NearestAttackableUnitInObjectRangeCheck
     {
         public:
+            static constexpr bool IsRangeLimited = true;
+
             NearestAttackableUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range) : i_obj(obj), i_funit(funit), i_range(range) { }
 
+            Position const* GetSearchCenter() const { return i_obj; }
+            float GetSearchRadius() const { return i_range + i_obj->GetCombatReach(); }
+
             bool operator()(Unit* u)
             {
                 if (u->isTargetableForAttack() && i_obj->IsWithinDistInMap(u, i_range) &&
@@ -1129,11 +1183,16 @@ namespace Trinity
     class AnyAoETargetUnitInObjectRangeCheck
     {
         public:
+            static constexpr bool IsRangeLimited = true;
+
             AnyAoETargetUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range, SpellInfo const* spellInfo = nullptr, bool incOwnRadius = true, bool incTargetRadius = true)
                 : i_obj(obj), i_funit(funit), _spellInfo(spellInfo), i_range(range), i_incOwnRadius(incOwnRadius), i_incTargetRadius(incTargetRadius)
             {
             }
 
+            Position const* GetSearchCenter() const { return i_obj; }
+            float GetSearchRadius() const { return i_range + (i_incOwnRadius ? i_obj->GetCombatReach() : 0.0f); }
+
             bool operator()(Unit* u) const
             {
                 // Check contains checks for: live, uninteractible, non-attackable flags, flight check and GM check, ignore totems
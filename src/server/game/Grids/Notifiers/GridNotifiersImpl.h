@@ -63,6 +63,26 @@ void Trinity::WorldObjectSearcherBase<Check, Result>::Visit(GridRefManager<T>& m
     }
 }
 
+template <class Check, class Result>
+void Trinity::WorldObjectSearcherBase<Check, Result>::VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited
+{
+    if (this->ShouldContinue() == WorldObjectSearcherContinuation::Return)
+        return;
+
+    Position const* center = i_check.GetSearchCenter();
+    index.Visit(center->GetPositionX(), center->GetPositionY(), i_check.GetSearchRadius(), i_mapTypeMask, 0, [&](WorldObject* object, uint32 typeMask)
+    {
+        return VisitIndexedObject<GRID_MAP_TYPE_MASK_ALL>(object, typeMask, [&](auto* source)
+        {
+            if (!i_check(source))
+                return true;
+
+            this->Insert(source);
+            return this->ShouldContinue() == WorldObjectSearcherContinuation::Continue;
+        });
+    });
+}
+
 // Gameobject searchers
 
 template <class Check, class Result>
@@ -110,6 +130,26 @@ void Trinity::UnitSearcherBase<Check, Result>::VisitImpl(GridRefManager<T>& m)
     }
 }
 
+template <class Check, class Result>
+void Trinity::UnitSearcherBase<Check, Result>::VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited
+{
+    if (this->ShouldContinue() == WorldObjectSearcherContinuation::Return)
+        return;
+
+    Position const* center = i_check.GetSearchCenter();
+    index.Visit(center->GetPositionX(), center->GetPositionY(), i_check.GetSearchRadius(), GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_PLAYER, i_phaseMask, [&](WorldObject* object, uint32 typeMask)
+    {
+        return VisitIndexedObject<GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_PLAYER>(object, typeMask, [&](auto* source)
+        {
+            if (!i_check(source))
+                return true;
+
+            this->Insert(source);
+            return this->ShouldContinue() == WorldObjectSearcherContinuation::Continue;
+        });
+    });
+}
+
 // Creature searchers
 
 template <class Check, class Result>
@@ -133,6 +173,24 @@ void Trinity::CreatureSearcherBase<Check, Result>::Visit(CreatureMapType& m)
     }
 }
 
+template <class Check, class Result>
+void Trinity::CreatureSearcherBase<Check, Result>::VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited
+{
+    if (this->ShouldContinue() == WorldObjectSearcherContinuation::Return)
+        return;
+
+    Position const* center = i_check.GetSearchCenter();
+    index.Visit(center->GetPositionX(), center->GetPositionY(), i_check.GetSearchRadius(), GRID_MAP_TYPE_MASK_CREATURE, i_phaseMask, [&](WorldObject* object, uint32 /*typeMask*/)
+    {
+        Creature* creature = static_cast<Creature*>(object);
+        if (!i_check(creature))
+            return true;
+
+        this->Insert(creature);
+        return this->ShouldContinue() == WorldObjectSearcherContinuation::Continue;
+    });
+}
+
 // Player searchers
 
 template <class Check, class Result>
@@ -156,6 +214,24 @@ void Trinity::PlayerSearcherBase<Check, Result>::Visit(PlayerMapType& m)
     }
 }
 
+template <class Check, class Result>
+void Trinity::PlayerSearcherBase<Check, Result>::VisitIndex(CellObjectIndex const& index) requires Check::IsRangeLimited
+{
+    if (this->ShouldContinue() == WorldObjectSearcherContinuation::Return)
+        return;
+
+    Position const* center = i_check.GetSearchCenter();
+    index.Visit(center->GetPositionX(), center->GetPositionY(), i_check.GetSearchRadius(), GRID_MAP_TYPE_MASK_PLAYER, i_phaseMask, [&](WorldObject* object, uint32 /*typeMask*/)
+    {
+        Player* player = static_cast<Player*>(object);
+        if (!i_check(player))
+            return true;
+
+        this->Insert(player);
+        return this->ShouldContinue() == WorldObjectSearcherContinuation::Continue;
+    });
+}
+
 template<class Builder>
 void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
 {
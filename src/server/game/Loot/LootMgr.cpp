@@ -29,6 +29,7 @@
 #include "SpellMgr.h"
 #include "Util.h"
 #include "World.h"
+#include "WorldDatabaseSnapshot.h"
 
 static Rates const qualityToRate[MAX_ITEM_QUALITY] =
 {
@@ -133,28 +134,17 @@ uint32 LootStore::LoadLootTable()
     // Clearing store (for reloading case)
     Clear();
 
-    //                                                  0     1            2               3         4         5             6
-    QueryResult result = WorldDatabase.PQuery("SELECT Entry, Item, Reference, Chance, QuestRequired, LootMode, GroupId, MinCount, MaxCount FROM {}", GetName());
+    auto rows = sWorldDatabaseSnapshot->Query<uint32, uint32, uint32, float, bool, uint16, uint8, uint8, uint8>(GetName(),
+    //                                0      1     2          3       4              5         6        7         8
+        Trinity::StringFormat("SELECT Entry, Item, Reference, Chance, QuestRequired, LootMode, GroupId, MinCount, MaxCount FROM {}", GetName()));
 
-    if (!result)
+    if (rows.empty())
         return 0;
 
     uint32 count = 0;
 
-    do
+    for (auto [entry, item, reference, chance, needsquest, lootmode, groupid, mincount, maxcount] : rows)
     {
-        Field* fields = result->Fetch();
-
-        uint32 entry               = fields[0].GetUInt32();
-        uint32 item                = fields[1].GetUInt32();
-        uint32 reference           = fields[2].GetUInt32();
-        float  chance              = fields[3].GetFloat();
-        bool   needsquest          = fields[4].GetBool();
-        uint16 lootmode            = fields[5].GetUInt16();
-        uint8  groupid             = fields[6].GetUInt8();
-        uint8  mincount            = fields[7].GetUInt8();
-        uint8  maxcount            = fields[8].GetUInt8();
-
         if (groupid >= 1 << 7)                                     // it stored in 7 bit field
         {
             TC_LOG_ERROR("sql.sql", "Table '{}' Entry {} Item {}: GroupId ({}) must be less {} - skipped", GetName(), entry, item, groupid, 1 << 7);
@@ -188,7 +178,6 @@ uint32 LootStore::LoadLootTable()
         tab->second->AddEntry(storeitem);
         ++count;
     }
-    while (result->NextRow());
 
     Verify();                                           // Checks validity of the loot store
 
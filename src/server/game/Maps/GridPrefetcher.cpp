@@ -0,0 +1,168 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GridPrefetcher.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapTree.h"
+#include "StringFormat.h"
+#include "TerrainFile.h"
+#include "ThreadPool.h"
+#include "World.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace
+{
+    // prefetched terrain that was not picked up because the players turned around
+    constexpr std::size_t MAX_READY_GRIDS = 64;
+
+    uint64 MakeGridKey(uint32 mapId, uint32 gx, uint32 gy)
+    {
+        return (uint64(mapId) << 32) | (gx << 16) | gy;
+    }
+
+    // pull the file into the page cache, the synchronous load on the map thread then does not wait for the disk
+    void ReadIntoPageCache(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return;
+
+        std::array<char, 0x10000> buffer;
+        while (fread(buffer.data(), 1, buffer.size(), file) == buffer.size())
+            ;
+
+        fclose(file);
+    }
+}
+
+GridPrefetcher::GridPrefetcher() : _stopping(false)
+{
+}
+
+GridPrefetcher::~GridPrefetcher()
+{
+    Deactivate();
+}
+
+void GridPrefetcher::Activate(std::size_t numThreads)
+{
+    _stopping = false;
+    _pool = std::make_unique<Trinity::ThreadPool>(numThreads);
+}
+
+void GridPrefetcher::Deactivate()
+{
+    if (!_pool)
+        return;
+
+    _stopping = true;
+    _pool->Join();
+    _pool.reset();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _grids.clear();
+    _readyGrids.clear();
+}
+
+void GridPrefetcher::Prefetch(uint32 mapId, uint32 gx, uint32 gy, bool prefetchVMap, bool prefetchMMap)
+{
+    if (!_pool)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_grids.emplace(MakeGridKey(mapId, gx, gy), PrefetchedGrid()).second)
+            return;
+    }
+
+    _pool->PostWork([this, mapId, gx, gy, prefetchVMap, prefetchMMap]()
+    {
+        LoadGrid(mapId, gx, gy, prefetchVMap, prefetchMMap);
+    });
+}
+
+std::unique_ptr<GridMap> GridPrefetcher::TakeTerrain(uint32 mapId, uint32 gx, uint32 gy)
+{
+    uint64 key = MakeGridKey(mapId, gx, gy);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _grids.find(key);
+    if (itr == _grids.end())
+        return nullptr;
+
+    // still loading, the map thread loads it on its own and the background result gets dropped
+    std::unique_ptr<GridMap> terrain = std::move(itr->second.Terrain);
+    if (itr->second.Ready)
+        _readyGrids.erase(std::find(_readyGrids.begin(), _readyGrids.end(), key));
+
+    _grids.erase(itr);
+    return terrain;
+}
+
+void GridPrefetcher::LoadGrid(uint32 mapId, uint32 gx, uint32 gy, bool prefetchVMap, bool prefetchMMap)
+{
+    if (_stopping)
+        return;
+
+    std::string const& dataPath = sWorld->GetDataPath();
+    std::string fileName = Trinity::StringFormat("{}maps/{:03}{:02}{:02}.map", dataPath, mapId, gx, gy);
+
+    // keeps the file in the shared cache while the terrain is being read from it
+    std::shared_ptr<TerrainFile const> file = TerrainFile::Open(fileName);
+    if (file)
+        file->TouchPages();
+
+    std::unique_ptr<GridMap> terrain = std::make_unique<GridMap>();
+    if (!terrain->loadData(fileName.c_str()))
+        terrain.reset();
+
+    if (prefetchVMap)
+        ReadIntoPageCache(dataPath + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, gx, gy));
+
+    if (prefetchMMap)
+        ReadIntoPageCache(Trinity::StringFormat("{}mmaps/{:03}{:02}{:02}.mmtile", dataPath, mapId, gx, gy));
+
+    uint64 key = MakeGridKey(mapId, gx, gy);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _grids.find(key);
+    if (itr == _grids.end())
+        return;
+
+    if (!terrain)
+    {
+        // let the map thread report the error when it loads the grid
+        _grids.erase(itr);
+        return;
+    }
+
+    itr->second.Terrain = std::move(terrain);
+    itr->second.Ready = true;
+    _readyGrids.push_back(key);
+
+    if (_readyGrids.size() > MAX_READY_GRIDS)
+    {
+        _grids.erase(_readyGrids.front());
+        _readyGrids.pop_front();
+    }
+
+    TC_LOG_DEBUG("maps", "GridPrefetcher: prefetched grid [{}, {}] of map {}", gx, gy, mapId);
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_GRIDPREFETCHER_H
+#define TRINITY_GRIDPREFETCHER_H
+
+#include "Define.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class GridMap;
+
+namespace Trinity
+{
+    class ThreadPool;
+}
+
+/// Reads terrain, vmap and mmap tiles of grids players are about to enter on background threads,
+/// so the map thread only has to pick up the prepared terrain and construct the grid objects
+class TC_GAME_API GridPrefetcher
+{
+    public:
+        GridPrefetcher();
+        ~GridPrefetcher();
+
+        GridPrefetcher(GridPrefetcher const&) = delete;
+        GridPrefetcher& operator=(GridPrefetcher const&) = delete;
+
+        void Activate(std::size_t numThreads);
+        void Deactivate();
+        bool IsActive() const { return _pool != nullptr; }
+
+        /// Queues loading of given grid (in map file coordinates), does nothing if it was already queued
+        void Prefetch(uint32 mapId, uint32 gx, uint32 gy, bool prefetchVMap, bool prefetchMMap);
+
+        /// Terrain loaded by a finished prefetch, nullptr if there is none and the caller has to load it on its own
+        std::unique_ptr<GridMap> TakeTerrain(uint32 mapId, uint32 gx, uint32 gy);
+
+    private:
+        struct PrefetchedGrid
+        {
+            std::unique_ptr<GridMap> Terrain;
+            bool Ready = false;
+        };
+
+        void LoadGrid(uint32 mapId, uint32 gx, uint32 gy, bool prefetchVMap, bool prefetchMMap);
+
+        std::unique_ptr<Trinity::ThreadPool> _pool;
+        std::atomic<bool> _stopping;
+
+        std::mutex _lock;
+        std::unordered_map<uint64, PrefetchedGrid> _grids;
+        std::deque<uint64> _readyGrids;                     // oldest first, bounds the amount of terrain nobody picked up
+};
+
+#endif
@@ -40,9 +40,11 @@
 #include "ObjectAccessor.h"
 #include "ObjectGridLoader.h"
 #include "ObjectMgr.h"
+#include "PathCache.h"
 #include "Pet.h"
 #include "PoolMgr.h"
 #include "ScriptMgr.h"
+#include "TerrainFile.h"
 #include "Transport.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
@@ -108,8 +110,6 @@ Map::~Map()
 
     if (!m_scriptSchedule.empty())
         sMapMgr->DecreaseScheduledScriptCount(m_scriptSchedule.size());
-
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), i_InstanceId);
 }
 
 bool Map::ExistMap(uint32 mapid, int gx, int gy)
@@ -232,11 +232,18 @@ void Map::LoadMap(int gx, int gy, bool reload)
 
     // map file name
     std::string fileName = Trinity::StringFormat("{}maps/{:03}{:02}{:02}.map", sWorld->GetDataPath(), GetId(), gx, gy);
-    TC_LOG_DEBUG("maps", "Loading map {}", fileName);
-    // loading data
-    GridMaps[gx][gy] = new GridMap();
-    if (!GridMaps[gx][gy]->loadData(fileName.c_str()))
-        TC_LOG_ERROR("maps", "Error loading map file: \n {}\n", fileName);
+    // terrain may already have been read in the background while players were approaching
+    if (!reload)
+        GridMaps[gx][gy] = sMapMgr->GetGridPrefetcher().TakeTerrain(GetId(), gx, gy).release();
+
+    if (!GridMaps[gx][gy])
+    {
+        TC_LOG_DEBUG("maps", "Loading map {}", fileName);
+        // loading data
+        GridMaps[gx][gy] = new GridMap();
+        if (!GridMaps[gx][gy]->loadData(fileName.c_str()))
+            TC_LOG_ERROR("maps", "Error loading map file: \n {}\n", fileName);
+    }
 
     sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
 }
@@ -282,7 +289,8 @@ m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry),
-i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0)
+i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0),
+_pathCache(std::make_unique<PathCache>(sWorld->getIntConfig(CONFIG_MMAP_PATH_CACHE_SIZE)))
 {
     m_parentMap = (_parent ? _parent : this);
 #ifdef FORGE
@@ -310,7 +318,7 @@ i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _r
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
-    MMAP::MMapFactory::createOrGetMMapManager()->loadMapInstance(sWorld->GetDataPath(), GetId(), GetInstanceId());
+    MMAP::MMapFactory::createOrGetMMapManager()->loadMapData(sWorld->GetDataPath(), GetId());
 }
 
 void Map::InitVisibilityDistance()
@@ -1100,6 +1108,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell new_cell(x, y);
 
     player->Relocate(x, y, z, orientation);
+    player->UpdateCellIndex();
     if (player->IsVehicle())
         player->GetVehicleKit()->RelocatePassengers();
 
@@ -1110,7 +1119,10 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         player->RemoveFromGrid();
 
         if (old_cell.DiffGrid(new_cell))
+        {
             EnsureGridLoadedForActiveObject(new_cell, player);
+            PrefetchGridsAround(new_cell);
+        }
 
         AddToGrid(player, new_cell);
     }
@@ -1119,6 +1131,33 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     player->UpdateObjectVisibility(false);
 }
 
+void Map::PrefetchGridsAround(Cell const& cell)
+{
+    // instances share the terrain of their parent map, which is owned by another thread
+    if (i_InstanceId != 0)
+        return;
+
+    GridPrefetcher& prefetcher = sMapMgr->GetGridPrefetcher();
+    if (!prefetcher.IsActive())
+        return;
+
+    bool prefetchVMap = VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled();
+    bool prefetchMMap = DisableMgr::IsPathfindingEnabled(GetId());
+
+    uint32 gridX = cell.GridX();
+    uint32 gridY = cell.GridY();
+    for (uint32 x = (gridX > 0 ? gridX - 1 : 0); x <= std::min(gridX + 1, uint32(MAX_NUMBER_OF_GRIDS - 1)); ++x)
+    {
+        for (uint32 y = (gridY > 0 ? gridY - 1 : 0); y <= std::min(gridY + 1, uint32(MAX_NUMBER_OF_GRIDS - 1)); ++y)
+        {
+            uint32 gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
+            uint32 gy = (MAX_NUMBER_OF_GRIDS - 1) - y;
+            if (!GridMaps[gx][gy])
+                prefetcher.Prefetch(GetId(), gx, gy, prefetchVMap, prefetchMMap);
+        }
+    }
+}
+
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang, bool respawnRelocationOnFail)
 {
     ASSERT(CheckGridIntegrity(creature, false));
@@ -1141,6 +1180,7 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
     else
     {
         creature->Relocate(x, y, z, ang);
+        creature->UpdateCellIndex();
         if (creature->IsVehicle())
             creature->GetVehicleKit()->RelocatePassengers();
         creature->UpdateObjectVisibility(false);
@@ -1174,6 +1214,7 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
     else
     {
         go->Relocate(x, y, z, orientation);
+        go->UpdateCellIndex();
         go->UpdateModelPosition();
         go->UpdatePositionData();
         go->UpdateObjectVisibility(false);
@@ -1208,6 +1249,7 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
     else
     {
         dynObj->Relocate(x, y, z, orientation);
+        dynObj->UpdateCellIndex();
         dynObj->UpdatePositionData();
         dynObj->UpdateObjectVisibility(false);
         RemoveDynamicObjectFromMoveList(dynObj);
@@ -1299,6 +1341,7 @@ void Map::MoveAllCreaturesInMoveList()
         {
             // update pos
             c->Relocate(c->_newPosition);
+            c->UpdateCellIndex();
             if (c->IsVehicle())
                 c->GetVehicleKit()->RelocatePassengers();
             //CreatureRelocationNotify(c, new_cell, new_cell.cellCoord());
@@ -1356,6 +1399,7 @@ void Map::MoveAllGameObjectsInMoveList()
         {
             // update pos
             go->Relocate(go->_newPosition);
+            go->UpdateCellIndex();
             go->UpdateModelPosition();
             go->UpdatePositionData();
             go->UpdateObjectVisibility(false);
@@ -1402,6 +1446,7 @@ void Map::MoveAllDynamicObjectsInMoveList()
         {
             // update pos
             dynObj->Relocate(dynObj->_newPosition);
+            dynObj->UpdateCellIndex();
             dynObj->UpdatePositionData();
             dynObj->UpdateObjectVisibility(false);
         }
@@ -1624,6 +1669,7 @@ bool Map::CreatureRespawnRelocation(Creature* c, bool diffGridOnly)
     if (CreatureCellRelocation(c, resp_cell))
     {
         c->Relocate(resp_x, resp_y, resp_z, resp_o);
+        c->UpdateCellIndex();
         c->GetMotionMaster()->Initialize(); // prevent possible problems with default move generators
         //CreatureRelocationNotify(c, resp_cell, resp_cell.GetCellCoord());
         c->UpdatePositionData();
@@ -1652,6 +1698,7 @@ bool Map::GameObjectRespawnRelocation(GameObject* go, bool diffGridOnly)
     if (GameObjectCellRelocation(go, resp_cell))
     {
         go->Relocate(resp_x, resp_y, resp_z, resp_o);
+        go->UpdateCellIndex();
         go->UpdatePositionData();
         go->UpdateObjectVisibility(false);
         return true;
@@ -1733,6 +1780,9 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
         else
             ((MapInstanced*)m_parentMap)->RemoveGridMapReference(GridCoord(gx, gy));
 
+        // instances share the navmesh of their parent, the tile may be gone after dropping the reference
+        _pathCache->Clear();
+
         GridMaps[gx][gy] = nullptr;
     }
     TC_LOG_DEBUG("maps", "Unloading grid[{}, {}] for map {} finished", x, y, GetId());
@@ -1832,68 +1882,54 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    _file = TerrainFile::Open(filename);
+    if (!_file)
         return true;
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
-    {
-        fclose(in);
+    map_fileheader header;
+    std::size_t offset = 0;
+    if (!readStruct(offset, header))
         return false;
-    }
 
     if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic == MapVersionMagic)
     {
         // load up area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
             return false;
         }
         // load up height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
             return false;
         }
         // load up liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
             return false;
         }
         // loadup holes data (if any. check header.holesOffset)
-        if (header.holesSize && !loadHolesData(in, header.holesOffset, header.holesSize))
+        if (header.holesSize && !loadHolesData(header.holesOffset, header.holesSize))
         {
             TC_LOG_ERROR("maps", "Error loading map holes data\n");
-            fclose(in);
             return false;
         }
-        fclose(in);
         return true;
     }
 
     TC_LOG_ERROR("maps", "Map file '{}' is from an incompatible map version (%.*s v{}), %.*s v{} is expected. Please pull your source, recompile tools and recreate maps using the updated mapextractor, then replace your old map files with new files. If you still have problems search on forum for error TCE00018.",
         filename, 4, header.mapMagic.asChar, header.versionMagic, 4, MapMagic.asChar, MapVersionMagic);
-    fclose(in);
+    unloadData();
     return false;
 }
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
     delete[] _minHeightPlanes;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
-    delete[] _holes;
     _areaMap = nullptr;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -1903,32 +1939,66 @@ void GridMap::unloadData()
     _liquidMap  = nullptr;
     _holes = nullptr;
     _gridGetHeight = &GridMap::getHeightFromFlat;
+    _copiedData.clear();
+    _file.reset();
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<typename T>
+bool GridMap::readStruct(std::size_t& offset, T& value) const
+{
+    if (offset + sizeof(T) > _file->GetSize())
+        return false;
+
+    memcpy(&value, _file->GetData() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+template<typename T>
+bool GridMap::readArray(std::size_t& offset, std::size_t count, T const*& values)
+{
+    if (offset + count * sizeof(T) > _file->GetSize())
+        return false;
+
+    uint8 const* data = _file->GetData() + offset;
+    offset += count * sizeof(T);
+
+    // sections are not padded by the extractor, only misaligned arrays need their own copy
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+    {
+        values = reinterpret_cast<T const*>(data);
+        return true;
+    }
+
+    std::unique_ptr<uint8[]> copy = std::make_unique<uint8[]>(count * sizeof(T));
+    memcpy(copy.get(), data, count * sizeof(T));
+    values = reinterpret_cast<T const*>(copy.get());
+    _copiedData.push_back(std::move(copy));
+    return true;
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
 {
     map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    std::size_t position = offset;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapAreaMagic.asUInt)
+    if (!readStruct(position, header) || header.fourcc != MapAreaMagic.asUInt)
         return false;
 
     _gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
-    {
-        _areaMap = new uint16[16 * 16];
-        if (fread(_areaMap, sizeof(uint16), 16*16, in) != 16*16)
+        if (!readArray(position, 16 * 16, _areaMap))
             return false;
-    }
+
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
+    std::size_t position = offset;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapHeightMagic.asUInt)
+    if (!readStruct(position, header) || header.fourcc != MapHeightMagic.asUInt)
         return false;
 
     _gridHeight = header.gridHeight;
@@ -1936,30 +2006,24 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            if (!readArray(position, 129*129, m_uint16_V9) ||
+                !readArray(position, 128*128, m_uint16_V8))
                 return false;
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             _gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            if (!readArray(position, 129*129, m_uint8_V9) ||
+                !readArray(position, 128*128, m_uint8_V8))
                 return false;
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             _gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            if (!readArray(position, 129*129, m_V9) ||
+                !readArray(position, 128*128, m_V8))
                 return false;
             _gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -1971,10 +2035,9 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         std::array<int16, 9> maxHeights;
         std::array<int16, 9> minHeights;
-        if (fread(maxHeights.data(), sizeof(int16), maxHeights.size(), in) != maxHeights.size() ||
-            fread(minHeights.data(), sizeof(int16), minHeights.size(), in) != minHeights.size())
+        if (!readStruct(position, maxHeights) ||
+            !readStruct(position, minHeights))
             return false;
-
         static uint32 constexpr indices[8][3] =
         {
             { 3, 0, 4 },
@@ -2012,12 +2075,12 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadLiquidData(uint32 offset, uint32 /*size*/)
 {
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
+    std::size_t position = offset;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapLiquidMagic.asUInt)
+    if (!readStruct(position, header) || header.fourcc != MapLiquidMagic.asUInt)
         return false;
 
     _liquidGlobalEntry = header.liquidType;
@@ -2030,30 +2093,24 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        _liquidEntry = new uint16[16*16];
-        if (fread(_liquidEntry, sizeof(uint16), 16*16, in) != 16*16)
+        if (!readArray(position, 16*16, _liquidEntry))
             return false;
 
-        _liquidFlags = new uint8[16*16];
-        if (fread(_liquidFlags, sizeof(uint8), 16*16, in) != 16*16)
+        if (!readArray(position, 16*16, _liquidFlags))
             return false;
     }
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        _liquidMap = new float[uint32(_liquidWidth) * uint32(_liquidHeight)];
-        if (fread(_liquidMap, sizeof(float), _liquidWidth*_liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        if (!readArray(position, uint32(_liquidWidth) * uint32(_liquidHeight), _liquidMap))
             return false;
     }
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-
-    _holes = new uint16[16 * 16];
-    if (fread(_holes, sizeof(uint16), 16 * 16, in) != 16 * 16)
+    std::size_t position = offset;
+    if (!readArray(position, 16 * 16, _holes))
         return false;
 
     return true;
@@ -2180,7 +2237,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint8 *V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -2250,7 +2307,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint16 *V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -2892,6 +2949,20 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     return true;
 }
 
+void Map::isInLineOfSight(std::span<VMAP::LineOfSightQuery> queries, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    if (checks & LINEOFSIGHT_CHECK_VMAP)
+        VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), queries, ignoreFlags);
+    else
+        for (VMAP::LineOfSightQuery& query : queries)
+            query.inLineOfSight = true;
+
+    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT))
+        for (VMAP::LineOfSightQuery& query : queries)
+            if (query.inLineOfSight && !_dynamicTree.isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, phasemask))
+                query.inLineOfSight = false;
+}
+
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
 {
     G3D::Vector3 startPos(x1, y1, z1);
@@ -3032,12 +3103,11 @@ void Map::SendObjectUpdates()
         obj->BuildUpdate(update_players);
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
-        iter->second.BuildPacket(&packet);
-        iter->first->SendDirectMessage(&packet);
-        packet.clear();                                     // clean the string
+        WorldPacket packet;                                 // storage is taken from the buffer pool and handed over to the socket
+        if (iter->second.BuildPacket(&packet))
+            iter->first->SendDirectMessage(std::move(packet));
     }
 }
 
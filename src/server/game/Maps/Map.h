@@ -38,6 +38,8 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <vector>
 #ifdef FORGE
 #include "LuaValue.h"
 #endif
@@ -55,8 +57,10 @@ class InstanceSave;
 class InstanceScript;
 class MapInstanced;
 class Object;
+class PathCache;
 class Player;
 class TempSummon;
+class TerrainFile;
 class Transport;
 class Unit;
 class Weather;
@@ -73,7 +77,11 @@ enum Difficulty : uint8;
 enum WeatherState : uint32;
 
 namespace Trinity { struct ObjectUpdater; }
-namespace VMAP { enum class ModelIgnoreFlags : uint32; }
+namespace VMAP
+{
+    enum class ModelIgnoreFlags : uint32;
+    struct LineOfSightQuery;
+}
 namespace G3D { class Plane; }
 
 struct ScriptAction
@@ -159,16 +167,20 @@ struct map_liquidHeader
 
 class TC_GAME_API GridMap
 {
+    // height, area, liquid and holes arrays point into this file unless they had to be copied out of it for alignment
+    std::shared_ptr<TerrainFile const> _file;
+    std::vector<std::unique_ptr<uint8[]>> _copiedData;
+
     uint32  _flags;
     union{
-        float* m_V9;
-        uint16* m_uint16_V9;
-        uint8* m_uint8_V9;
+        float const* m_V9;
+        uint16 const* m_uint16_V9;
+        uint8 const* m_uint8_V9;
     };
     union{
-        float* m_V8;
-        uint16* m_uint16_V8;
-        uint8* m_uint8_V8;
+        float const* m_V8;
+        uint16 const* m_uint16_V8;
+        uint8 const* m_uint8_V8;
     };
     G3D::Plane* _minHeightPlanes;
     // Height level data
@@ -176,13 +188,13 @@ class TC_GAME_API GridMap
     float _gridIntHeightMultiplier;
 
     // Area data
-    uint16* _areaMap;
+    uint16 const* _areaMap;
 
     // Liquid data
     float _liquidLevel;
-    uint16* _liquidEntry;
-    uint8* _liquidFlags;
-    float* _liquidMap;
+    uint16 const* _liquidEntry;
+    uint8 const* _liquidFlags;
+    float const* _liquidMap;
     uint16 _gridArea;
     uint16 _liquidGlobalEntry;
     uint8 _liquidGlobalFlags;
@@ -191,12 +203,17 @@ class TC_GAME_API GridMap
     uint8 _liquidWidth;
     uint8 _liquidHeight;
 
-    uint16* _holes;
+    uint16 const* _holes;
 
-    bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
-    bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+    template<typename T>
+    bool readStruct(std::size_t& offset, T& value) const;
+    template<typename T>
+    bool readArray(std::size_t& offset, std::size_t count, T const*& values);
+
+    bool loadAreaData(uint32 offset, uint32 size);
+    bool loadHeightData(uint32 offset, uint32 size);
+    bool loadLiquidData(uint32 offset, uint32 size);
+    bool loadHolesData(uint32 offset, uint32 size);
     bool isHole(int row, int col) const;
 
     // Get height functions and pointers
@@ -537,9 +554,12 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), GetGameObjectFloor(phasemask, x, y, z, maxSearchDist)); }
         float GetHeight(uint32 phasemask, Position const& pos, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return GetHeight(phasemask, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), vmap, maxSearchDist); }
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
+        void isInLineOfSight(std::span<VMAP::LineOfSightQuery> queries, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
+        PathCache* GetPathCache() const { return _pathCache.get(); }
         void Balance() { _dynamicTree.balance(); }
         void RemoveGameObjectModel(GameObjectModel const& model) { _dynamicTree.remove(model); }
         void InsertGameObjectModel(GameObjectModel const& model) { _dynamicTree.insert(model); }
+        void RelocateGameObjectModel(GameObjectModel& model) { _dynamicTree.relocate(model); }
         bool ContainsGameObjectModel(GameObjectModel const& model) const { return _dynamicTree.contains(model);}
         float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
@@ -657,6 +677,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void EnsureGridCreated_i(GridCoord const&);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
+        void PrefetchGridsAround(Cell const& cell);
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -871,6 +892,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_set<Object*> _updateObjects;
 
         MPSCQueue<FarSpellCallback> _farSpellCallbacks;
+
+        std::unique_ptr<PathCache> _pathCache;
 #ifdef FORGE
         std::unique_ptr<Forge> forge;
 #endif
@@ -24,6 +24,7 @@
 #include "Transport.h"
 #include "GridDefines.h"
 #include "MapInstanced.h"
+#include "MMapFactory.h"
 #include "InstanceScript.h"
 #include "Config.h"
 #include "World.h"
@@ -46,6 +47,7 @@ MapManager::MapManager()
 {
     i_gridCleanUpDelay = sWorld->getIntConfig(CONFIG_INTERVAL_GRIDCLEAN);
     i_timer.SetInterval(sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
+    _mmapEvictionTimer.SetInterval(10 * IN_MILLISECONDS);
 }
 
 MapManager::~MapManager() { }
@@ -67,6 +69,10 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    int num_prefetch_threads(sWorld->getIntConfig(CONFIG_MAP_GRID_PREFETCH_THREADS));
+    if (num_prefetch_threads > 0)
+        m_gridPrefetcher.Activate(num_prefetch_threads);
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -249,6 +255,14 @@ void MapManager::Update(uint32 diff)
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
+    // no map is updating now, so evicting navmesh tiles does not wait on path queries
+    _mmapEvictionTimer.Update(i_timer.GetCurrent());
+    if (_mmapEvictionTimer.Passed())
+    {
+        _mmapEvictionTimer.Reset();
+        MMAP::MMapFactory::createOrGetMMapManager()->EvictColdTiles();
+    }
+
     i_timer.SetCurrent(0);
 }
 
@@ -278,6 +292,9 @@ bool MapManager::IsValidMAP(uint32 mapid, bool startUp)
 
 void MapManager::UnloadAll()
 {
+    // background loads must not outlive the maps they are meant for
+    m_gridPrefetcher.Deactivate();
+
     // first unload maps
     for (auto iter = i_maps.begin(); iter != i_maps.end(); ++iter)
     {
@@ -22,6 +22,7 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
+#include "GridPrefetcher.h"
 #include "MapUpdater.h"
 #include "UniqueTrackablePtr.h"
 #include <boost/dynamic_bitset.hpp>
@@ -128,6 +129,7 @@ class TC_GAME_API MapManager
         void FreeInstanceId(uint32 instanceId);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridPrefetcher& GetGridPrefetcher() { return m_gridPrefetcher; }
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -160,10 +162,12 @@ class TC_GAME_API MapManager
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+        IntervalTimer _mmapEvictionTimer;
 
         InstanceIds _freeInstanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        GridPrefetcher m_gridPrefetcher;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
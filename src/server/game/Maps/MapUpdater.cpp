@@ -20,8 +20,15 @@
 #include "Map.h"
 #include "Metric.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 
+static uint64 MakeUpdateCostKey(uint32 mapId, uint32 instanceId)
+{
+    return (uint64(mapId) << 32) | instanceId;
+}
+
 class MapUpdateRequest
 {
     private:
@@ -29,27 +36,36 @@ class MapUpdateRequest
         Map& m_map;
         MapUpdater& m_updater;
         uint32 m_diff;
+        uint32 m_expectedCost;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
+        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, uint32 c)
+            : m_map(m), m_updater(u), m_diff(d), m_expectedCost(c)
         {
         }
 
+        uint32 GetExpectedCost() const { return m_expectedCost; }
+
         void call()
         {
-            TC_METRIC_TIMER("map_update_time_diff", TC_METRIC_TAG("map_id", std::to_string(m_map.GetId())));
-            m_map.Update (m_diff);
-            m_updater.update_finished();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            m_map.Update(m_diff);
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+            TC_METRIC_VALUE("map_update_time_diff", elapsed, TC_METRIC_TAG("map_id", std::to_string(m_map.GetId())));
+            m_updater.update_finished(MakeUpdateCostKey(m_map.GetId(), m_map.GetInstanceId()), uint32(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
         }
 };
 
 void MapUpdater::activate(size_t num_threads)
 {
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerQueues.push_back(std::make_unique<WorkerQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
     {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
     }
 }
 
@@ -59,7 +75,10 @@ void MapUpdater::deactivate()
 
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _workCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
     {
@@ -74,16 +93,64 @@ void MapUpdater::wait()
     while (pending_requests > 0)
         _condition.wait(lock);
 
+    // every map is updated on every tick, costs of maps that were not are stale (unloaded instances)
+    for (auto itr = _updateCosts.begin(); itr != _updateCosts.end();)
+    {
+        if (itr->second.Generation != _updateGeneration)
+            itr = _updateCosts.erase(itr);
+        else
+            ++itr;
+    }
+
+    ++_updateGeneration;
+
     lock.unlock();
 }
 
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    uint32 expectedCost = 0;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        ++pending_requests;
+
+        auto itr = _updateCosts.find(MakeUpdateCostKey(map.GetId(), map.GetInstanceId()));
+        if (itr != _updateCosts.end())
+            expectedCost = itr->second.Average;
+    }
 
-    ++pending_requests;
+    MapUpdateRequest* request = new MapUpdateRequest(map, *this, diff, expectedCost);
+
+    // longest processing time first - hand the request to the worker with the least queued work
+    WorkerQueue* target = nullptr;
+    uint64 targetCost = 0;
+    size_t targetSize = 0;
+    for (std::unique_ptr<WorkerQueue>& queue : _workerQueues)
+    {
+        std::lock_guard<std::mutex> queueLock(queue->Lock);
+        if (!target || queue->QueuedCost < targetCost || (queue->QueuedCost == targetCost && queue->Requests.size() < targetSize))
+        {
+            target = queue.get();
+            targetCost = queue->QueuedCost;
+            targetSize = queue->Requests.size();
+        }
+    }
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    {
+        std::lock_guard<std::mutex> queueLock(target->Lock);
+        auto where = std::upper_bound(target->Requests.begin(), target->Requests.end(), request, [](MapUpdateRequest const* left, MapUpdateRequest const* right)
+        {
+            return left->GetExpectedCost() > right->GetExpectedCost();
+        });
+        target->Requests.insert(where, request);
+        target->QueuedCost += expectedCost;
+        // counted under the queue lock that take_request decrements it under, so it never underflows
+        ++_queuedRequests;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _workCondition.notify_one();
 }
 
 bool MapUpdater::activated()
@@ -91,16 +158,53 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+MapUpdateCost MapUpdater::get_update_cost(uint32 mapId, uint32 instanceId)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto itr = _updateCosts.find(MakeUpdateCostKey(mapId, instanceId));
+    if (itr == _updateCosts.end())
+        return MapUpdateCost();
+
+    return itr->second;
+}
+
+void MapUpdater::update_finished(uint64 mapKey, uint32 cost)
 {
     std::lock_guard<std::mutex> lock(_lock);
 
+    auto [itr, isNew] = _updateCosts.try_emplace(mapKey);
+    MapUpdateCost& history = itr->second;
+    history.Average = isNew ? cost : (history.Average * 7 + cost) / 8;
+    history.Last = cost;
+    history.Generation = _updateGeneration;
+
     --pending_requests;
 
     _condition.notify_all();
 }
 
-void MapUpdater::WorkerThread()
+MapUpdateRequest* MapUpdater::take_request(size_t workerIndex)
+{
+    // own queue first, then steal from the others - always the most expensive request available
+    for (size_t i = 0; i < _workerQueues.size(); ++i)
+    {
+        WorkerQueue& queue = *_workerQueues[(workerIndex + i) % _workerQueues.size()];
+        std::lock_guard<std::mutex> queueLock(queue.Lock);
+        if (queue.Requests.empty())
+            continue;
+
+        MapUpdateRequest* request = queue.Requests.front();
+        queue.Requests.pop_front();
+        queue.QueuedCost -= request->GetExpectedCost();
+        --_queuedRequests;
+        return request;
+    }
+
+    return nullptr;
+}
+
+void MapUpdater::WorkerThread(size_t workerIndex)
 {
     LoginDatabase.WarnAboutSyncQueries(true);
     CharacterDatabase.WarnAboutSyncQueries(true);
@@ -108,13 +212,18 @@ void MapUpdater::WorkerThread()
 
     while (true)
     {
-        MapUpdateRequest* request = nullptr;
-
-        _queue.WaitAndPop(request);
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _workCondition.wait(lock, [this]() { return _cancelationToken || _queuedRequests > 0; });
+        }
 
-        if (_cancelationToken)
+        if (_cancelationToken && !_queuedRequests)
             return;
 
+        MapUpdateRequest* request = take_request(workerIndex);
+        if (!request)
+            continue;
+
         request->call();
 
         delete request;
@@ -19,19 +19,30 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
-#include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <unordered_map>
+#include <vector>
 
 class MapUpdateRequest;
 class Map;
 
+struct MapUpdateCost
+{
+    uint32 Last = 0;                                        // microseconds taken by the previous update
+    uint32 Average = 0;                                     // exponential moving average, in microseconds
+    uint32 Generation = 0;                                  // last tick this map was updated in
+};
+
 class TC_GAME_API MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _queuedRequests(0), _cancelationToken(false), pending_requests(0), _updateGeneration(0) {}
         ~MapUpdater() { };
 
         friend class MapUpdateRequest;
@@ -46,20 +57,37 @@ class TC_GAME_API MapUpdater
 
         bool activated();
 
+        MapUpdateCost get_update_cost(uint32 mapId, uint32 instanceId);
+
     private:
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+        // requests are kept sorted by expected cost, most expensive first
+        struct WorkerQueue
+        {
+            std::mutex Lock;
+            std::deque<MapUpdateRequest*> Requests;
+            uint64 QueuedCost = 0;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
+        std::atomic<size_t> _queuedRequests;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
         std::mutex _lock;
         std::condition_variable _condition;
+        std::condition_variable _workCondition;
         size_t pending_requests;
 
-        void update_finished();
+        std::unordered_map<uint64, MapUpdateCost> _updateCosts;
+        uint32 _updateGeneration;
+
+        void update_finished(uint64 mapKey, uint32 cost);
+
+        MapUpdateRequest* take_request(size_t workerIndex);
 
-        void WorkerThread();
+        void WorkerThread(size_t workerIndex);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
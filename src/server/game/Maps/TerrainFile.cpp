@@ -0,0 +1,116 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TerrainFile.h"
+#include "Log.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+TerrainFile::TerrainFile() : _data(nullptr), _size(0)
+{
+}
+
+TerrainFile::~TerrainFile() = default;
+
+std::shared_ptr<TerrainFile const> TerrainFile::Open(std::string const& fileName)
+{
+    static std::mutex lock;
+    static std::unordered_map<std::string, std::weak_ptr<TerrainFile const>> openFiles;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto itr = openFiles.find(fileName);
+    if (itr != openFiles.end())
+    {
+        if (std::shared_ptr<TerrainFile const> file = itr->second.lock())
+            return file;
+
+        openFiles.erase(itr);
+    }
+
+    std::shared_ptr<TerrainFile> file(new TerrainFile());
+    if (!file->Load(fileName))
+        return nullptr;
+
+    // drop entries of files that are no longer used by any map
+    for (auto expired = openFiles.begin(); expired != openFiles.end();)
+    {
+        if (expired->second.expired())
+            expired = openFiles.erase(expired);
+        else
+            ++expired;
+    }
+
+    openFiles[fileName] = file;
+    return file;
+}
+
+bool TerrainFile::Load(std::string const& fileName)
+{
+    FILE* in = fopen(fileName.c_str(), "rb");
+    if (!in)
+        return false;
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    if (size < 0)
+    {
+        fclose(in);
+        return false;
+    }
+
+    try
+    {
+        boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+        _region = std::make_unique<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only);
+        _data = static_cast<uint8 const*>(_region->get_address());
+        _size = _region->get_size();
+        fclose(in);
+        return true;
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        TC_LOG_DEBUG("maps", "TerrainFile::Load: could not map {} into memory ({}), reading it instead", fileName, e.what());
+        _region.reset();
+    }
+
+    // fall back to a private copy of the file
+    _buffer.resize(size);
+    fseek(in, 0, SEEK_SET);
+    bool success = fread(_buffer.data(), 1, _buffer.size(), in) == _buffer.size();
+    fclose(in);
+    if (!success)
+        return false;
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+    return true;
+}
+
+void TerrainFile::TouchPages() const
+{
+    if (!_region)
+        return;
+
+    // the value is irrelevant, volatile only keeps the reads from being optimized out
+    volatile uint8 sink = 0;
+    for (std::size_t i = 0; i < _size; i += 0x1000)
+        sink = sink + _data[i];
+}
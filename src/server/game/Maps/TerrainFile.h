@@ -0,0 +1,59 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_TERRAINFILE_H
+#define TRINITY_TERRAINFILE_H
+
+#include "Define.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+/// Read-only view of a .map terrain file, mapped into memory once per process and shared by every map using it
+class TC_GAME_API TerrainFile
+{
+    public:
+        /// Returns the already opened file when any map still holds it, nullptr when the file does not exist
+        static std::shared_ptr<TerrainFile const> Open(std::string const& fileName);
+
+        TerrainFile(TerrainFile const&) = delete;
+        TerrainFile& operator=(TerrainFile const&) = delete;
+
+        ~TerrainFile();
+
+        uint8 const* GetData() const { return _data; }
+        std::size_t GetSize() const { return _size; }
+        bool IsMapped() const { return _region != nullptr; }
+
+        /// Faults in every page of a mapped file so later reads do not block on disk
+        void TouchPages() const;
+
+    private:
+        TerrainFile();
+
+        bool Load(std::string const& fileName);
+
+        std::unique_ptr<boost::interprocess::mapped_region> _region;
+        std::vector<uint8> _buffer;             // only used when the file could not be mapped
+        uint8 const* _data;
+        std::size_t _size;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathCache.h"
+#include "DetourNavMeshQuery.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+
+// how many of the most recently used corridors are searched for a shared tail on a miss
+static constexpr uint32 MAX_PATH_CACHE_TAIL_SCAN = 16;
+// yards, start and end positions in the same square of this size share a corridor
+static constexpr float PATH_CACHE_POSITION_STEP = 4.0f;
+
+std::size_t PathCache::KeyHash::operator()(Key const& key) const
+{
+    std::size_t hashVal = 0;
+    Trinity::hash_combine(hashVal, key.StartPoly);
+    Trinity::hash_combine(hashVal, key.EndPoly);
+    Trinity::hash_combine(hashVal, key.StartX);
+    Trinity::hash_combine(hashVal, key.StartY);
+    Trinity::hash_combine(hashVal, key.EndX);
+    Trinity::hash_combine(hashVal, key.EndY);
+    Trinity::hash_combine(hashVal, key.IncludeFlags);
+    Trinity::hash_combine(hashVal, key.ExcludeFlags);
+    return hashVal;
+}
+
+PathCache::PathCache(uint32 capacity) : _capacity(capacity)
+{
+}
+
+uint32 PathCache::Find(dtNavMesh const* navMesh, dtPolyRef startPoly, float const* startPos, dtPolyRef endPoly, float const* endPos,
+    dtQueryFilter const& filter, dtPolyRef* path, uint32 maxPathSize)
+{
+    if (!_capacity || !navMesh)
+        return 0;
+
+    Key key = MakeKey(startPoly, startPos, endPoly, endPos, filter);
+    auto itr = _lookup.find(key);
+    if (itr != _lookup.end())
+    {
+        std::vector<dtPolyRef> const& polys = itr->second->Polys;
+        // tiles may have been unloaded since this corridor was stored
+        if (polys.size() > maxPathSize || !IsValidCorridor(navMesh, polys.data(), uint32(polys.size())))
+        {
+            _entries.erase(itr->second);
+            _lookup.erase(itr);
+            return 0;
+        }
+
+        _entries.splice(_entries.begin(), _entries, itr->second);
+        std::copy(polys.begin(), polys.end(), path);
+        return uint32(polys.size());
+    }
+
+    // a sub-path of an optimal path is optimal, so any corridor to the same end
+    // that passes through our start poly already contains the answer
+    uint32 scanned = 0;
+    for (auto entryItr = _entries.begin(); entryItr != _entries.end() && scanned < MAX_PATH_CACHE_TAIL_SCAN; ++entryItr, ++scanned)
+    {
+        Key const& entryKey = entryItr->CacheKey;
+        if (entryKey.EndPoly != key.EndPoly || entryKey.EndX != key.EndX || entryKey.EndY != key.EndY
+            || entryKey.IncludeFlags != key.IncludeFlags || entryKey.ExcludeFlags != key.ExcludeFlags)
+            continue;
+
+        std::vector<dtPolyRef> const& polys = entryItr->Polys;
+        auto startItr = std::find(polys.begin(), polys.end(), startPoly);
+        if (startItr == polys.end())
+            continue;
+
+        uint32 tailSize = uint32(std::distance(startItr, polys.end()));
+        if (tailSize > maxPathSize || !IsValidCorridor(navMesh, &*startItr, tailSize))
+            continue;
+
+        std::copy(startItr, polys.end(), path);
+        _entries.splice(_entries.begin(), _entries, entryItr);
+        return tailSize;
+    }
+
+    return 0;
+}
+
+void PathCache::Store(dtPolyRef const* path, uint32 pathSize, float const* startPos, float const* endPos, dtQueryFilter const& filter)
+{
+    if (!_capacity || !pathSize)
+        return;
+
+    Key key = MakeKey(path[0], startPos, path[pathSize - 1], endPos, filter);
+    auto itr = _lookup.find(key);
+    if (itr != _lookup.end())
+    {
+        itr->second->Polys.assign(path, path + pathSize);
+        _entries.splice(_entries.begin(), _entries, itr->second);
+        return;
+    }
+
+    if (_lookup.size() >= _capacity)
+    {
+        _lookup.erase(_entries.back().CacheKey);
+        _entries.pop_back();
+    }
+
+    _entries.push_front({ key, std::vector<dtPolyRef>(path, path + pathSize) });
+    _lookup.emplace(key, _entries.begin());
+}
+
+void PathCache::Clear()
+{
+    _lookup.clear();
+    _entries.clear();
+}
+
+uint32 PathCache::GetSize() const
+{
+    return uint32(_lookup.size());
+}
+
+PathCache::Key PathCache::MakeKey(dtPolyRef startPoly, float const* startPos, dtPolyRef endPoly, float const* endPos, dtQueryFilter const& filter)
+{
+    auto quantize = [](float value) { return int32(std::floor(value / PATH_CACHE_POSITION_STEP)); };
+    return { startPoly, endPoly, quantize(startPos[2]), quantize(startPos[0]), quantize(endPos[2]), quantize(endPos[0]),
+        filter.getIncludeFlags(), filter.getExcludeFlags() };
+}
+
+bool PathCache::IsValidCorridor(dtNavMesh const* navMesh, dtPolyRef const* polys, uint32 count)
+{
+    return std::all_of(polys, polys + count, [navMesh](dtPolyRef ref) { return navMesh->isValidPolyRef(ref); });
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PATH_CACHE_H
+#define _PATH_CACHE_H
+
+#include "Define.h"
+#include "DetourNavMesh.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class dtQueryFilter;
+
+// Per map cache of complete detour poly corridors.
+// Many units chasing the same target ask for the same corridor over and over,
+// a hit skips findPath() entirely. Corridors are keyed on their end polys and on the
+// start and end positions rounded to PATH_CACHE_POSITION_STEP, the best corridor
+// between two large polys depends on where in them the path starts and ends.
+class TC_GAME_API PathCache
+{
+    public:
+        explicit PathCache(uint32 capacity);
+
+        // copies a cached corridor from startPoly to endPoly into path, positions are in detour (y, z, x) order
+        // falls back to the tail of any recently used corridor to the same end passing through startPoly
+        // return: number of polys written, 0 on miss
+        uint32 Find(dtNavMesh const* navMesh, dtPolyRef startPoly, float const* startPos, dtPolyRef endPoly, float const* endPos,
+            dtQueryFilter const& filter, dtPolyRef* path, uint32 maxPathSize);
+
+        // path must be a complete corridor from startPos to endPos, path[0] is the start poly and path[pathSize - 1] the end poly
+        void Store(dtPolyRef const* path, uint32 pathSize, float const* startPos, float const* endPos, dtQueryFilter const& filter);
+
+        void Clear();
+
+        uint32 GetSize() const;
+
+    private:
+        struct Key
+        {
+            dtPolyRef StartPoly;
+            dtPolyRef EndPoly;
+            int32 StartX;
+            int32 StartY;
+            int32 EndX;
+            int32 EndY;
+            uint16 IncludeFlags;
+            uint16 ExcludeFlags;
+
+            bool operator==(Key const& right) const = default;
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            Key CacheKey;
+            std::vector<dtPolyRef> Polys;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        static Key MakeKey(dtPolyRef startPoly, float const* startPos, dtPolyRef endPoly, float const* endPos, dtQueryFilter const& filter);
+        static bool IsValidCorridor(dtNavMesh const* navMesh, dtPolyRef const* polys, uint32 count);
+
+        uint32 _capacity;
+        EntryList _entries;                 // most recently used first
+        std::unordered_map<Key, EntryList::iterator, KeyHash> _lookup;
+};
+
+#endif
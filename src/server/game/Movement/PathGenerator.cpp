@@ -20,8 +20,10 @@
 #include "Creature.h"
 #include "MMapFactory.h"
 #include "MMapManager.h"
+#include "PathCache.h"
 #include "Log.h"
 #include "DisableMgr.h"
+#include "GameTime.h"
 #include "DetourCommon.h"
 #include "DetourNavMeshQuery.h"
 #include "Metric.h"
@@ -30,20 +32,13 @@
 PathGenerator::PathGenerator(WorldObject const* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _useRaycast(false),
-    _endPosition(G3D::Vector3::zero()), _source(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _endPosition(G3D::Vector3::zero()), _source(owner), _pathfindingEnabled(false), _nextEvictedTileReload(TimePoint::min())
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
     TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::PathGenerator for {}", _source->GetGUID().ToString());
 
-    uint32 mapId = _source->GetMapId();
-    if (DisableMgr::IsPathfindingEnabled(mapId))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetInstanceId());
-        _navMesh = _navMeshQuery ? _navMeshQuery->getAttachedNavMesh() : mmap->GetNavMesh(mapId);
-    }
+    _pathfindingEnabled = DisableMgr::IsPathfindingEnabled(_source->GetMapId());
 
     CreateFilter();
 }
@@ -73,12 +68,22 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
 
     TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::CalculatePath() for {}", _source->GetGUID().ToString());
 
+    // query is only leased for this calculation, maps updated in parallel must not share one
+    // and tiles can't be loaded or unloaded while we hold it, the nav mesh is only used through it
+    if (_pathfindingEnabled)
+    {
+        // tiles of loaded grids may have been evicted to stay within the tile memory budget
+        EnsureEndTilesLoaded(start, dest);
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(_source->GetMapId());
+    }
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     Unit const* _sourceUnit = _source->ToUnit();
-    if (!_navMesh || !_navMeshQuery || (_sourceUnit && _sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING)) ||
+    if (!_navMeshQuery || (_sourceUnit && _sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING)) ||
         !HaveTile(start) || !HaveTile(dest))
     {
+        _navMeshQuery.Release();
         BuildShortcut();
         _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
         return true;
@@ -87,9 +92,73 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
     UpdateFilter();
 
     BuildPolyPath(start, dest);
+    _navMeshQuery.Release();
+
+    // the search may have been cut off by evicted tiles between both ends, search again once they are back
+    if ((_type & (PATHFIND_INCOMPLETE | PATHFIND_NOPATH)) && GameTime::Now() >= _nextEvictedTileReload)
+    {
+        _nextEvictedTileReload = GameTime::Now() + EVICTED_TILE_RELOAD_INTERVAL;
+        if (!ReloadEvictedTilesOnPath(start, dest))
+            return true;
+
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(_source->GetMapId());
+        if (_navMeshQuery)
+        {
+            Clear();
+            BuildPolyPath(start, dest);
+            _navMeshQuery.Release();
+        }
+    }
+
     return true;
 }
 
+static void AddTileOf(std::vector<std::pair<int32, int32>>& tiles, float x, float y, int32 margin = 0)
+{
+    GridCoord grid = Trinity::ComputeGridCoord(x, y);
+    int32 tileX = int32(MAX_NUMBER_OF_GRIDS - 1) - int32(grid.x_coord);
+    int32 tileY = int32(MAX_NUMBER_OF_GRIDS - 1) - int32(grid.y_coord);
+    for (int32 dx = -margin; dx <= margin; ++dx)
+    {
+        for (int32 dy = -margin; dy <= margin; ++dy)
+        {
+            std::pair<int32, int32> tile(tileX + dx, tileY + dy);
+            if (std::find(tiles.begin(), tiles.end(), tile) == tiles.end())
+                tiles.push_back(tile);
+        }
+    }
+}
+
+void PathGenerator::EnsureEndTilesLoaded(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos) const
+{
+    std::vector<std::pair<int32, int32>> tiles;
+    AddTileOf(tiles, startPos.x, startPos.y, 1);
+    AddTileOf(tiles, endPos.x, endPos.y, 1);
+    MMAP::MMapFactory::createOrGetMMapManager()->EnsureTilesLoaded(_source->GetMapId(), tiles, true);
+}
+
+bool PathGenerator::ReloadEvictedTilesOnPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos) const
+{
+    std::vector<std::pair<int32, int32>> tiles;
+
+    // a cell is smaller than a grid, sampling at that step can't skip a grid the line passes through
+    G3D::Vector3 line = endPos - startPos;
+    line.z = 0.0f;
+    uint32 steps = uint32(line.length() / SIZE_OF_GRID_CELL) + 1;
+    for (uint32 i = 0; i <= steps; ++i)
+    {
+        G3D::Vector3 point = startPos + line * (float(i) / float(steps));
+        AddTileOf(tiles, point.x, point.y);
+    }
+
+    // the partial corridor, its points are at most SMOOTH_PATH_STEP_SIZE apart
+    for (G3D::Vector3 const& point : _pathPoints)
+        AddTileOf(tiles, point.x, point.y);
+
+    // resident tiles are left alone, only the ones the search went through were used
+    return MMAP::MMapFactory::createOrGetMMapManager()->EnsureTilesLoaded(_source->GetMapId(), tiles, false) > 0;
+}
+
 dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -287,6 +356,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         return;
     }
 
+    PathCache* pathCache = _source->GetMap()->GetPathCache();
+
     // look for startPoly/endPoly in current path
     /// @todo we can merge it with getPathPolyByPosition() loop
     bool startPolyFound = false;
@@ -384,6 +455,11 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             _type = PATHFIND_NOPATH;
             return;
         }
+        else if ((suffixPolyLength = pathCache->Find(_navMeshQuery.GetNavMesh(), suffixStartPoly, suffixEndPoint, endPoly, endPoint, _filter, _pathPolyRefs + prefixPolyLength - 1, MAX_PATH_LENGTH - prefixPolyLength)))
+        {
+            TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: suffix found in path cache");
+            dtResult = DT_SUCCESS;
+        }
         else
         {
             dtResult = _navMeshQuery->findPath(
@@ -395,6 +471,9 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                             _pathPolyRefs + prefixPolyLength - 1,    // [out] path
                             (int*)&suffixPolyLength,
                             MAX_PATH_LENGTH - prefixPolyLength);   // max number of polygons in output path
+
+            if (!dtStatusFailed(dtResult) && suffixPolyLength && _pathPolyRefs[prefixPolyLength + suffixPolyLength - 2] == endPoly)
+                pathCache->Store(_pathPolyRefs + prefixPolyLength - 1, suffixPolyLength, suffixEndPoint, endPoint, _filter);
         }
 
         if (!suffixPolyLength || dtStatusFailed(dtResult))
@@ -491,6 +570,11 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 return;
             }
         }
+        else if ((_polyLength = pathCache->Find(_navMeshQuery.GetNavMesh(), startPoly, startPoint, endPoly, endPoint, _filter, _pathPolyRefs, MAX_PATH_LENGTH)))
+        {
+            TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: path found in path cache");
+            dtResult = DT_SUCCESS;
+        }
         else
         {
             dtResult = _navMeshQuery->findPath(
@@ -502,6 +586,9 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                             _pathPolyRefs,     // [out] path
                             (int*)&_polyLength,
                             MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!dtStatusFailed(dtResult) && _polyLength && _pathPolyRefs[_polyLength - 1] == endPoly)
+                pathCache->Store(_pathPolyRefs, _polyLength, startPoint, endPoint, _filter);
         }
 
         if (!_polyLength || dtStatusFailed(dtResult))
@@ -718,7 +805,7 @@ bool PathGenerator::HaveTile(const G3D::Vector3& p) const
     int tx = -1, ty = -1;
     float point[VERTEX_SIZE] = {p.y, p.z, p.x};
 
-    _navMesh->calcTileLoc(point, &tx, &ty);
+    _navMeshQuery.GetNavMesh()->calcTileLoc(point, &tx, &ty);
 
     /// Workaround
     /// For some reason, often the tx and ty variables wont get a valid value
@@ -726,7 +813,7 @@ bool PathGenerator::HaveTile(const G3D::Vector3& p) const
     if (tx < 0 || ty < 0)
         return false;
 
-    return (_navMesh->getTileAt(tx, ty, 0) != nullptr);
+    return (_navMeshQuery.GetNavMesh()->getTileAt(tx, ty, 0) != nullptr);
 }
 
 uint32 PathGenerator::FixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath, dtPolyRef const* visited, uint32 nvisited)
@@ -918,7 +1005,7 @@ dtStatus PathGenerator::FindSmoothPath(float const* startPos, float const* endPo
 
             // Handle the connection.
             float connectionStartPos[VERTEX_SIZE], connectionEndPos[VERTEX_SIZE];
-            if (dtStatusSucceed(_navMesh->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, connectionStartPos, connectionEndPos)))
+            if (dtStatusSucceed(_navMeshQuery.GetNavMesh()->getOffMeshConnectionPolyEndPoints(prevRef, polyRef, connectionStartPos, connectionEndPos)))
             {
                 if (nsmoothPath < maxSmoothPathSize)
                 {
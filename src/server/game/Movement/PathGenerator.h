@@ -19,8 +19,10 @@
 #define _PATH_GENERATOR_H
 
 #include "MapDefines.h"
+#include "Duration.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include "MMapManager.h"
 #include "MoveSplineInitArgs.h"
 #include <G3D/Vector3.h>
 
@@ -36,6 +38,9 @@ class WorldObject;
 #define SMOOTH_PATH_STEP_SIZE   4.0f
 #define SMOOTH_PATH_SLOP        0.3f
 
+// minimum time between two searches of one generator that are retried after reloading evicted nav mesh tiles
+#define EVICTED_TILE_RELOAD_INTERVAL Seconds(5)
+
 #define VERTEX_SIZE       3
 #define INVALID_POLYREF   0
 
@@ -99,8 +104,9 @@ class TC_GAME_API PathGenerator
         G3D::Vector3 _actualEndPosition;    // {x, y, z} of the closest possible point to given destination
 
         WorldObject const* const _source;       // the object that is moving
-        dtNavMesh const* _navMesh;              // the nav mesh
-        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        bool _pathfindingEnabled;               // pathfinding is not disabled for the map of the source
+        MMAP::NavMeshQueryLease _navMeshQuery;  // the nav mesh query used to find the path, only held inside CalculatePath()
+        TimePoint _nextEvictedTileReload;       // incomplete paths are not searched again with reloaded tiles before this
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
@@ -122,6 +128,10 @@ class TC_GAME_API PathGenerator
         dtPolyRef GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* Point, float* Distance = nullptr) const;
         dtPolyRef GetPolyByLocation(float const* Point, float* Distance) const;
         bool HaveTile(G3D::Vector3 const& p) const;
+        // reloads evicted tiles of the grids around both positions and keeps them from being evicted
+        void EnsureEndTilesLoaded(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos) const;
+        // reloads evicted tiles on the straight line between both positions and along the current path, returns true if any was reloaded
+        bool ReloadEvictedTilesOnPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos) const;
 
         void BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
         void BuildPointPath(float const* startPoint, float const* endPoint);
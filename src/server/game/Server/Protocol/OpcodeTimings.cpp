@@ -0,0 +1,99 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OpcodeTimings.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+uint64 OpcodeTimings::Entry::GetPercentile(float percentile) const
+{
+    uint64 threshold = uint64(std::ceil(Count * percentile));
+    uint64 seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += Buckets[i];
+        if (seen >= threshold && seen)
+            return i + 1 < BUCKET_COUNT ? (UI64LIT(1) << i) : MaxMicroseconds;
+    }
+
+    return MaxMicroseconds;
+}
+
+OpcodeTimings* OpcodeTimings::instance()
+{
+    static OpcodeTimings instance;
+    return &instance;
+}
+
+void OpcodeTimings::Record(uint16 opcode, std::chrono::steady_clock::duration elapsed)
+{
+    if (opcode >= NUM_OPCODE_HANDLERS)
+        return;
+
+    uint64 microseconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    std::size_t bucket = std::min<std::size_t>(std::bit_width(microseconds), BUCKET_COUNT - 1);
+
+    Counters& counters = _counters[opcode];
+    counters.Count.fetch_add(1, std::memory_order_relaxed);
+    counters.TotalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+    counters.Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 max = counters.MaxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > max && !counters.MaxMicroseconds.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+        ;
+}
+
+std::vector<OpcodeTimings::Entry> OpcodeTimings::GetMostExpensive(std::size_t count) const
+{
+    std::vector<Entry> entries;
+    for (std::size_t opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+    {
+        Counters const& counters = _counters[opcode];
+        if (!counters.Count.load(std::memory_order_relaxed))
+            continue;
+
+        Entry& entry = entries.emplace_back();
+        entry.Opcode = uint16(opcode);
+        entry.Count = counters.Count.load(std::memory_order_relaxed);
+        entry.TotalMicroseconds = counters.TotalMicroseconds.load(std::memory_order_relaxed);
+        entry.MaxMicroseconds = counters.MaxMicroseconds.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+            entry.Buckets[i] = counters.Buckets[i].load(std::memory_order_relaxed);
+    }
+
+    std::size_t resultSize = std::min(count, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + resultSize, entries.end(), [](Entry const& left, Entry const& right)
+    {
+        return left.TotalMicroseconds > right.TotalMicroseconds;
+    });
+    entries.resize(resultSize);
+    return entries;
+}
+
+void OpcodeTimings::Reset()
+{
+    for (Counters& counters : _counters)
+    {
+        counters.Count.store(0, std::memory_order_relaxed);
+        counters.TotalMicroseconds.store(0, std::memory_order_relaxed);
+        counters.MaxMicroseconds.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64>& bucket : counters.Buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_OPCODETIMINGS_H
+#define TRINITY_OPCODETIMINGS_H
+
+#include "Define.h"
+#include "Opcodes.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/// Per opcode histogram of client packet processing times, used to find handlers that are expensive under load
+class TC_GAME_API OpcodeTimings
+{
+    public:
+        // bucket 0 counts packets processed in under 1 microsecond, bucket i those that took [2^(i-1), 2^i) microseconds
+        // and the last bucket is open ended
+        static constexpr std::size_t BUCKET_COUNT = 24;
+
+        struct Entry
+        {
+            uint16 Opcode = 0;
+            uint64 Count = 0;
+            uint64 TotalMicroseconds = 0;
+            uint64 MaxMicroseconds = 0;
+            std::array<uint64, BUCKET_COUNT> Buckets = { };
+
+            /// Upper bound (in microseconds) of the bucket containing given percentile
+            uint64 GetPercentile(float percentile) const;
+        };
+
+        static OpcodeTimings* instance();
+
+        void Record(uint16 opcode, std::chrono::steady_clock::duration elapsed);
+
+        /// Opcodes with the highest total processing time, most expensive first
+        std::vector<Entry> GetMostExpensive(std::size_t count) const;
+
+        void Reset();
+
+    private:
+        OpcodeTimings() = default;
+        ~OpcodeTimings() = default;
+
+        struct Counters
+        {
+            std::atomic<uint64> Count;
+            std::atomic<uint64> TotalMicroseconds;
+            std::atomic<uint64> MaxMicroseconds;
+            std::array<std::atomic<uint64>, BUCKET_COUNT> Buckets;
+        };
+
+        std::array<Counters, NUM_OPCODE_HANDLERS> _counters = { };
+};
+
+#define sOpcodeTimings OpcodeTimings::instance()
+
+#endif
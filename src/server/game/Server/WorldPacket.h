@@ -22,6 +22,7 @@
 #include "Opcodes.h"
 #include "ByteBuffer.h"
 #include "Duration.h"
+#include <atomic>
 
 class WorldPacket : public ByteBuffer
 {
@@ -73,7 +74,7 @@ class WorldPacket : public ByteBuffer
         void Initialize(uint16 opcode, size_t newres = 200)
         {
             clear();
-            _storage.reserve(newres);
+            reserve(newres);
             m_opcode = opcode;
         }
 
@@ -82,6 +83,8 @@ class WorldPacket : public ByteBuffer
 
         TimePoint GetReceivedTime() const { return m_receivedTime; }
 
+        std::atomic<WorldPacket*> SessionQueueLink;
+
     protected:
         uint16 m_opcode;
         TimePoint m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
@@ -42,6 +42,7 @@
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "Opcodes.h"
+#include "OpcodeTimings.h"
 #include "OutdoorPvPMgr.h"
 #include "PacketUtilities.h"
 #include "Player.h"
@@ -178,8 +179,11 @@ WorldSession::~WorldSession()
     delete _gameClient;
 
     ///- empty incoming packet queue
+    for (WorldPacket* packet : _recvBatch)
+        delete packet;
+
     WorldPacket* packet = nullptr;
-    while (_recvQueue.next(packet))
+    while (_recvQueue.Dequeue(packet))
         delete packet;
 
     LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = {};", GetAccountId());     // One-time query
@@ -209,11 +213,27 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    if (!PrepareSendPacket(packet))
+        return;
+
+    m_Socket->SendPacket(*packet);
+}
+
+void WorldSession::SendPacket(WorldPacket&& packet)
+{
+    if (!PrepareSendPacket(&packet))
+        return;
+
+    m_Socket->SendPacket(std::move(packet));
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const* packet)
 {
     ASSERT(packet->GetOpcode() != NULL_OPCODE);
 
     if (!m_Socket)
-        return;
+        return false;
 
 #ifdef TRINITY_DEBUG
     // Code for network use statistic
@@ -257,19 +277,19 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         if (Forge* f = plr->GetForge())
         {
             if (!f->OnPacketSend(this, *packet))
-                return;
+                return false;
         }
     }
 #endif
 
     TC_LOG_TRACE("network.opcode", "S->C: {} {}", GetPlayerInfo(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())));
-    m_Socket->SendPacket(*packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
-    _recvQueue.add(new_packet);
+    _recvQueue.Enqueue(new_packet);
 }
 
 /// Logging helper for unexpected opcodes
@@ -310,8 +330,16 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     constexpr uint32 MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE = 100;
 
-    while (m_Socket && _recvQueue.next(packet, updater))
+    // take everything the network thread queued so far in one pass, the rest of the update works on the local batch
+    while (_recvQueue.Dequeue(packet))
+        _recvBatch.push_back(packet);
+
+    while (m_Socket && !_recvBatch.empty() && updater.Process(_recvBatch.front()))
     {
+        packet = _recvBatch.front();
+        _recvBatch.pop_front();
+
+        std::chrono::steady_clock::time_point processingStart = std::chrono::steady_clock::now();
         OpcodeClient opcode = static_cast<OpcodeClient>(packet->GetOpcode());
         ClientOpcodeHandler const* opHandle = opcodeTable[opcode];
         TC_METRIC_DETAILED_TIMER("worldsession_update_opcode_time", TC_METRIC_TAG("opcode", opHandle->Name));
@@ -456,7 +484,10 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
+        {
+            sOpcodeTimings->Record(opcode, std::chrono::steady_clock::now() - processingStart);
             delete packet;
+        }
 
         deletePacket = true;
 
@@ -470,7 +501,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     TC_METRIC_VALUE("processed_packets", processedPackets);
 
-    _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
+    _recvBatch.insert(_recvBatch.begin(), requeuePackets.begin(), requeuePackets.end());
 
     if (!updater.ProcessUnsafe()) // <=> updater is of type MapSessionFilter
     {
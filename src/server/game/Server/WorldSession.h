@@ -27,11 +27,12 @@
 #include "AuthDefines.h"
 #include "DatabaseEnvFwd.h"
 #include "Duration.h"
-#include "LockedQueue.h"
+#include "MPSCQueue.h"
 #include "ObjectGuid.h"
 #include "Packet.h"
 #include "SharedDefines.h"
 #include <boost/circular_buffer_fwd.hpp>
+#include <deque>
 #include <string>
 #include <map>
 #include <memory>
@@ -472,6 +473,8 @@ class TC_GAME_API WorldSession
         void static WriteMovementInfo(WorldPacket* data, MovementInfo* mi);
 
         void SendPacket(WorldPacket const* packet);
+        /// Hands the packet storage over to the socket without copying it, packet is left empty
+        void SendPacket(WorldPacket&& packet);
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
         void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName *declinedName);
@@ -1246,6 +1249,8 @@ class TC_GAME_API WorldSession
 
         bool CanUseBank(ObjectGuid bankerGUID = ObjectGuid::Empty) const;
 
+        bool PrepareSendPacket(WorldPacket const* packet);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char *reason);
         void LogUnprocessedTail(WorldPacket* packet);
@@ -1319,7 +1324,8 @@ class TC_GAME_API WorldSession
         } _addons;
         uint32 recruiterId;
         bool isRecruiter;
-        LockedQueue<WorldPacket*> _recvQueue;
+        MPSCQueue<WorldPacket, &WorldPacket::SessionQueueLink> _recvQueue;
+        std::deque<WorldPacket*> _recvBatch;                // packets taken from _recvQueue, only accessed by the thread updating the session
         rbac::RBACData* _RBACData;
         uint32 expireTime;
         bool forceExit;
@@ -34,10 +34,14 @@
 #endif
 #include "World.h"
 #include "WorldSession.h"
+#include <algorithm>
 #include <memory>
 
 using boost::asio::ip::tcp;
 
+// payloads of at least this size are queued for sending as they are instead of being copied into the send buffer
+static constexpr std::size_t SEND_PACKET_COPY_LIMIT = 0x400;
+
 WorldSocket::WorldSocket(tcp::socket&& socket)
     : Socket(std::move(socket)), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _sendBufferSize(4096)
 {
@@ -92,30 +96,34 @@ bool WorldSocket::Update()
         do
         {
             ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
-            if (queued->NeedsEncryption())
-                _authCrypt.EncryptSend(header.header, header.getHeaderLength());
+            std::size_t headerLength = header.getHeaderLength();
 
-            if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
-            {
-                QueuePacket(std::move(buffer));
-                buffer.Resize(_sendBufferSize);
-            }
+            // large payloads are not copied, their storage is queued right after the header and sent with one gathered write
+            bool handOver = queued->size() >= SEND_PACKET_COPY_LIMIT;
+            std::size_t copySize = headerLength + (handOver ? 0 : queued->size());
 
-            if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
+            if (buffer.GetRemainingSpace() < copySize)
             {
-                buffer.Write(header.header, header.getHeaderLength());
-                if (!queued->empty())
-                    buffer.Write(queued->contents(), queued->size());
+                if (buffer.GetActiveSize() > 0)
+                    QueuePacket(std::move(buffer));
+
+                buffer.Reset();
+                buffer.Resize(std::max(_sendBufferSize, copySize));
             }
-            else    // single packet larger than buffer size
-            {
-                MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-                packetBuffer.Write(header.header, header.getHeaderLength());
-                if (!queued->empty())
-                    packetBuffer.Write(queued->contents(), queued->size());
 
-                QueuePacket(std::move(packetBuffer));
+            // header is encrypted in place, right where it will be sent from
+            uint8* headerPos = buffer.GetWritePointer();
+            buffer.Write(header.header, headerLength);
+            if (queued->NeedsEncryption())
+                _authCrypt.EncryptSend(headerPos, headerLength);
+
+            if (handOver)
+            {
+                QueuePacket(std::move(buffer));
+                QueuePacket(MessageBuffer(queued->Move()));
             }
+            else if (!queued->empty())
+                buffer.Write(queued->contents(), queued->size());
 
             delete queued;
         } while (_bufferQueue.Dequeue(queued));
@@ -429,6 +437,17 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
+void WorldSocket::SendPacket(WorldPacket&& packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt.IsInitialized()));
+}
+
 void WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 {
     std::shared_ptr<AuthSession> authSession = std::make_shared<AuthSession>();
@@ -37,6 +37,11 @@ public:
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    EncryptablePacket(WorldPacket&& packet, bool encrypt) : WorldPacket(std::move(packet)), _encrypt(encrypt)
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
     bool NeedsEncryption() const { return _encrypt; }
 
     std::atomic<EncryptablePacket*> SocketQueueLink;
@@ -79,6 +84,7 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(WorldPacket&& packet);
 
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
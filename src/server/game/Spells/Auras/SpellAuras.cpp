@@ -24,6 +24,7 @@
 #include "Log.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "Opcodes.h"
 #include "Player.h"
 #include "ScriptMgr.h"
@@ -48,6 +49,32 @@ AuraCreateInfo::AuraCreateInfo(SpellInfo const* spellInfo, uint8 auraEffMask, Wo
     ASSERT(auraEffMask <= MAX_EFFECT_MASK);
 }
 
+namespace
+{
+    Trinity::ObjectPool AuraApplicationPool("AuraApplication", sizeof(AuraApplication));
+    Trinity::ObjectPool AuraPool("Aura", std::max(sizeof(UnitAura), sizeof(DynObjAura)));
+}
+
+void* AuraApplication::operator new(std::size_t size)
+{
+    return AuraApplicationPool.Allocate(size);
+}
+
+void AuraApplication::operator delete(void* ptr, std::size_t size)
+{
+    AuraApplicationPool.Deallocate(ptr, size);
+}
+
+void* Aura::operator new(std::size_t size)
+{
+    return AuraPool.Allocate(size);
+}
+
+void Aura::operator delete(void* ptr, std::size_t size)
+{
+    AuraPool.Deallocate(ptr, size);
+}
+
 AuraApplication::AuraApplication(Unit* target, Unit* caster, Aura* aura, uint8 effMask) :
 _target(target), _base(aura), _removeMode(AURA_REMOVE_NONE), _slot(MAX_AURAS),
 _flags(AFLAG_NONE), _effectsToApply(effMask), _needClientUpdate(false)
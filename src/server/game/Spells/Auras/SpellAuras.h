@@ -63,6 +63,10 @@ class TC_GAME_API AuraApplication
         void _HandleEffect(uint8 effIndex, bool apply);
 
     public:
+        // storage comes from a slab pool, see .debug objectpools
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         Unit* GetTarget() const { return _target; }
         Aura* GetBase() const { return _base; }
 
@@ -112,6 +116,10 @@ class TC_GAME_API Aura
         void SaveCasterInfo(Unit* caster);
         virtual ~Aura();
 
+        // storage for every aura type comes from one slab pool, see .debug objectpools
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         SpellInfo const* GetSpellInfo() const { return m_spellInfo; }
         uint32 GetId() const{ return GetSpellInfo()->Id; }
 
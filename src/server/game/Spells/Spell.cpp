@@ -39,6 +39,7 @@
 #include "MotionMaster.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "Opcodes.h"
 #include "PathGenerator.h"
 #include "Pet.h"
@@ -495,6 +496,9 @@ public:
     explicit SpellEvent(Spell* spell);
     ~SpellEvent();
 
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+
     bool Execute(uint64 e_time, uint32 p_time) override;
     void Abort(uint64 e_time) override;
     bool IsDeletable() const override;
@@ -507,6 +511,32 @@ protected:
     Trinity::unique_trackable_ptr<Spell> m_Spell;
 };
 
+namespace
+{
+    Trinity::ObjectPool SpellPool("Spell", sizeof(Spell));
+    Trinity::ObjectPool SpellEventPool("SpellEvent", sizeof(SpellEvent));
+}
+
+void* Spell::operator new(std::size_t size)
+{
+    return SpellPool.Allocate(size);
+}
+
+void Spell::operator delete(void* ptr, std::size_t size)
+{
+    SpellPool.Deallocate(ptr, size);
+}
+
+void* SpellEvent::operator new(std::size_t size)
+{
+    return SpellEventPool.Allocate(size);
+}
+
+void SpellEvent::operator delete(void* ptr, std::size_t size)
+{
+    SpellEventPool.Deallocate(ptr, size);
+}
+
 Spell::Spell(WorldObject* caster, SpellInfo const* info, TriggerCastFlags triggerFlags, ObjectGuid originalCasterGUID) :
 m_spellInfo(sSpellMgr->GetSpellForDifficultyFromSpell(info, caster)),
 m_caster((info->HasAttribute(SPELL_ATTR6_CAST_BY_CHARMER) && caster->GetCharmerOrOwner()) ? caster->GetCharmerOrOwner() : caster)
@@ -1327,10 +1357,15 @@ void Spell::SelectImplicitAreaTargets(SpellEffectInfo const& spellEffectInfo, Sp
             Trinity::Containers::RandomResize(targets, maxTargets);
         }
 
+        std::unordered_map<Unit const*, bool> lineOfSight = GetAreaTargetsLineOfSight(targets, *center);
+
         for (WorldObject* itr : targets)
         {
             if (Unit* unit = itr->ToUnit())
-                AddUnitTarget(unit, effMask, false, true, center);
+            {
+                auto los = lineOfSight.find(unit);
+                AddUnitTarget(unit, effMask, false, true, center, los != lineOfSight.end() ? Optional<bool>(los->second) : Optional<bool>());
+            }
             else if (GameObject* gObjTarget = itr->ToGameObject())
                 AddGOTarget(gObjTarget, effMask);
             else if (Corpse* corpse = itr->ToCorpse())
@@ -2118,10 +2153,10 @@ class ProcReflectDelayed : public BasicEvent
         ObjectGuid _casterGuid;
 };
 
-void Spell::AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid /*= true*/, bool implicit /*= true*/, Position const* losPosition /*= nullptr*/)
+void Spell::AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid /*= true*/, bool implicit /*= true*/, Position const* losPosition /*= nullptr*/, Optional<bool> inLineOfSight /*= {}*/)
 {
     for (SpellEffectInfo const& spellEffectInfo : m_spellInfo->GetEffects())
-        if (!spellEffectInfo.IsEffect() || !CheckEffectTarget(target, spellEffectInfo, losPosition))
+        if (!spellEffectInfo.IsEffect() || !CheckEffectTarget(target, spellEffectInfo, losPosition, inLineOfSight))
             effectMask &= ~(1 << spellEffectInfo.EffectIndex);
 
     // no effects left
@@ -7388,7 +7423,7 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return CURRENT_GENERIC_SPELL;
 }
 
-bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition) const
+bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition, Optional<bool> inLineOfSight /*= {}*/) const
 {
     switch (spellEffectInfo.ApplyAuraName)
     {
@@ -7410,17 +7445,7 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEf
             break;
     }
 
-    // check for ignore LOS on the effect itself
-    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
-        return true;
-
-    // check if gameobject ignores LOS
-    if (GameObject const* gobCaster = m_caster->ToGameObject())
-        if (gobCaster->GetGOInfo()->IsIgnoringLOSChecks())
-            return true;
-
-    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
-    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+    if (IsIgnoringLineOfSight())
         return true;
 
     /// @todo shit below shouldn't be here, but it's temporary
@@ -7475,7 +7500,12 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEf
         default:                                            // normal case
         {
             if (losPosition)
+            {
+                if (inLineOfSight)
+                    return *inLineOfSight;
+
                 return target->IsWithinLOS(losPosition->GetPositionX(), losPosition->GetPositionY(), losPosition->GetPositionZ(), LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2);
+            }
             else
             {
                 // Get GO cast coordinates if original caster -> GO
@@ -7494,6 +7524,60 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEf
     return true;
 }
 
+bool Spell::IsIgnoringLineOfSight() const
+{
+    // check for ignore LOS on the effect itself
+    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
+        return true;
+
+    // check if gameobject ignores LOS
+    if (GameObject const* gobCaster = m_caster->ToGameObject())
+        if (gobCaster->GetGOInfo()->IsIgnoringLOSChecks())
+            return true;
+
+    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
+    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+        return true;
+
+    return false;
+}
+
+std::unordered_map<Unit const*, bool> Spell::GetAreaTargetsLineOfSight(std::list<WorldObject*> const& targets, Position const& losPosition) const
+{
+    std::unordered_map<Unit const*, bool> lineOfSight;
+    if (IsIgnoringLineOfSight())
+        return lineOfSight;
+
+    std::vector<Unit const*> units;
+    for (WorldObject const* target : targets)
+        if (Unit const* unit = target->ToUnit())
+            if (unit->IsInWorld())
+                units.push_back(unit);
+
+    // gameobject checks depend on the phase of the target, every phase gets its own batch
+    std::sort(units.begin(), units.end(), [](Unit const* left, Unit const* right) { return left->GetPhaseMask() < right->GetPhaseMask(); });
+
+    std::vector<VMAP::LineOfSightQuery> queries(units.size());
+    for (std::size_t i = 0; i < units.size(); ++i)
+        units[i]->GetLineOfSightQuery(losPosition.GetPositionX(), losPosition.GetPositionY(), losPosition.GetPositionZ(), queries[i]);
+
+    for (std::size_t begin = 0; begin < units.size();)
+    {
+        uint32 phaseMask = units[begin]->GetPhaseMask();
+        std::size_t end = begin + 1;
+        while (end < units.size() && units[end]->GetPhaseMask() == phaseMask)
+            ++end;
+
+        m_caster->GetMap()->isInLineOfSight(std::span(queries).subspan(begin, end - begin), phaseMask, LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2);
+        begin = end;
+    }
+
+    for (std::size_t i = 0; i < units.size(); ++i)
+        lineOfSight.emplace(units[i], queries[i].inLineOfSight);
+
+    return lineOfSight;
+}
+
 bool Spell::IsTriggered() const
 {
     return (_triggeredCastFlags & TRIGGERED_FULL_MASK) != 0;
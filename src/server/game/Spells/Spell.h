@@ -21,11 +21,13 @@
 #include "ConditionMgr.h"
 #include "DBCEnums.h"
 #include "ObjectGuid.h"
+#include "Optional.h"
 #include "Position.h"
 #include "SharedDefines.h"
 #include "SpellDefines.h"
 #include "UniqueTrackablePtr.h"
 #include <memory>
+#include <unordered_map>
 
 namespace WorldPackets
 {
@@ -283,6 +285,10 @@ class TC_GAME_API Spell
         Spell(WorldObject* caster, SpellInfo const* info, TriggerCastFlags triggerFlags, ObjectGuid originalCasterGUID = ObjectGuid::Empty);
         ~Spell();
 
+        // storage comes from a slab pool, see .debug objectpools
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         void InitExplicitTargets(SpellCastTargets const& targets);
         void SelectExplicitTargets();
 
@@ -360,7 +366,10 @@ class TC_GAME_API Spell
         void UpdateSpellCastDataTargets(WorldPackets::Spells::SpellCastData& data);
         void UpdateSpellCastDataAmmo(WorldPackets::Spells::SpellAmmo& data);
 
-        bool CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition) const;
+        bool CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition, Optional<bool> inLineOfSight = {}) const;
+        bool IsIgnoringLineOfSight() const;
+        // line of sight from every unit in targets to losPosition, checked in batches
+        std::unordered_map<Unit const*, bool> GetAreaTargetsLineOfSight(std::list<WorldObject*> const& targets, Position const& losPosition) const;
         bool CanAutoCast(Unit* target);
         void CheckSrc();
         void CheckDst();
@@ -627,7 +636,7 @@ class TC_GAME_API Spell
 
         SpellDestination m_destTargets[MAX_SPELL_EFFECTS];
 
-        void AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid = true, bool implicit = true, Position const* losPosition = nullptr);
+        void AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid = true, bool implicit = true, Position const* losPosition = nullptr, Optional<bool> inLineOfSight = {});
         void AddGOTarget(GameObject* target, uint32 effectMask);
         void AddItemTarget(Item* item, uint32 effectMask);
         void AddCorpseTarget(Corpse* target, uint32 effectMask);
@@ -741,12 +750,17 @@ namespace Trinity
 
     struct TC_GAME_API WorldObjectSpellAreaTargetCheck : public WorldObjectSpellTargetCheck
     {
+        static constexpr bool IsRangeLimited = true;
+
         float _range;
         Position const* _position;
         WorldObjectSpellAreaTargetCheck(float range, Position const* position, WorldObject* caster,
             WorldObject* referer, SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionContainer const* condList);
 
         bool operator()(WorldObject* target) const;
+
+        Position const* GetSearchCenter() const { return _position; }
+        float GetSearchRadius() const { return _range; }
     };
 
     struct TC_GAME_API WorldObjectSpellConeTargetCheck : public WorldObjectSpellAreaTargetCheck
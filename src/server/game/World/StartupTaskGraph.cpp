@@ -0,0 +1,121 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StartupTaskGraph.h"
+#include "Errors.h"
+#include "Log.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <mutex>
+
+StartupTaskGraph::StartupTaskGraph(std::string group) : _group(std::move(group)), _wallTime(0)
+{
+}
+
+StartupTaskGraph::TaskId StartupTaskGraph::AddTask(std::string name, std::function<void()> work, std::initializer_list<TaskId> dependencies)
+{
+    TaskId id = _tasks.size();
+    Task& task = _tasks.emplace_back();
+    task.Work = std::move(work);
+    for (TaskId dependency : dependencies)
+    {
+        ASSERT(dependency < id, "Startup task %s of group %s depends on a task added after it", name.c_str(), _group.c_str());
+        _tasks[dependency].Dependents.push_back(id);
+        ++task.DependencyCount;
+    }
+
+    _timings.push_back({ _group, std::move(name), Milliseconds::zero(), Milliseconds::zero() });
+    return id;
+}
+
+void StartupTaskGraph::Run(uint32 numThreads)
+{
+    TimePoint start = std::chrono::steady_clock::now();
+
+    if (!numThreads)
+    {
+        for (TaskId id = 0; id < _tasks.size(); ++id)
+            Execute(id, start);
+    }
+    else
+    {
+        Trinity::ThreadPool pool(numThreads);
+        std::mutex lock;
+
+        // finishing a task posts every dependent it was the last dependency of, Join returns once no work is left
+        std::function<void(TaskId)> post = [&](TaskId id)
+        {
+            pool.PostWork([&, id]()
+            {
+                Execute(id, start);
+
+                std::vector<TaskId> ready;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    for (TaskId dependent : _tasks[id].Dependents)
+                        if (!--_tasks[dependent].DependencyCount)
+                            ready.push_back(dependent);
+                }
+
+                for (TaskId dependent : ready)
+                    post(dependent);
+            });
+        };
+
+        for (TaskId id = 0; id < _tasks.size(); ++id)
+            if (!_tasks[id].DependencyCount)
+                post(id);
+
+        pool.Join();
+    }
+
+    _wallTime = std::chrono::duration_cast<Milliseconds>(std::chrono::steady_clock::now() - start);
+
+    Milliseconds total = Milliseconds::zero();
+    for (StartupTaskTiming const& timing : _timings)
+        total += timing.Duration;
+
+    TC_LOG_INFO("server.loading", ">> Loaded {} ({} tasks) in {} ms, {} ms if run one after another", _group, _tasks.size(), _wallTime.count(), total.count());
+}
+
+void StartupTaskGraph::Execute(TaskId id, TimePoint groupStart)
+{
+    TimePoint start = std::chrono::steady_clock::now();
+    _tasks[id].Work();
+    TimePoint end = std::chrono::steady_clock::now();
+
+    _timings[id].Start = std::chrono::duration_cast<Milliseconds>(start - groupStart);
+    _timings[id].Duration = std::chrono::duration_cast<Milliseconds>(end - start);
+}
+
+void StartupTaskGraph::LogTimingTable(std::vector<StartupTaskTiming> const& timings)
+{
+    std::vector<StartupTaskTiming const*> sorted;
+    sorted.reserve(timings.size());
+    for (StartupTaskTiming const& timing : timings)
+        sorted.push_back(&timing);
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](StartupTaskTiming const* left, StartupTaskTiming const* right)
+    {
+        return left->Duration > right->Duration;
+    });
+
+    TC_LOG_INFO("server.loading", "Startup loader timings:");
+    TC_LOG_INFO("server.loading", "{:<24} {:<40} {:>10} {:>10}", "Group", "Loader", "Start ms", "Time ms");
+    for (StartupTaskTiming const* timing : sorted)
+        TC_LOG_INFO("server.loading", "{:<24} {:<40} {:>10} {:>10}", timing->Group, timing->Name, timing->Start.count(), timing->Duration.count());
+}
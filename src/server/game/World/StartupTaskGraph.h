@@ -0,0 +1,76 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_STARTUPTASKGRAPH_H
+#define TRINITY_STARTUPTASKGRAPH_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+struct StartupTaskTiming
+{
+    std::string Group;
+    std::string Name;
+    Milliseconds Start;                                     // since the group started
+    Milliseconds Duration;
+};
+
+/// A group of startup loaders with declared dependencies, tasks whose dependencies have finished run in parallel.
+/// Tasks must only write to their own stores and read stores of tasks they depend on or that were loaded before the group.
+class TC_GAME_API StartupTaskGraph
+{
+    public:
+        typedef std::size_t TaskId;
+
+        explicit StartupTaskGraph(std::string group);
+
+        StartupTaskGraph(StartupTaskGraph const&) = delete;
+        StartupTaskGraph& operator=(StartupTaskGraph const&) = delete;
+
+        /// Dependencies must be added first, which keeps the graph free of cycles
+        TaskId AddTask(std::string name, std::function<void()> work, std::initializer_list<TaskId> dependencies = { });
+
+        /// Blocks until every task finished, 0 threads runs them in the order they were added on the calling thread
+        void Run(uint32 numThreads);
+
+        std::vector<StartupTaskTiming> const& GetTimings() const { return _timings; }
+        Milliseconds GetWallTime() const { return _wallTime; }
+
+        /// Logs the given timings ordered by duration, most expensive first
+        static void LogTimingTable(std::vector<StartupTaskTiming> const& timings);
+
+    private:
+        struct Task
+        {
+            std::function<void()> Work;
+            std::vector<TaskId> Dependents;
+            uint32 DependencyCount = 0;
+        };
+
+        void Execute(TaskId id, TimePoint groupStart);
+
+        std::string _group;
+        std::vector<Task> _tasks;
+        std::vector<StartupTaskTiming> _timings;            // indexed by TaskId
+        Milliseconds _wallTime;
+};
+
+#endif
@@ -77,6 +77,7 @@
 #include "SkillExtraItems.h"
 #include "SmartScriptMgr.h"
 #include "SpellMgr.h"
+#include "StartupTaskGraph.h"
 #include "TicketMgr.h"
 #include "TransportMgr.h"
 #include "Unit.h"
@@ -92,6 +93,7 @@
 #include "ForgeConfig.h"
 #endif
 #include "WhoListStorage.h"
+#include "WorldDatabaseSnapshot.h"
 #include "WorldSession.h"
 
 #include <boost/asio/ip/address.hpp>
@@ -666,6 +668,7 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading", "Compression level ({}) must be in range 1..9. Using default compression level (1).", m_int_configs[CONFIG_COMPRESSION]);
         m_int_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_int_configs[CONFIG_COMPRESSION_MIN_SIZE] = sConfigMgr->GetIntDefault("Compression.MinSize", 100);
     m_bool_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_bool_configs[CONFIG_CLEAN_CHARACTER_DB] = sConfigMgr->GetBoolDefault("CleanCharacterDB", false);
     m_int_configs[CONFIG_PERSISTENT_CHARACTER_CLEAN_FLAGS] = sConfigMgr->GetIntDefault("PersistentCharacterCleanFlags", 0);
@@ -1415,6 +1418,9 @@ void World::LoadConfigSettings(bool reload)
     }
 
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", true);
+    m_int_configs[CONFIG_MMAP_PATH_CACHE_SIZE] = sConfigMgr->GetIntDefault("mmap.PathCacheSize", 512);
+    m_int_configs[CONFIG_MMAP_TILE_MEMORY_BUDGET] = sConfigMgr->GetIntDefault("mmap.TileMemoryBudget", 0);
+    MMAP::MMapFactory::createOrGetMMapManager()->SetTileMemoryBudget(std::size_t(m_int_configs[CONFIG_MMAP_TILE_MEMORY_BUDGET]) * 1024 * 1024);
     TC_LOG_INFO("server.loading", "WORLD: MMap data directory is: {}mmaps", m_dataPath);
 
     m_bool_configs[CONFIG_VMAP_INDOOR_CHECK] = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", false);
@@ -1427,6 +1433,7 @@ void World::LoadConfigSettings(bool reload)
 
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
+    VMAP::VMapFactory::createOrGetVMapManager()->setLineOfSightCacheSize(sConfigMgr->GetIntDefault("vmap.LineOfSightCacheSize", 4096));
     TC_LOG_INFO("server.loading", "VMap support included. LineOfSight: {}, getHeight: {}, indoorCheck: {}", enableLOS, enableHeight, enableIndoor);
     TC_LOG_INFO("server.loading", "VMap data directory is: {}vmaps", m_dataPath);
 
@@ -1451,6 +1458,8 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_MAP_GRID_PREFETCH_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.GridPrefetch.Threads", 1);
+    m_int_configs[CONFIG_STARTUP_LOAD_THREADS] = sConfigMgr->GetIntDefault("Startup.LoadThreads", 4);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1591,6 +1600,13 @@ void World::SetInitialWorldSettings()
     ///- Initialize config settings
     LoadConfigSettings();
 
+    ///- Independent loaders are grouped in StartupTaskGraphs, their timings are reported once startup finished
+    uint32 startupLoadThreads = getIntConfig(CONFIG_STARTUP_LOAD_THREADS);
+    std::vector<StartupTaskTiming> startupTimings;
+
+    ///- Binary snapshots of static world database data, outdated ones are ignored and rewritten by their loaders
+    sWorldDatabaseSnapshot->Initialize(sConfigMgr->GetStringDefault("WorldSnapshot.Directory", ""));
+
     ///- Initialize Allowed Security Level
     LoadDBAllowedSecurityLevel();
 
@@ -1722,22 +1738,25 @@ void World::SetInitialWorldSettings()
     sObjectMgr->LoadBroadcastTextLocales();
 
     TC_LOG_INFO("server.loading", "Loading Localization strings...");
-    uint32 oldMSTime = getMSTime();
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadItemLocales();
-    sObjectMgr->LoadItemSetNameLocales();
-    sObjectMgr->LoadQuestLocales();
-    sObjectMgr->LoadQuestOfferRewardLocale();
-    sObjectMgr->LoadQuestRequestItemsLocale();
-    sObjectMgr->LoadNpcTextLocales();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadPointOfInterestLocales();
-    sObjectMgr->LoadQuestGreetingLocales();
+    {
+        StartupTaskGraph locales("Localization strings");  // every locale table has its own store
+        locales.AddTask("creature_template_locale", []() { sObjectMgr->LoadCreatureLocales(); });
+        locales.AddTask("gameobject_template_locale", []() { sObjectMgr->LoadGameObjectLocales(); });
+        locales.AddTask("item_template_locale", []() { sObjectMgr->LoadItemLocales(); });
+        locales.AddTask("item_set_names_locale", []() { sObjectMgr->LoadItemSetNameLocales(); });
+        locales.AddTask("quest_template_locale", []() { sObjectMgr->LoadQuestLocales(); });
+        locales.AddTask("quest_offer_reward_locale", []() { sObjectMgr->LoadQuestOfferRewardLocale(); });
+        locales.AddTask("quest_request_items_locale", []() { sObjectMgr->LoadQuestRequestItemsLocale(); });
+        locales.AddTask("npc_text_locale", []() { sObjectMgr->LoadNpcTextLocales(); });
+        locales.AddTask("page_text_locale", []() { sObjectMgr->LoadPageTextLocales(); });
+        locales.AddTask("gossip_menu_option_locale", []() { sObjectMgr->LoadGossipMenuItemsLocales(); });
+        locales.AddTask("points_of_interest_locale", []() { sObjectMgr->LoadPointOfInterestLocales(); });
+        locales.AddTask("quest_greeting_locale", []() { sObjectMgr->LoadQuestGreetingLocales(); });
+        locales.Run(startupLoadThreads);
+        startupTimings.insert(startupTimings.end(), locales.GetTimings().begin(), locales.GetTimings().end());
+    }
 
     sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-    TC_LOG_INFO("server.loading", ">> Localization strings loaded in {} ms", GetMSTimeDiffToNow(oldMSTime));
 
     TC_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
     sAccountMgr->LoadRBAC();
@@ -1985,7 +2004,29 @@ void World::SetInitialWorldSettings()
     sObjectMgr->LoadMailLevelRewards();
 
     // Loot tables
-    LoadLootTables();
+    TC_LOG_INFO("server.loading", "Loading Loot Tables...");
+    {
+        StartupTaskGraph loot("Loot tables");
+        StartupTaskGraph::TaskId const tables[] =
+        {
+            loot.AddTask("creature_loot_template", &LoadLootTemplates_Creature),
+            loot.AddTask("fishing_loot_template", &LoadLootTemplates_Fishing),
+            loot.AddTask("gameobject_loot_template", &LoadLootTemplates_Gameobject),
+            loot.AddTask("item_loot_template", &LoadLootTemplates_Item),
+            loot.AddTask("mail_loot_template", &LoadLootTemplates_Mail),
+            loot.AddTask("milling_loot_template", &LoadLootTemplates_Milling),
+            loot.AddTask("pickpocketing_loot_template", &LoadLootTemplates_Pickpocketing),
+            loot.AddTask("skinning_loot_template", &LoadLootTemplates_Skinning),
+            loot.AddTask("disenchant_loot_template", &LoadLootTemplates_Disenchant),
+            loot.AddTask("prospecting_loot_template", &LoadLootTemplates_Prospecting),
+            loot.AddTask("spell_loot_template", &LoadLootTemplates_Spell)
+        };
+        // checks the references of all other loot stores
+        loot.AddTask("reference_loot_template", &LoadLootTemplates_Reference, { tables[0], tables[1], tables[2], tables[3], tables[4], tables[5],
+            tables[6], tables[7], tables[8], tables[9], tables[10] });
+        loot.Run(startupLoadThreads);
+        startupTimings.insert(startupTimings.end(), loot.GetTimings().begin(), loot.GetTimings().end());
+    }
 
     TC_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
     LoadSkillDiscoveryTable();
@@ -2040,29 +2081,20 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Loading GameTeleports...");
     sObjectMgr->LoadGameTele();
 
-    TC_LOG_INFO("server.loading", "Loading Trainers...");       // must be after LoadCreatureTemplates
-    sObjectMgr->LoadTrainers();
-
-    TC_LOG_INFO("server.loading", "Loading Creature default trainers...");
-    sObjectMgr->LoadCreatureDefaultTrainers();
-
-    TC_LOG_INFO("server.loading", "Loading Gossip menu...");
-    sObjectMgr->LoadGossipMenu();
-
-    TC_LOG_INFO("server.loading", "Loading Gossip menu options...");
-    sObjectMgr->LoadGossipMenuItems();                           // must be after LoadTrainers
-
-    TC_LOG_INFO("server.loading", "Loading Vendors...");
-    sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
-
-    TC_LOG_INFO("server.loading", "Loading Waypoints...");
-    sWaypointMgr->Load();
-
-    TC_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
-    sSmartWaypointMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Formations...");
-    sFormationMgr->LoadCreatureFormations();
+    TC_LOG_INFO("server.loading", "Loading Trainers, Gossip menus, Vendors, Waypoints and Creature Formations...");
+    {
+        StartupTaskGraph npcs("Npc data");
+        StartupTaskGraph::TaskId trainers = npcs.AddTask("trainer", []() { sObjectMgr->LoadTrainers(); });  // must be after LoadCreatureTemplates
+        npcs.AddTask("creature_default_trainer", []() { sObjectMgr->LoadCreatureDefaultTrainers(); }, { trainers });
+        npcs.AddTask("gossip_menu", []() { sObjectMgr->LoadGossipMenu(); });
+        npcs.AddTask("gossip_menu_option", []() { sObjectMgr->LoadGossipMenuItems(); }, { trainers });
+        npcs.AddTask("npc_vendor", []() { sObjectMgr->LoadVendors(); });                                // must be after load CreatureTemplate and ItemTemplate
+        npcs.AddTask("waypoint_data", []() { sWaypointMgr->Load(); });
+        npcs.AddTask("waypoints", []() { sSmartWaypointMgr->LoadFromDB(); });
+        npcs.AddTask("creature_formations", []() { sFormationMgr->LoadCreatureFormations(); });
+        npcs.Run(startupLoadThreads);
+        startupTimings.insert(startupTimings.end(), npcs.GetTimings().begin(), npcs.GetTimings().end());
+    }
 
     TC_LOG_INFO("server.loading", "Loading World States...");              // must be loaded before battleground, outdoor PvP and conditions
     LoadWorldStates();
@@ -2133,20 +2165,17 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Validating spell scripts...");
     sObjectMgr->ValidateSpellScripts();
 
-    TC_LOG_INFO("server.loading", "Loading SmartAI scripts...");
-    sSmartScriptMgr->LoadSmartAIFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Calendar data...");
-    sCalendarMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Petitions...");
-    sPetitionMgr->LoadPetitions();
-
-    TC_LOG_INFO("server.loading", "Loading Signatures...");
-    sPetitionMgr->LoadSignatures();
-
-    TC_LOG_INFO("server.loading", "Loading Item loot...");
-    sLootItemStorage->LoadStorageFromDB();
+    TC_LOG_INFO("server.loading", "Loading SmartAI scripts, Calendar data, Petitions and Item loot...");
+    {
+        StartupTaskGraph scripts("SmartAI and character data");
+        scripts.AddTask("smart_scripts", []() { sSmartScriptMgr->LoadSmartAIFromDB(); });
+        scripts.AddTask("calendar", []() { sCalendarMgr->LoadFromDB(); });
+        StartupTaskGraph::TaskId petitions = scripts.AddTask("petition", []() { sPetitionMgr->LoadPetitions(); });
+        scripts.AddTask("petition_sign", []() { sPetitionMgr->LoadSignatures(); }, { petitions });
+        scripts.AddTask("item_loot_storage", []() { sLootItemStorage->LoadStorageFromDB(); });
+        scripts.Run(startupLoadThreads);
+        startupTimings.insert(startupTimings.end(), scripts.GetTimings().begin(), scripts.GetTimings().end());
+    }
 
     TC_LOG_INFO("server.loading", "Initialize query data...");
     sObjectMgr->InitializeQueriesData(QUERY_DATA_ALL);
@@ -2278,6 +2307,11 @@ void World::SetInitialWorldSettings()
         });
     }
 
+    StartupTaskGraph::LogTimingTable(startupTimings);
+
+    ///- From now on reloads query the database and refresh the snapshots
+    sWorldDatabaseSnapshot->StopReading();
+
     uint32 startupDuration = GetMSTimeDiffToNow(startupBegin);
 
     TC_LOG_INFO("server.worldserver", "World initialized in {} minutes {} seconds", (startupDuration / 60000), ((startupDuration % 60000) / 1000));
@@ -212,6 +212,7 @@ enum WorldFloatConfigs : uint32
 enum WorldIntConfigs : uint32
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_MIN_SIZE,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
@@ -334,6 +335,8 @@ enum WorldIntConfigs : uint32
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_GRID_PREFETCH_THREADS,
+    CONFIG_STARTUP_LOAD_THREADS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -403,6 +406,8 @@ enum WorldIntConfigs : uint32
     CONFIG_RESPAWN_GUIDWARNING_FREQUENCY,
     CONFIG_SOCKET_TIMEOUTTIME_ACTIVE,
     CONFIG_PENDING_MOVE_CHANGES_TIMEOUT,
+    CONFIG_MMAP_PATH_CACHE_SIZE,
+    CONFIG_MMAP_TILE_MEMORY_BUDGET,
     INT_CONFIG_VALUE_COUNT
 };
 
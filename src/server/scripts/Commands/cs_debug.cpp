@@ -39,9 +39,12 @@ EndScriptData */
 #include "MapManager.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
+#include "OpcodeTimings.h"
 #include "PoolMgr.h"
 #include "QuestPools.h"
 #include "RBAC.h"
+#include "SmartEventStats.h"
 #include "SpellMgr.h"
 #include "Transport.h"
 #include "Warden.h"
@@ -119,7 +122,13 @@ public:
             { "asan outofbounds",   HandleDebugOutOfBounds,                rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "guidlimits",         HandleDebugGuidLimitsCommand,          rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "objectcount",        HandleDebugObjectCountCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "objectpools",        HandleDebugObjectPoolsCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "opcodetimes",        HandleDebugOpcodeTimesCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "opcodetimes reset",  HandleDebugOpcodeTimesResetCommand,    rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "questreset",         HandleDebugQuestResetCommand,          rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "smartevents",        HandleDebugSmartEventsCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "smartevents reset",  HandleDebugSmartEventsResetCommand,    rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "smartevents record", HandleDebugSmartEventsRecordCommand,   rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "warden force",       HandleDebugWardenForce,                rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes }
         };
         static ChatCommandTable commandTable =
@@ -1823,6 +1832,83 @@ public:
             handler->PSendSysMessage("Entry: %u Count: %u", p.first, p.second);
     }
 
+    static bool HandleDebugObjectPoolsCommand(ChatHandler* handler)
+    {
+        std::vector<Trinity::ObjectPoolStats> pools = Trinity::ObjectPool::GetAllStats();
+        if (pools.empty())
+        {
+            handler->SendSysMessage("No object pools exist.");
+            return true;
+        }
+
+        handler->SendSysMessage("Object pools (live objects that never go back to zero while idle point at leaks):");
+        for (Trinity::ObjectPoolStats const& pool : pools)
+            handler->PSendSysMessage("%s (%u bytes) Live: " UI64FMTD " Allocated: " UI64FMTD " Freed: " UI64FMTD " Oversized: " UI64FMTD " Slabs: " UI64FMTD " (%u KB)",
+                pool.Name, uint32(pool.ObjectSize), pool.GetLive(), pool.Allocated, pool.Freed, pool.Oversized, pool.Slabs, uint32(pool.GetReservedBytes() / 1024));
+
+        return true;
+    }
+
+    static bool HandleDebugOpcodeTimesCommand(ChatHandler* handler, Optional<uint32> count)
+    {
+        std::vector<OpcodeTimings::Entry> entries = sOpcodeTimings->GetMostExpensive(count.value_or(10));
+        if (entries.empty())
+        {
+            handler->SendSysMessage("No client packets were processed yet.");
+            return true;
+        }
+
+        handler->SendSysMessage("Most expensive client opcodes by total processing time (times in microseconds):");
+        for (OpcodeTimings::Entry const& entry : entries)
+            handler->PSendSysMessage("%s Count: " UI64FMTD " Total: " UI64FMTD " Avg: " UI64FMTD " p50: < " UI64FMTD " p99: < " UI64FMTD " Max: " UI64FMTD,
+                GetOpcodeNameForLogging(static_cast<OpcodeClient>(entry.Opcode)).c_str(), entry.Count, entry.TotalMicroseconds,
+                entry.TotalMicroseconds / entry.Count, entry.GetPercentile(0.5f), entry.GetPercentile(0.99f), entry.MaxMicroseconds);
+
+        return true;
+    }
+
+    static bool HandleDebugOpcodeTimesResetCommand(ChatHandler* handler)
+    {
+        sOpcodeTimings->Reset();
+        handler->SendSysMessage("Opcode processing times were reset.");
+        return true;
+    }
+
+    static bool HandleDebugSmartEventsCommand(ChatHandler* handler, Optional<uint32> count)
+    {
+        std::vector<SmartEventStats::Entry> entries = sSmartEventStats->GetMostExpensive(count.value_or(10));
+        if (entries.empty())
+        {
+            if (sSmartEventStats->IsEnabled())
+                handler->SendSysMessage("No SmartAI events were processed yet.");
+            else
+                handler->SendSysMessage("SmartAI event statistics are not being recorded, enable them with .debug smartevents record on");
+            return true;
+        }
+
+        handler->SendSysMessage("Most expensive SmartAI event types by total processing time (times in microseconds, including events they fired):");
+        for (SmartEventStats::Entry const& entry : entries)
+            handler->PSendSysMessage("Event type %u Count: " UI64FMTD " Handlers: " UI64FMTD " Total: " UI64FMTD " Avg: %.3f Max: %.3f",
+                uint32(entry.Event), entry.Count, entry.Handlers, entry.TotalNanoseconds / 1000,
+                double(entry.TotalNanoseconds) / entry.Count / 1000.0, double(entry.MaxNanoseconds) / 1000.0);
+
+        return true;
+    }
+
+    static bool HandleDebugSmartEventsResetCommand(ChatHandler* handler)
+    {
+        sSmartEventStats->Reset();
+        handler->SendSysMessage("SmartAI event statistics were reset.");
+        return true;
+    }
+
+    static bool HandleDebugSmartEventsRecordCommand(ChatHandler* handler, bool enable)
+    {
+        sSmartEventStats->SetEnabled(enable);
+        handler->PSendSysMessage("SmartAI event statistics recording %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
     static bool HandleDebugDummyCommand(ChatHandler* handler)
     {
         handler->SendSysMessage("This command does nothing right now. Edit your local core (cs_debug.cpp) to make it do whatever you need for testing.");
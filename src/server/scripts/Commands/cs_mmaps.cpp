@@ -137,9 +137,9 @@ public:
         handler->PSendSysMessage("tileloc [%i, %i]", gy, gx);
 
         // calculate navmesh tile location
-        dtNavMesh const* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(handler->GetSession()->GetPlayer()->GetMapId());
-        dtNavMeshQuery const* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(handler->GetSession()->GetPlayer()->GetMapId(), player->GetInstanceId());
-        if (!navmesh || !navmeshquery)
+        MMAP::NavMeshQueryLease navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(handler->GetSession()->GetPlayer()->GetMapId());
+        dtNavMesh const* navmesh = navmeshquery.GetNavMesh();
+        if (!navmesh)
         {
             handler->PSendSysMessage("NavMesh not loaded for current map.");
             return true;
@@ -189,9 +189,10 @@ public:
     static bool HandleMmapLoadedTilesCommand(ChatHandler* handler, char const* /*args*/)
     {
         uint32 mapid = handler->GetSession()->GetPlayer()->GetMapId();
-        dtNavMesh const* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapid);
-        dtNavMeshQuery const* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid, handler->GetSession()->GetPlayer()->GetInstanceId());
-        if (!navmesh || !navmeshquery)
+        // tiles can't be added or removed while the lease is held
+        MMAP::NavMeshQueryLease navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(mapid);
+        dtNavMesh const* navmesh = navmeshquery.GetNavMesh();
+        if (!navmesh)
         {
             handler->PSendSysMessage("NavMesh not loaded for current map.");
             return true;
@@ -219,8 +220,12 @@ public:
 
         MMAP::MMapManager* manager = MMAP::MMapFactory::createOrGetMMapManager();
         handler->PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
+        if (manager->getTileMemoryBudget())
+            handler->PSendSysMessage(" %u KB of tile data loaded, budget %u KB", uint32(manager->getLoadedTilesSize() / 1024), uint32(manager->getTileMemoryBudget() / 1024));
 
-        dtNavMesh const* navmesh = manager->GetNavMesh(handler->GetSession()->GetPlayer()->GetMapId());
+        // tiles can't be added or removed while the lease is held
+        MMAP::NavMeshQueryLease navmeshquery = manager->LeaseNavMeshQuery(mapId);
+        dtNavMesh const* navmesh = navmeshquery.GetNavMesh();
         if (!navmesh)
         {
             handler->PSendSysMessage("NavMesh not loaded for current map.");
@@ -248,6 +253,7 @@ public:
             triVertCount += tile->header->detailVertCount;
             dataSize += tile->dataSize;
         }
+        navmeshquery.Release();
 
         handler->PSendSysMessage("Navmesh stats:");
         handler->PSendSysMessage(" %u tiles loaded", tileCount);
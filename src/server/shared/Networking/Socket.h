@@ -21,7 +21,7 @@
 #include "MessageBuffer.h"
 #include "Log.h"
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <type_traits>
@@ -30,6 +30,7 @@
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+#define WRITE_GATHER_MAX_BUFFERS 16
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -42,6 +43,7 @@ public:
         _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
+        _writeBuffers.reserve(WRITE_GATHER_MAX_BUFFERS);
     }
 
     virtual ~Socket()
@@ -103,7 +105,7 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.push_back(std::move(buffer));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -151,8 +153,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        PrepareWriteBuffers();
+        _socket.async_write_some(_writeBuffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -172,6 +174,40 @@ protected:
     }
 
 private:
+    /// Collects the front of the write queue into one buffer sequence so it can be sent with a single gathered write
+    std::size_t PrepareWriteBuffers()
+    {
+        std::size_t bytesToSend = 0;
+        _writeBuffers.clear();
+        for (MessageBuffer& buffer : _writeQueue)
+        {
+            if (_writeBuffers.size() >= WRITE_GATHER_MAX_BUFFERS)
+                break;
+
+            _writeBuffers.emplace_back(buffer.GetReadPointer(), buffer.GetActiveSize());
+            bytesToSend += buffer.GetActiveSize();
+        }
+
+        return bytesToSend;
+    }
+
+    /// Removes fully sent buffers from the write queue
+    void WriteCompleted(std::size_t bytesSent)
+    {
+        while (!_writeQueue.empty())
+        {
+            MessageBuffer& buffer = _writeQueue.front();
+            if (buffer.GetActiveSize() > bytesSent)
+            {
+                buffer.ReadCompleted(bytesSent);
+                break;
+            }
+
+            bytesSent -= buffer.GetActiveSize();
+            _writeQueue.pop_front();
+        }
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -191,9 +227,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -217,37 +251,33 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        std::size_t bytesToSend = PrepareWriteBuffers();
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(_writeBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        WriteCompleted(bytesSent);
+        if (bytesSent < bytesToSend) // now n > 0
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -261,7 +291,8 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<MessageBuffer> _writeQueue;
+    std::vector<boost::asio::const_buffer> _writeBuffers;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
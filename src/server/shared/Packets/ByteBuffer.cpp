@@ -24,6 +24,7 @@
 #include <utf8.h>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 
 ByteBuffer::ByteBuffer(MessageBuffer&& buffer) : _rpos(0), _wpos(0), _storage(buffer.Move())
 {
@@ -98,14 +99,20 @@ void ByteBuffer::append(uint8 const* src, size_t cnt)
     size_t const newSize = _wpos + cnt;
     if (_storage.capacity() < newSize) // custom memory allocation rules
     {
+        size_t capacity;
         if (newSize < 100)
-            _storage.reserve(300);
+            capacity = 300;
         else if (newSize < 750)
-            _storage.reserve(2500);
+            capacity = 2500;
         else if (newSize < 6000)
-            _storage.reserve(10000);
+            capacity = 10000;
         else
-            _storage.reserve(400000);
+            capacity = std::max<size_t>(newSize, 400000);
+
+        std::vector<uint8> storage = Trinity::BufferPool::Acquire(capacity);
+        storage.assign(_storage.begin(), _storage.end());
+        Trinity::BufferPool::Release(_storage);
+        _storage = std::move(storage);
     }
 
     if (_storage.size() < newSize)
@@ -19,6 +19,7 @@
 #define _BYTEBUFFER_H
 
 #include "Define.h"
+#include "BufferPool.h"
 #include "ByteConverter.h"
 #include <array>
 #include <string>
@@ -72,14 +73,12 @@ class TC_SHARED_API ByteBuffer
         constexpr static size_t DEFAULT_SIZE = 0x1000;
 
         // constructor
-        ByteBuffer() : _rpos(0), _wpos(0)
+        ByteBuffer() : _rpos(0), _wpos(0), _storage(Trinity::BufferPool::Acquire(DEFAULT_SIZE))
         {
-            _storage.reserve(DEFAULT_SIZE);
         }
 
-        ByteBuffer(size_t reserve) : _rpos(0), _wpos(0)
+        ByteBuffer(size_t reserve) : _rpos(0), _wpos(0), _storage(Trinity::BufferPool::Acquire(reserve))
         {
-            _storage.reserve(reserve);
         }
 
         ByteBuffer(ByteBuffer&& buf) noexcept : _rpos(buf._rpos), _wpos(buf._wpos), _storage(std::move(buf._storage))
@@ -88,7 +87,10 @@ class TC_SHARED_API ByteBuffer
             buf._wpos = 0;
         }
 
-        ByteBuffer(ByteBuffer const& right) = default;
+        ByteBuffer(ByteBuffer const& right) : _rpos(right._rpos), _wpos(right._wpos), _storage(Trinity::BufferPool::Acquire(right._storage.size()))
+        {
+            _storage.assign(right._storage.begin(), right._storage.end());
+        }
 
         ByteBuffer(MessageBuffer&& buffer);
 
@@ -112,13 +114,17 @@ class TC_SHARED_API ByteBuffer
                 right._rpos = 0;
                 _wpos = right._wpos;
                 right._wpos = 0;
+                Trinity::BufferPool::Release(_storage);
                 _storage = std::move(right._storage);
             }
 
             return *this;
         }
 
-        virtual ~ByteBuffer() = default;
+        virtual ~ByteBuffer()
+        {
+            Trinity::BufferPool::Release(_storage);
+        }
 
         void clear()
         {
@@ -411,6 +417,9 @@ class TC_SHARED_API ByteBuffer
 
         void resize(size_t newsize)
         {
+            if (!_storage.capacity())
+                _storage = Trinity::BufferPool::Acquire(newsize);
+
             _storage.resize(newsize, 0);
             _rpos = 0;
             _wpos = size();
@@ -419,7 +428,12 @@ class TC_SHARED_API ByteBuffer
         void reserve(size_t ressize)
         {
             if (ressize > size())
-                _storage.reserve(ressize);
+            {
+                if (!_storage.capacity())
+                    _storage = Trinity::BufferPool::Acquire(ressize);
+                else
+                    _storage.reserve(ressize);
+            }
         }
 
         void shrink_to_fit()
@@ -427,6 +441,13 @@ class TC_SHARED_API ByteBuffer
             _storage.shrink_to_fit();
         }
 
+        std::vector<uint8>&& Move()
+        {
+            _rpos = 0;
+            _wpos = 0;
+            return std::move(_storage);
+        }
+
         void append(const char *src, size_t cnt)
         {
             return append((const uint8 *)src, cnt);
@@ -25,6 +25,7 @@
 #include "Banner.h"
 #include "BattlegroundMgr.h"
 #include "BigNumber.h"
+#include "BufferPool.h"
 #include "CliRunnable.h"
 #include "Configuration/Config.h"
 #include "DatabaseEnv.h"
@@ -51,6 +52,7 @@
 #include "SharedDefines.h"
 #include "TCSoap.h"
 #include "ThreadPool.h"
+#include "UpdateData.h"
 #include "World.h"
 #include "WorldSocket.h"
 #include "WorldSocketMgr.h"
@@ -305,6 +307,17 @@ extern int main(int argc, char** argv)
         TC_METRIC_VALUE("db_queue_login", uint64(LoginDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_character", uint64(CharacterDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_world", uint64(WorldDatabase.QueueSize()));
+
+        UpdateDataCompressionStats compression = UpdateData::GetCompressionStats();
+        TC_METRIC_VALUE("update_compression_packets", compression.Packets);
+        TC_METRIC_VALUE("update_compression_time", compression.Microseconds);
+        if (compression.InputBytes)
+            TC_METRIC_VALUE("update_compression_ratio", double(compression.OutputBytes) / double(compression.InputBytes));
+
+        Trinity::BufferPoolStats bufferPool = Trinity::BufferPool::GetStats();
+        TC_METRIC_VALUE("buffer_pool_hits", bufferPool.Hits);
+        TC_METRIC_VALUE("buffer_pool_misses", bufferPool.Misses);
+        TC_METRIC_VALUE("buffer_pool_discarded", bufferPool.Discarded);
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
@@ -0,0 +1,191 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Measures line of sight queries against extracted vmaps.
+ *
+ * Rays are generated around the ground of the given tile with a fixed seed, so runs are comparable.
+ * Every query set is timed through the single ray and the batch interface, once with the scalar and
+ * once with the SIMD triangle kernel, and the results of both kernels are compared.
+ */
+
+#include "Banner.h"
+#include "Locales.h"
+#include "TriangleBatch.h"
+#include "Util.h"
+#include "VMapManager2.h"
+#include <G3D/Vector3.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    float const TILE_SIZE = 533.33333333f;
+    float const MAX_QUERY_DISTANCE = 40.0f;
+
+    std::vector<VMAP::LineOfSightQuery> GenerateQueries(VMAP::VMapManager2& vmgr, uint32 mapId, uint32 tileX, uint32 tileY, uint32 count)
+    {
+        // same tile numbering as Map::LoadVMap, tiles count from the map center towards negative world coordinates
+        float const mid = 0.5f * 64.0f * TILE_SIZE;
+        std::mt19937 generator(tileX * 64 + tileY);
+        std::uniform_real_distribution<float> inTile(0.0f, TILE_SIZE);
+        std::uniform_real_distribution<float> offset(-MAX_QUERY_DISTANCE, MAX_QUERY_DISTANCE);
+        std::uniform_real_distribution<float> height(0.5f, 3.0f);
+
+        auto groundOrDefault = [&](float x, float y)
+        {
+            float ground = vmgr.getHeight(mapId, x, y, 1000.0f, 2000.0f);
+            return ground > VMAP_INVALID_HEIGHT ? ground : 0.0f;
+        };
+
+        std::vector<VMAP::LineOfSightQuery> queries(count);
+        for (VMAP::LineOfSightQuery& query : queries)
+        {
+            query.x1 = mid - (tileX * TILE_SIZE + inTile(generator));
+            query.y1 = mid - (tileY * TILE_SIZE + inTile(generator));
+            query.z1 = groundOrDefault(query.x1, query.y1) + height(generator);
+            query.x2 = query.x1 + offset(generator);
+            query.y2 = query.y1 + offset(generator);
+            query.z2 = groundOrDefault(query.x2, query.y2) + height(generator);
+        }
+
+        return queries;
+    }
+
+    struct BenchmarkResult
+    {
+        std::chrono::steady_clock::duration Time;
+        std::vector<bool> InLineOfSight;
+    };
+
+    // one query at a time, as most callers do
+    BenchmarkResult RunSingle(VMAP::VMapManager2& vmgr, uint32 mapId, std::vector<VMAP::LineOfSightQuery> const& queries, uint32 iterations)
+    {
+        BenchmarkResult result;
+        result.InLineOfSight.resize(queries.size());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+            for (std::size_t q = 0; q < queries.size(); ++q)
+                result.InLineOfSight[q] = vmgr.isInLineOfSight(mapId, queries[q].x1, queries[q].y1, queries[q].z1, queries[q].x2, queries[q].y2, queries[q].z2, VMAP::ModelIgnoreFlags::Nothing);
+
+        result.Time = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    BenchmarkResult RunBatch(VMAP::VMapManager2& vmgr, uint32 mapId, std::vector<VMAP::LineOfSightQuery> const& queries, uint32 iterations)
+    {
+        BenchmarkResult result;
+        std::vector<VMAP::LineOfSightQuery> batch;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            batch = queries;
+            vmgr.isInLineOfSight(mapId, batch, VMAP::ModelIgnoreFlags::Nothing);
+        }
+
+        result.Time = std::chrono::steady_clock::now() - start;
+        for (VMAP::LineOfSightQuery const& query : batch)
+            result.InLineOfSight.push_back(query.inLineOfSight);
+
+        return result;
+    }
+
+    void Report(char const* name, BenchmarkResult const& result, std::size_t queryCount, uint32 iterations)
+    {
+        double totalMs = std::chrono::duration<double, std::milli>(result.Time).count();
+        double perQueryNs = std::chrono::duration<double, std::nano>(result.Time).count() / (double(queryCount) * iterations);
+        std::size_t blocked = std::count(result.InLineOfSight.begin(), result.InLineOfSight.end(), false);
+        std::cout << name << ": " << totalMs << " ms total, " << perQueryNs << " ns per query, " << blocked << " blocked" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::VerifyOsVersion();
+
+    Trinity::Locale::Init();
+
+    Trinity::Banner::Show("VMAP benchmark", [](char const* text) { std::cout << text << std::endl; }, nullptr);
+
+    if (argc < 5 || argc > 7)
+    {
+        std::cout << "usage: " << argv[0] << " <vmap dir> <map id> <tile x> <tile y> [query count] [iterations]" << std::endl;
+        return 1;
+    }
+
+    std::string vmapPath = argv[1];
+    uint32 mapId = std::stoul(argv[2]);
+    uint32 tileX = std::stoul(argv[3]);
+    uint32 tileY = std::stoul(argv[4]);
+    uint32 queryCount = argc > 5 ? std::max(std::stoul(argv[5]), 1ul) : 10000;
+    uint32 iterations = argc > 6 ? std::max(std::stoul(argv[6]), 1ul) : 10;
+
+    if (tileX >= 64 || tileY >= 64)
+    {
+        std::cout << "tile coordinates must be below 64" << std::endl;
+        return 1;
+    }
+
+    VMAP::VMapManager2 vmgr;
+    uint32 loadedTiles = 0;
+    for (uint32 gx = std::max(tileX, 1u) - 1; gx <= std::min(tileX + 1, 63u); ++gx)
+        for (uint32 gy = std::max(tileY, 1u) - 1; gy <= std::min(tileY + 1, 63u); ++gy)
+            if (vmgr.loadMap(vmapPath.c_str(), mapId, gx, gy) == VMAP::VMAP_LOAD_RESULT_OK)
+                ++loadedTiles;
+
+    if (!loadedTiles)
+    {
+        std::cout << "no vmap tiles could be loaded around " << tileX << " " << tileY << " of map " << mapId << std::endl;
+        return 1;
+    }
+
+    std::vector<VMAP::LineOfSightQuery> queries = GenerateQueries(vmgr, mapId, tileX, tileY, queryCount);
+
+    std::cout << "running " << queries.size() << " queries " << iterations << " times, " << loadedTiles << " tiles loaded" << std::endl;
+
+    VMAP::TriangleBatch::SetSimdEnabled(false);
+    BenchmarkResult scalarSingle = RunSingle(vmgr, mapId, queries, iterations);
+    BenchmarkResult scalarBatch = RunBatch(vmgr, mapId, queries, iterations);
+    Report("scalar single", scalarSingle, queries.size(), iterations);
+    Report("scalar batch ", scalarBatch, queries.size(), iterations);
+
+    if (VMAP::TriangleBatch::IsSimdAvailable())
+    {
+        VMAP::TriangleBatch::SetSimdEnabled(true);
+        BenchmarkResult simdSingle = RunSingle(vmgr, mapId, queries, iterations);
+        BenchmarkResult simdBatch = RunBatch(vmgr, mapId, queries, iterations);
+        Report("simd single  ", simdSingle, queries.size(), iterations);
+        Report("simd batch   ", simdBatch, queries.size(), iterations);
+
+        if (simdSingle.InLineOfSight != scalarSingle.InLineOfSight || simdBatch.InLineOfSight != scalarBatch.InLineOfSight)
+        {
+            std::cout << "scalar and simd kernels disagree" << std::endl;
+            return 1;
+        }
+    }
+    else
+        std::cout << "simd kernel not available in this build" << std::endl;
+
+    vmgr.unloadMap(mapId);
+
+    return 0;
+}
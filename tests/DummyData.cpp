@@ -23,6 +23,7 @@
 #include "ObjectMgr.h"
 #include "SpellInfo.h"
 #include "SpellMgr.h"
+#include "ThreatManager.h"
 
 /*static*/ ItemTemplate& UnitTestDataLoader::GetItemTemplate(uint32 itemId, std::string_view name)
 {
@@ -336,3 +337,24 @@ static UnitTestDataLoader::DBC<TalentEntry, &TalentEntry::ID> talents(sTalentSto
     // this needs to be after the loader destructors
     sSpellMgr->LoadSpellInfoStore();
 }
+
+/*static*/ ThreatReference* UnitTestDataLoader::AddThreatListEntry(ThreatManager& mgr, ObjectGuid const& victim, float threat)
+{
+    ThreatReference* ref = new ThreatReference(&mgr, nullptr);
+    ref->_online = ThreatReference::ONLINE_STATE_ONLINE;
+    ref->_baseAmount = threat;
+    mgr.PutThreatListRef(victim, ref);
+    return ref;
+}
+
+/*static*/ void UnitTestDataLoader::RemoveThreatListEntry(ThreatManager& mgr, ObjectGuid const& victim)
+{
+    ThreatReference* ref = mgr.GetThreatListRef(victim);
+    mgr.PurgeThreatListRef(victim);
+    delete ref;
+}
+
+/*static*/ bool UnitTestDataLoader::IsThreatListSorted(ThreatManager const& mgr)
+{
+    return mgr._threatListSorted;
+}
@@ -27,7 +27,10 @@
 
 struct ItemTemplate;
 
+class ObjectGuid;
 class SpellInfo;
+class ThreatManager;
+class ThreatReference;
 
 class UnitTestDataLoader
 {
@@ -76,6 +79,11 @@ class UnitTestDataLoader
         static void LoadItemTemplates();
         static void LoadSpellInfo();
 
+        // online threat list entries for victims only known by their guid, no units are involved
+        static ThreatReference* AddThreatListEntry(ThreatManager& mgr, ObjectGuid const& victim, float threat);
+        static void RemoveThreatListEntry(ThreatManager& mgr, ObjectGuid const& victim);
+        static bool IsThreatListSorted(ThreatManager const& mgr);
+
     private:
         static ItemTemplate& GetItemTemplate(uint32 id, std::string_view name);
         static void SetItemLocale(uint32 id, LocaleConstant locale, std::string_view name);
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "tc_catch2.h"
+
+#include "BufferPool.h"
+
+using Trinity::BufferPool;
+using Trinity::BufferPoolStats;
+
+TEST_CASE("Acquired buffers are empty and large enough", "[BufferPool]")
+{
+    for (std::size_t capacity : { 1, 200, 0x1000, 10000, 400000, 0x200000 })
+    {
+        std::vector<uint8> storage = BufferPool::Acquire(capacity);
+        REQUIRE(storage.empty());
+        REQUIRE(storage.capacity() >= capacity);
+        BufferPool::Release(storage);
+        REQUIRE(storage.capacity() == 0);
+    }
+
+    REQUIRE(BufferPool::Acquire(0).capacity() == 0);
+}
+
+TEST_CASE("Released buffers are reused", "[BufferPool]")
+{
+    std::vector<uint8> storage = BufferPool::Acquire(2500);
+    storage.resize(2500, 0xAB);
+    uint8 const* data = storage.data();
+    BufferPool::Release(storage);
+
+    BufferPoolStats before = BufferPool::GetStats();
+    std::vector<uint8> reused = BufferPool::Acquire(3000);
+    BufferPoolStats after = BufferPool::GetStats();
+
+    REQUIRE(reused.data() == data);
+    REQUIRE(reused.empty());
+    REQUIRE(after.Hits == before.Hits + 1);
+    REQUIRE(after.Misses == before.Misses);
+
+    BufferPool::Release(reused);
+}
+
+TEST_CASE("Oversized buffers are not pooled", "[BufferPool]")
+{
+    std::vector<uint8> storage;
+    storage.reserve(0x400000);
+
+    BufferPoolStats before = BufferPool::GetStats();
+    BufferPool::Release(storage);
+    BufferPoolStats after = BufferPool::GetStats();
+
+    REQUIRE(storage.capacity() == 0);
+    REQUIRE(after.Discarded == before.Discarded + 1);
+    REQUIRE(after.Recycled == before.Recycled);
+}
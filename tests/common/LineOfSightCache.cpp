@@ -0,0 +1,134 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "tc_catch2.h"
+
+#include "LineOfSightCache.h"
+#include "ModelIgnoreFlags.h"
+#include <G3D/AABox.h>
+#include <G3D/Vector3.h>
+
+using G3D::Vector3;
+using VMAP::LineOfSightCache;
+using VMAP::ModelIgnoreFlags;
+
+TEST_CASE("LineOfSightCache: Store and find", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64);
+    Vector3 from(100.0f, 100.0f, 10.0f);
+    Vector3 to(120.0f, 100.0f, 10.0f);
+
+    REQUIRE_FALSE(cache.Find(from, to, ModelIgnoreFlags::Nothing));
+
+    cache.Store(from, to, ModelIgnoreFlags::Nothing, false, cache.GetGeneration());
+
+    SECTION("same endpoints hit")
+    {
+        Optional<bool> cached = cache.Find(from, to, ModelIgnoreFlags::Nothing);
+        REQUIRE(cached);
+        REQUIRE_FALSE(*cached);
+    }
+
+    SECTION("endpoints moved within one step hit")
+    {
+        Optional<bool> cached = cache.Find(from + Vector3(0.1f, 0.1f, 0.1f), to + Vector3(0.2f, 0.0f, 0.0f), ModelIgnoreFlags::Nothing);
+        REQUIRE(cached);
+        REQUIRE_FALSE(*cached);
+    }
+
+    SECTION("endpoints moved past one step miss")
+    {
+        REQUIRE_FALSE(cache.Find(from + Vector3(LineOfSightCache::QUANTIZATION_STEP, 0.0f, 0.0f), to, ModelIgnoreFlags::Nothing));
+        REQUIRE_FALSE(cache.Find(from - Vector3(0.01f, 0.0f, 0.0f), to, ModelIgnoreFlags::Nothing));
+    }
+
+    SECTION("different ignore flags or direction miss")
+    {
+        REQUIRE_FALSE(cache.Find(from, to, ModelIgnoreFlags::M2));
+        REQUIRE_FALSE(cache.Find(to, from, ModelIgnoreFlags::Nothing));
+    }
+}
+
+TEST_CASE("LineOfSightCache: Invalidate", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64);
+    Vector3 from(100.0f, 100.0f, 10.0f);
+    Vector3 to(120.0f, 100.0f, 10.0f);
+
+    uint32 generation = cache.GetGeneration();
+    cache.Store(from, to, ModelIgnoreFlags::Nothing, true, generation);
+    cache.Invalidate();
+    REQUIRE_FALSE(cache.Find(from, to, ModelIgnoreFlags::Nothing));
+
+    // results computed against the old geometry are dropped
+    cache.Store(from, to, ModelIgnoreFlags::Nothing, true, generation);
+    REQUIRE_FALSE(cache.Find(from, to, ModelIgnoreFlags::Nothing));
+}
+
+TEST_CASE("LineOfSightCache: Invalidate bounds", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64);
+    Vector3 from(100.0f, 100.0f, 10.0f);
+    Vector3 to(120.0f, 100.0f, 10.0f);
+    Vector3 farFrom(500.0f, 500.0f, 10.0f);
+    Vector3 farTo(520.0f, 500.0f, 10.0f);
+
+    cache.Store(from, to, ModelIgnoreFlags::Nothing, true, cache.GetGeneration());
+    cache.Store(farFrom, farTo, ModelIgnoreFlags::Nothing, true, cache.GetGeneration());
+
+    // a model between the endpoints of the first ray
+    cache.Invalidate(G3D::AABox(Vector3(109.0f, 95.0f, 0.0f), Vector3(111.0f, 105.0f, 20.0f)));
+
+    REQUIRE_FALSE(cache.Find(from, to, ModelIgnoreFlags::Nothing));
+    REQUIRE(cache.Find(farFrom, farTo, ModelIgnoreFlags::Nothing));
+}
+
+TEST_CASE("LineOfSightCache: Invalidate bounds covers whole cells", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64);
+    // stored from the low corner of its cells, the entry also answers rays reaching up to the next step
+    Vector3 from(100.0f, 100.0f, 10.0f);
+    Vector3 to(120.0f, 100.0f, 10.0f);
+
+    cache.Store(from, to, ModelIgnoreFlags::Nothing, true, cache.GetGeneration());
+
+    // a model only touched by rays ending near the high corner of the destination cell
+    cache.Invalidate(G3D::AABox(Vector3(120.2f, 100.2f, 10.2f), Vector3(121.0f, 101.0f, 11.0f)));
+
+    REQUIRE_FALSE(cache.Find(from, to + Vector3(0.24f, 0.24f, 0.24f), ModelIgnoreFlags::Nothing));
+}
+
+TEST_CASE("LineOfSightCache: Evicts least recently used", "[LineOfSightCache]")
+{
+    // one entry per shard
+    LineOfSightCache cache(LineOfSightCache::SHARD_COUNT);
+    Vector3 to(0.0f, 0.0f, 0.0f);
+
+    uint32 const count = LineOfSightCache::SHARD_COUNT * 16;
+    for (uint32 i = 0; i < count; ++i)
+        cache.Store(Vector3(float(i), 0.0f, 0.0f), to, ModelIgnoreFlags::Nothing, true, cache.GetGeneration());
+
+    uint32 found = 0;
+    for (uint32 i = 0; i < count; ++i)
+        if (cache.Find(Vector3(float(i), 0.0f, 0.0f), to, ModelIgnoreFlags::Nothing))
+            ++found;
+
+    REQUIRE(found <= LineOfSightCache::SHARD_COUNT);
+    // the last stored entry is always the most recent one of its shard
+    REQUIRE(cache.Find(Vector3(float(count - 1), 0.0f, 0.0f), to, ModelIgnoreFlags::Nothing));
+}
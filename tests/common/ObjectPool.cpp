@@ -0,0 +1,104 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "ObjectPool.h"
+#include <thread>
+
+using Trinity::ObjectPool;
+using Trinity::ObjectPoolStats;
+
+namespace
+{
+    struct Pooled
+    {
+        static ObjectPool Pool;
+
+        static void* operator new(std::size_t size) { return Pool.Allocate(size); }
+        static void operator delete(void* ptr, std::size_t size) { Pool.Deallocate(ptr, size); }
+
+        virtual ~Pooled() = default;
+
+        uint64 Value[3] = { };
+    };
+
+    struct LargerPooled : Pooled
+    {
+        uint64 Extra[8] = { };
+    };
+
+    ObjectPool Pooled::Pool("Pooled", sizeof(Pooled));
+}
+
+TEST_CASE("Freed objects are reused", "[ObjectPool]")
+{
+    Pooled* first = new Pooled();
+    delete first;
+
+    ObjectPoolStats before = Pooled::Pool.GetStats();
+    Pooled* second = new Pooled();
+    REQUIRE(second == first);
+    delete second;
+    ObjectPoolStats after = Pooled::Pool.GetStats();
+
+    REQUIRE(after.GetLive() == 0);
+    REQUIRE(after.Slabs == before.Slabs);
+    REQUIRE(after.ObjectSize >= sizeof(Pooled));
+}
+
+TEST_CASE("Live objects are counted", "[ObjectPool]")
+{
+    std::vector<Pooled*> objects;
+    for (int i = 0; i < 200; ++i)
+        objects.push_back(new Pooled());
+
+    REQUIRE(Pooled::Pool.GetStats().GetLive() == 200);
+
+    for (Pooled* object : objects)
+        delete object;
+
+    REQUIRE(Pooled::Pool.GetStats().GetLive() == 0);
+}
+
+TEST_CASE("Oversized objects use the global allocator", "[ObjectPool]")
+{
+    ObjectPoolStats before = Pooled::Pool.GetStats();
+    Pooled* object = new LargerPooled();
+    delete object;
+    ObjectPoolStats after = Pooled::Pool.GetStats();
+
+    REQUIRE(after.Oversized == before.Oversized + 1);
+    REQUIRE(after.Slabs == before.Slabs);
+    REQUIRE(after.GetLive() == 0);
+}
+
+TEST_CASE("Objects can be freed by another thread", "[ObjectPool]")
+{
+    std::vector<Pooled*> objects;
+    std::thread([&objects]()
+    {
+        for (int i = 0; i < 300; ++i)
+            objects.push_back(new Pooled());
+    }).join();
+
+    for (Pooled* object : objects)
+        delete object;
+
+    REQUIRE(Pooled::Pool.GetStats().GetLive() == 0);
+    REQUIRE(ObjectPool::GetAllStats().size() >= 1);
+}
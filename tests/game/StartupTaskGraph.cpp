@@ -0,0 +1,75 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "StartupTaskGraph.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+TEST_CASE("StartupTaskGraph runs tasks in insertion order without threads", "[StartupTaskGraph]")
+{
+    std::vector<int> order;
+    StartupTaskGraph graph("test");
+    graph.AddTask("first", [&]() { order.push_back(1); });
+    graph.AddTask("second", [&]() { order.push_back(2); });
+    graph.AddTask("third", [&]() { order.push_back(3); });
+    graph.Run(0);
+
+    REQUIRE(order == std::vector<int>{ 1, 2, 3 });
+    REQUIRE(graph.GetTimings().size() == 3);
+    REQUIRE(graph.GetTimings()[1].Name == "second");
+    REQUIRE(graph.GetTimings()[1].Group == "test");
+}
+
+TEST_CASE("StartupTaskGraph starts tasks after their dependencies", "[StartupTaskGraph]")
+{
+    std::mutex lock;
+    std::vector<StartupTaskGraph::TaskId> finished;
+    std::atomic<uint32> executed = 0;
+
+    StartupTaskGraph graph("test");
+    auto record = [&](StartupTaskGraph::TaskId id)
+    {
+        return [&, id]()
+        {
+            ++executed;
+            std::lock_guard<std::mutex> guard(lock);
+            finished.push_back(id);
+        };
+    };
+
+    // 0 -> 2 -> 4, 1 -> 3 -> 4, 5 independent
+    graph.AddTask("a", record(0));
+    graph.AddTask("b", record(1));
+    graph.AddTask("c", record(2), { 0 });
+    graph.AddTask("d", record(3), { 1 });
+    graph.AddTask("e", record(4), { 2, 3 });
+    graph.AddTask("f", record(5));
+    graph.Run(4);
+
+    REQUIRE(executed == 6);
+    REQUIRE(finished.size() == 6);
+
+    auto position = [&](StartupTaskGraph::TaskId id) { return std::find(finished.begin(), finished.end(), id) - finished.begin(); };
+    REQUIRE(position(0) < position(2));
+    REQUIRE(position(1) < position(3));
+    REQUIRE(position(2) < position(4));
+    REQUIRE(position(3) < position(4));
+}
@@ -17,7 +17,11 @@
 
 #include "tc_catch2.h"
 
+#include "DummyData.h"
 #include "IteratorPair.h"
+#include "ObjectGuid.h"
+#include "ThreatManager.h"
+#include <vector>
 
 class ThreatListIterator
 {
@@ -63,3 +67,146 @@ TEST_CASE("Check generator logic", "[ThreatListIterator]")
 
     REQUIRE(iterated == ints);
 }
+
+// threat list of a ThreatManager without owner, entries are added through UnitTestDataLoader
+class TestThreatList
+{
+public:
+    TestThreatList() : _mgr(nullptr) { }
+    ~TestThreatList()
+    {
+        for (ObjectGuid const& victim : _victims)
+            UnitTestDataLoader::RemoveThreatListEntry(_mgr, victim);
+    }
+
+    ThreatManager& GetManager() { return _mgr; }
+    ObjectGuid const& GetVictim(size_t index) const { return _victims[index]; }
+
+    ThreatReference* Add(float threat)
+    {
+        ObjectGuid const& victim = _victims.emplace_back(ObjectGuid::Create<HighGuid::Player>(_victims.size() + 1));
+        return UnitTestDataLoader::AddThreatListEntry(_mgr, victim, threat);
+    }
+
+    void Remove(size_t index) { UnitTestDataLoader::RemoveThreatListEntry(_mgr, _victims[index]); }
+
+    std::vector<float> GetUnsorted() const
+    {
+        std::vector<float> threat;
+        for (ThreatReference const* ref : _mgr.GetUnsortedThreatList())
+            threat.push_back(ref->GetThreat());
+        return threat;
+    }
+
+    std::vector<float> GetSorted() const
+    {
+        std::vector<float> threat;
+        for (ThreatReference const* ref : _mgr.GetSortedThreatList())
+            threat.push_back(ref->GetThreat());
+        return threat;
+    }
+
+private:
+    ThreatManager _mgr;
+    std::vector<ObjectGuid> _victims;
+};
+
+TEST_CASE("Threat list is sorted when read in order", "[ThreatManager]")
+{
+    TestThreatList list;
+    ThreatReference* lowest = list.Add(10.0f);
+    list.Add(50.0f);
+    list.Add(30.0f);
+    list.Add(20.0f);
+    list.Add(40.0f);
+
+    REQUIRE_FALSE(UnitTestDataLoader::IsThreatListSorted(list.GetManager()));
+    REQUIRE(list.GetUnsorted() == std::vector<float>{ 10.0f, 50.0f, 30.0f, 20.0f, 40.0f });
+    REQUIRE(list.GetSorted() == std::vector<float>{ 50.0f, 40.0f, 30.0f, 20.0f, 10.0f });
+    REQUIRE(UnitTestDataLoader::IsThreatListSorted(list.GetManager()));
+
+    SECTION("adding threat only flags the list")
+    {
+        lowest->AddThreat(100.0f);
+        REQUIRE_FALSE(UnitTestDataLoader::IsThreatListSorted(list.GetManager()));
+        REQUIRE(list.GetUnsorted() == std::vector<float>{ 110.0f, 50.0f, 30.0f, 20.0f, 40.0f });
+        REQUIRE(list.GetSorted() == std::vector<float>{ 110.0f, 50.0f, 40.0f, 30.0f, 20.0f });
+    }
+
+    SECTION("unchanged threat keeps the list sorted")
+    {
+        lowest->ScaleThreat(1.0f);
+        lowest->AddThreat(0.0f);
+        REQUIRE(UnitTestDataLoader::IsThreatListSorted(list.GetManager()));
+    }
+}
+
+TEST_CASE("Removing a threat list entry", "[ThreatManager]")
+{
+    TestThreatList list;
+    list.Add(10.0f);
+    list.Add(50.0f);
+    list.Add(30.0f);
+    list.Add(20.0f);
+    REQUIRE(list.GetSorted() == std::vector<float>{ 50.0f, 30.0f, 20.0f, 10.0f });
+
+    list.Remove(1);
+
+    // the last entry fills the gap in the unsorted list, the sorted one stays in order
+    REQUIRE(list.GetManager().GetThreatListSize() == 3);
+    REQUIRE(list.GetUnsorted() == std::vector<float>{ 10.0f, 20.0f, 30.0f });
+    REQUIRE(UnitTestDataLoader::IsThreatListSorted(list.GetManager()));
+    REQUIRE(list.GetSorted() == std::vector<float>{ 30.0f, 20.0f, 10.0f });
+
+    list.Remove(0);
+    list.Remove(2);
+    list.Remove(3);
+    REQUIRE(list.GetManager().IsThreatListEmpty(true));
+    REQUIRE(list.GetManager().GetUnsortedThreatList().begin() == nullptr);
+    REQUIRE(list.GetManager().GetSortedThreatList().begin() == nullptr);
+}
+
+TEST_CASE("Threat list lookup by victim", "[ThreatManager]")
+{
+    TestThreatList list;
+    for (int i = 0; i < 8; ++i)
+        list.Add(float(i));
+
+    for (size_t i = 0; i < 8; ++i)
+        REQUIRE(list.GetManager().IsThreatenedBy(list.GetVictim(i)));
+    REQUIRE_FALSE(list.GetManager().IsThreatenedBy(ObjectGuid::Create<HighGuid::Player>(100)));
+
+    list.Remove(3);
+    REQUIRE_FALSE(list.GetManager().IsThreatenedBy(list.GetVictim(3)));
+    REQUIRE(list.GetManager().IsThreatenedBy(list.GetVictim(7)));
+}
+
+TEST_CASE("Raid sized threat list", "[ThreatManager][.benchmark]")
+{
+    TestThreatList list;
+    for (int i = 0; i < 40; ++i)
+        list.Add(float(i));
+    ThreatReference* lowest = list.GetManager().GetModifiableThreatList().back();
+
+    BENCHMARK("Unsorted iteration")
+    {
+        float sum = 0.0f;
+        for (ThreatReference const* ref : list.GetManager().GetUnsortedThreatList())
+            sum += ref->GetThreat();
+        return sum;
+    };
+
+    // one entry changed since the last read, as after a single AddThreat call
+    BENCHMARK("Sorted read after one change")
+    {
+        lowest->AddThreat(100.0f);
+        float highest = (*list.GetManager().GetSortedThreatList().begin())->GetThreat();
+        lowest->AddThreat(-100.0f);
+        return highest + (*list.GetManager().GetSortedThreatList().begin())->GetThreat();
+    };
+
+    BENCHMARK("Lookup by victim")
+    {
+        return list.GetManager().IsThreatenedBy(list.GetVictim(39));
+    };
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "UpdateFieldFlags.h"
+#include "UpdateMask.h"
+#include <vector>
+
+TEST_CASE("UpdateMask: Set, unset and clear bits", "[UpdateMask]")
+{
+    UpdateMask mask;
+    mask.SetCount(PLAYER_END);
+    REQUIRE(mask.GetBlockCount() == (PLAYER_END + 31) / 32);
+
+    mask.SetBit(0);
+    mask.SetBit(31);
+    mask.SetBit(32);
+    mask.SetBit(PLAYER_END - 1);
+
+    REQUIRE(mask.GetBit(0));
+    REQUIRE(mask.GetBit(31));
+    REQUIRE(mask.GetBit(32));
+    REQUIRE(mask.GetBit(PLAYER_END - 1));
+    REQUIRE_FALSE(mask.GetBit(1));
+    REQUIRE(mask.GetBlock(0) == 0x80000001u);
+    REQUIRE(mask.GetBlock(1) == 0x00000001u);
+
+    mask.UnsetBit(31);
+    REQUIRE_FALSE(mask.GetBit(31));
+    REQUIRE(mask.GetBlock(0) == 0x00000001u);
+
+    mask.Clear();
+    for (uint32 block = 0; block < mask.GetBlockCount(); ++block)
+        REQUIRE(mask.GetBlock(block) == 0);
+}
+
+TEST_CASE("UpdateMaskPacketBuilder: Visits set bits in order", "[UpdateMask]")
+{
+    UpdateMaskPacketBuilder builder(UNIT_END);
+    builder.SetBlock(2, 0x00000101u);
+    builder.SetBit(5);
+    builder.SetBit(UNIT_END - 1);
+
+    std::vector<uint16> visited;
+    builder.ForEachSetBit([&](uint16 index) { visited.push_back(index); });
+    REQUIRE(visited == std::vector<uint16>{ 5, 64, 72, UNIT_END - 1 });
+
+    ByteBuffer packet;
+    builder.AppendToPacket(&packet);
+    REQUIRE(packet.read<uint8>() == (UNIT_END - 1) / 32 + 1);
+    REQUIRE(packet.read<uint32>() == 0x00000020u);
+}
+
+TEST_CASE("UpdateFieldFlagMasks: Match field flags", "[UpdateMask]")
+{
+    UpdateFieldFlagMasks const& masks = GetUpdateFieldFlagMasks(UnitUpdateFieldFlags);
+    for (uint32 visibleFlag : { uint32(UF_FLAG_PUBLIC), uint32(UF_FLAG_PUBLIC | UF_FLAG_PRIVATE), uint32(UF_FLAG_PUBLIC | UF_FLAG_OWNER | UF_FLAG_PARTY_MEMBER), uint32(UF_FLAG_DYNAMIC) })
+        for (uint32 index = 0; index < PLAYER_END; ++index)
+            REQUIRE(((masks.GetBlock(visibleFlag, index / 32) & UpdateMask::GetBlockFlag(index)) != 0) == ((UnitUpdateFieldFlags[index] & visibleFlag) != 0));
+}
+
+TEST_CASE("UpdateMask: Build values update mask", "[UpdateMask][.benchmark]")
+{
+    UpdateMask changes;
+    changes.SetCount(PLAYER_END);
+    changes.SetBit(UNIT_FIELD_HEALTH);
+    changes.SetBit(UNIT_FIELD_POWER1);
+    changes.SetBit(PLAYER_XP);
+
+    uint32 const visibleFlag = UF_FLAG_PUBLIC | UF_FLAG_PARTY_MEMBER;
+    uint32 const notifyFlags = UF_FLAG_DYNAMIC;
+
+    BENCHMARK("Per field")
+    {
+        UpdateMaskPacketBuilder builder(PLAYER_END);
+        for (uint16 index = 0; index < PLAYER_END; ++index)
+            if (notifyFlags & UnitUpdateFieldFlags[index] || (changes.GetBit(index) && (UnitUpdateFieldFlags[index] & visibleFlag)))
+                builder.SetBit(index);
+        return builder;
+    };
+
+    BENCHMARK("Per block")
+    {
+        UpdateFieldFlagMasks const& masks = GetUpdateFieldFlagMasks(UnitUpdateFieldFlags);
+        UpdateMaskPacketBuilder builder(PLAYER_END);
+        for (uint32 block = 0; block < builder.GetBlockCount(); ++block)
+            builder.SetBlock(block, masks.GetBlock(notifyFlags, block) | (changes.GetBlock(block) & masks.GetBlock(visibleFlag, block)));
+        return builder;
+    };
+}
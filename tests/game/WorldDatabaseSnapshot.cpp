@@ -0,0 +1,129 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "WorldDatabaseSnapshot.h"
+#include <boost/filesystem.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using Row = std::tuple<uint32, int8, float, std::string, bool>;
+
+    std::string GetTempSnapshotFileName()
+    {
+        return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("deleteme-%%%%-%%%%.snapshot")).string();
+    }
+}
+
+TEST_CASE("WorldDatabaseSnapshot rows survive a round trip through a file", "[WorldDatabaseSnapshot]")
+{
+    std::vector<Row> rows =
+    {
+        { 1, -1, 0.5f, "npc_script", true },
+        { 2, 0, -2.25f, "", false },
+        { 4000000000u, 127, 100.0f, std::string(300, 'x'), true }
+    };
+
+    WorldDatabaseSnapshot::Writer writer;
+    WorldDatabaseSnapshot::WriteRows(writer, rows);
+
+    std::string fileName = GetTempSnapshotFileName();
+    REQUIRE(WorldDatabaseSnapshot::SaveFile(fileName, 42, writer));
+
+    SECTION("same version")
+    {
+        std::unique_ptr<WorldDatabaseSnapshot::Reader> reader = WorldDatabaseSnapshot::OpenFile(fileName, 42);
+        REQUIRE(reader);
+
+        std::vector<Row> loaded;
+        REQUIRE(WorldDatabaseSnapshot::ReadRows(*reader, loaded));
+        REQUIRE(loaded == rows);
+    }
+
+    SECTION("other version")
+    {
+        REQUIRE(!WorldDatabaseSnapshot::OpenFile(fileName, 43));
+    }
+
+    SECTION("other columns")
+    {
+        std::unique_ptr<WorldDatabaseSnapshot::Reader> reader = WorldDatabaseSnapshot::OpenFile(fileName, 42);
+        REQUIRE(reader);
+
+        std::vector<std::tuple<uint32, int8, float, std::string>> loaded;
+        REQUIRE(!WorldDatabaseSnapshot::ReadRows(*reader, loaded));
+    }
+
+    SECTION("truncated file")
+    {
+        boost::filesystem::resize_file(fileName, boost::filesystem::file_size(fileName) - 1);
+        REQUIRE(!WorldDatabaseSnapshot::OpenFile(fileName, 42));
+    }
+
+    boost::filesystem::remove(fileName);
+}
+
+TEST_CASE("WorldDatabaseSnapshot reader rejects reads past the payload", "[WorldDatabaseSnapshot]")
+{
+    WorldDatabaseSnapshot::Writer writer;
+    writer.Write(uint32(7));
+    writer.Write(uint32(1000)); // string length longer than the rest of the payload
+
+    std::string fileName = GetTempSnapshotFileName();
+    REQUIRE(WorldDatabaseSnapshot::SaveFile(fileName, 1, writer));
+
+    std::unique_ptr<WorldDatabaseSnapshot::Reader> reader = WorldDatabaseSnapshot::OpenFile(fileName, 1);
+    REQUIRE(reader);
+
+    uint32 value = 0;
+    REQUIRE(reader->Read(value));
+    REQUIRE(value == 7);
+
+    std::string text;
+    REQUIRE(!reader->Read(text));
+
+    uint64 wide = 0;
+    REQUIRE(!reader->Read(wide));
+    REQUIRE(reader->IsAtEnd());
+
+    reader.reset();
+    boost::filesystem::remove(fileName);
+}
+
+TEST_CASE("WorldDatabaseSnapshot rows with a corrupt count are rejected", "[WorldDatabaseSnapshot]")
+{
+    WorldDatabaseSnapshot::Writer writer;
+    writer.Write(uint64(1000000)); // far more rows than the payload holds
+    writer.Write(uint32(1));
+    writer.Write(float(2.0f));
+
+    std::string fileName = GetTempSnapshotFileName();
+    REQUIRE(WorldDatabaseSnapshot::SaveFile(fileName, 1, writer));
+
+    std::unique_ptr<WorldDatabaseSnapshot::Reader> reader = WorldDatabaseSnapshot::OpenFile(fileName, 1);
+    REQUIRE(reader);
+
+    std::vector<std::tuple<uint32, float>> loaded;
+    REQUIRE(!WorldDatabaseSnapshot::ReadRows(*reader, loaded));
+
+    reader.reset();
+    boost::filesystem::remove(fileName);
+}